@@ -0,0 +1,67 @@
+// Rebalancing a large universe: executeOrder per name vs one executeOrders batch.
+// Usage: ./bench_batch [numSymbols] [rounds]
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "backtest-cpp/portfolio.h"
+
+namespace {
+
+std::vector<Order> makeRebalance(const std::vector<std::string>& symbols, int round) {
+    std::vector<Order> orders;
+    orders.reserve(symbols.size());
+    for (size_t i = 0; i < symbols.size(); ++i) {
+        int quantity = 1 + static_cast<int>((i + round) % 3);
+        orders.push_back(Order{.time = round,
+                               .symbol = symbols[i],
+                               .direction = SignalType::BUY,
+                               .price = 50.0 + static_cast<double>(i % 100),
+                               .type = OrderType::MARKET,
+                               .quantity = quantity});
+    }
+    return orders;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    size_t numSymbols = argc > 1 ? std::stoul(argv[1]) : 2'000;
+    int rounds = argc > 2 ? std::stoi(argv[2]) : 200;
+
+    std::vector<std::string> symbols;
+    for (size_t i = 0; i < numSymbols; ++i) symbols.push_back("SYM" + std::to_string(i));
+
+    std::vector<std::vector<Order>> batches;
+    for (int r = 0; r < rounds; ++r) batches.push_back(makeRebalance(symbols, r));
+
+    PortfolioConfig config{.initialCash = 1e12, .commission = 1.0};
+    Portfolio sequential(config);
+    Portfolio batched(config);
+    std::vector<ExecutionResult> results(numSymbols);
+
+    auto start = std::chrono::steady_clock::now();
+    for (const auto& batch : batches) {
+        for (const Order& order : batch) sequential.executeOrder(order, false);
+    }
+    auto mid = std::chrono::steady_clock::now();
+    for (const auto& batch : batches) {
+        batched.executeOrders(batch, results);
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    double sequentialSec = std::chrono::duration<double>(mid - start).count();
+    double batchedSec = std::chrono::duration<double>(end - mid).count();
+    double orders = static_cast<double>(numSymbols) * rounds;
+
+    std::cout << "Symbols          : " << numSymbols << " x " << rounds << " rebalances"
+              << std::endl;
+    std::cout << "executeOrder     : " << orders / sequentialSec << " orders/s" << std::endl;
+    std::cout << "executeOrders    : " << orders / batchedSec << " orders/s" << std::endl;
+    std::cout << "Cash difference  : " << batched.getAvailableCash() - sequential.getAvailableCash()
+              << std::endl;
+
+    return 0;
+}
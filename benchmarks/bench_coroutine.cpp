@@ -0,0 +1,128 @@
+// SMACrossover as a callback strategy vs the same logic as a CoroutineStrategy awaiting each
+// bar, and a child coroutine started every bar with its frame from the strategy's FramePool
+// vs from ::operator new.
+// Usage: ./bench_coroutine [numBars]
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../strategies/coroutine_smacrossover.h"
+#include "../strategies/smacrossover.h"
+#include "backtest-cpp/coroutine_strategy.h"
+
+namespace {
+
+std::vector<std::map<std::string, Bar>> makeBars(size_t numBars) {
+    std::mt19937_64 rng(7);
+    std::normal_distribution<double> step(0.0, 2.0);
+    double price = 10'000.0;
+
+    std::vector<std::map<std::string, Bar>> bars;
+    bars.reserve(numBars);
+    for (size_t i = 0; i < numBars; ++i) {
+        double open = price;
+        price = std::max(1.0, price + step(rng));
+        Bar bar{.symbol = "NQ",
+                .time = static_cast<int64_t>(i),
+                .open = open,
+                .high = std::max(open, price),
+                .low = std::min(open, price),
+                .close = price,
+                .volume = 500};
+        bars.push_back({{"NQ", bar}});
+    }
+    return bars;
+}
+
+// Awaits a child coroutine every bar, from the pool or from the heap
+class ChildPerBar final : public CoroutineStrategy {
+   public:
+    explicit ChildPerBar(bool pooled) : pooled_(pooled) {}
+    long steps = 0;
+
+   protected:
+    Task run() override {
+        for (;;) {
+            co_await nextBar();
+            if (pooled_) {
+                co_await pooledStep();
+            } else {
+                co_await heapStep(steps);
+            }
+        }
+    }
+
+   private:
+    Task pooledStep() {
+        ++steps;
+        co_return;
+    }
+    static Task heapStep(long& steps) {  // Not a member call, so no pool
+        ++steps;
+        co_return;
+    }
+
+    bool pooled_;
+};
+
+// Seconds to feed every bar after the warm-up to `strategy`, counting signals
+double timeLoop(const std::vector<std::map<std::string, Bar>>& bars, Strategy& strategy,
+                size_t& signalCount) {
+    std::vector<std::map<std::string, Bar>> history(bars.begin(), bars.begin() + 30);
+    strategy.onInit(history);
+
+    std::map<std::string, Position> positions;
+    SignalBuffer signals;
+    signalCount = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 30; i < bars.size(); ++i) {
+        signals.clear();
+        strategy.onBars(bars[i], positions, signals);
+        signalCount += signals.count();
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(end - start).count();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    size_t numBars = argc > 1 ? std::stoul(argv[1]) : 1'000'000;
+    std::vector<std::map<std::string, Bar>> bars = makeBars(numBars);
+    double n = static_cast<double>(numBars - 30);
+
+    SMACrossover callback(10, 30);
+    size_t callbackSignals = 0;
+    double callbackSec = timeLoop(bars, callback, callbackSignals);
+
+    CoroutineSMACrossover coroutine(10, 30);
+    size_t coroutineSignals = 0;
+    double coroutineSec = timeLoop(bars, coroutine, coroutineSignals);
+
+    ChildPerBar pooled(true);
+    ChildPerBar heap(false);
+    size_t unused = 0;
+    double pooledSec = timeLoop(bars, pooled, unused);
+    double heapSec = timeLoop(bars, heap, unused);
+
+    std::cout << "Bars                 : " << numBars << " (" << callbackSignals << " signals)"
+              << std::endl;
+    std::cout << "Callback SMACrossover: " << n / callbackSec << " bars/s" << std::endl;
+    std::cout << "Coroutine crossover  : " << n / coroutineSec << " bars/s ("
+              << (coroutineSec - callbackSec) / n * 1e9 << " ns/bar more)" << std::endl;
+    std::cout << "Child frame, pooled  : " << n / pooledSec << " bars/s, "
+              << pooled.framePool().chunks() << " chunk(s)" << std::endl;
+    std::cout << "Child frame, heap    : " << n / heapSec << " bars/s" << std::endl;
+
+    if (callbackSignals != coroutineSignals || pooled.steps != heap.steps) {
+        std::cerr << "Callback and coroutine strategies disagree" << std::endl;
+        return 1;
+    }
+    return 0;
+}
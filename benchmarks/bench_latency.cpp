@@ -0,0 +1,101 @@
+// Throughput of the main loop with and without simulated order latency.
+// Usage: ./bench_latency [numBars]
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../strategies/smacrossover.h"
+#include "backtest-cpp/portfolio.h"
+
+namespace {
+
+constexpr int64_t kMinute = 60'000'000'000;
+
+// Random-walk bars, generated up front so the timed loops only run the backtest
+std::vector<Bar> makeSeries(size_t numBars) {
+    std::mt19937_64 rng(7);
+    std::normal_distribution<double> step(0.0, 2.0);
+    double price = 10'000.0;
+
+    std::vector<Bar> series;
+    series.reserve(numBars);
+    for (size_t i = 0; i < numBars; ++i) {
+        double open = price;
+        price = std::max(1.0, price + step(rng));
+        series.push_back(Bar{.symbol = "NQ",
+                             .time = static_cast<int64_t>(i) * kMinute,
+                             .open = open,
+                             .high = std::max(open, price),
+                             .low = std::min(open, price),
+                             .close = price,
+                             .volume = 500});
+    }
+    return series;
+}
+
+double runLoop(const std::vector<Bar>& series, const LatencyConfig& latency) {
+    Portfolio portfolio({.initialCash = 100'000'000.0,
+                         .commission = 2.7,
+                         .latency = latency,
+                         .logTrades = false});
+    SMACrossover strategy(10, 30);
+
+    std::vector<std::map<std::string, Bar>> history;
+    for (size_t i = 0; i < 30; ++i) history.push_back({{"NQ", series[i]}});
+    strategy.onInit(history);
+
+    // One map whose bar is overwritten in place, so the loop does not allocate for it
+    std::map<std::string, Bar> bars = history.back();
+    Bar& bar = bars.at("NQ");
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 30; i < series.size(); ++i) {
+        bar = series[i];
+        portfolio.processPendingOrders(bars);
+
+        auto signals = strategy.onBars(bars, portfolio.getCurrentPositions());
+        for (const auto& [symbol, signal] : signals) {
+            if (!signal.has_value()) continue;
+            Order order = strategy.generateOrder(signal.value(), bars[symbol], 10'000,
+                                                 portfolio.getCurrentPositions());
+            portfolio.submitOrder(order);
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    return std::chrono::duration<double>(end - start).count();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    size_t numBars = argc > 1 ? std::stoul(argv[1]) : 1'000'000;
+
+    // Silence the remaining order messages so they do not dominate the measurement
+    std::streambuf* coutBuf = std::cout.rdbuf(nullptr);
+    std::streambuf* cerrBuf = std::cerr.rdbuf(nullptr);
+    std::vector<Bar> series = makeSeries(numBars);
+    LatencyConfig uniform{
+        .type = LatencyType::UNIFORM, .delayNs = kMinute / 2, .jitterNs = kMinute};
+    double baseline = runLoop(series, {});
+    double delayed = runLoop(series, uniform);
+    for (int repeat = 1; repeat < 3; ++repeat) {  // Best of three against noise
+        baseline = std::min(baseline, runLoop(series, {}));
+        delayed = std::min(delayed, runLoop(series, uniform));
+    }
+    std::cout.rdbuf(coutBuf);
+    std::cerr.rdbuf(cerrBuf);
+
+    std::cout << "Bars             : " << numBars << std::endl;
+    std::cout << "No latency       : " << numBars / baseline << " bars/s" << std::endl;
+    std::cout << "Uniform latency  : " << numBars / delayed << " bars/s" << std::endl;
+    std::cout << "Throughput cost  : " << (delayed / baseline - 1.0) * 100 << " %" << std::endl;
+
+    return 0;
+}
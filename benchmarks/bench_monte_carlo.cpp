@@ -0,0 +1,62 @@
+// Monte Carlo throughput for 1, 2, 4, ... threads up to the hardware thread count: trade
+// bootstrap and block bootstrap samples per second, with the intervals they produce.
+// Usage: ./bench_monte_carlo [samples] [numTrades] [curveLength]
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "backtest-cpp/monte_carlo.h"
+
+int main(int argc, char** argv) {
+    size_t samples = argc > 1 ? std::stoul(argv[1]) : 50'000;
+    size_t numTrades = argc > 2 ? std::stoul(argv[2]) : 500;
+    size_t curveLength = argc > 3 ? std::stoul(argv[3]) : 20'000;
+
+    std::mt19937_64 rng(7);
+    std::normal_distribution<double> tradePnl(5.0, 60.0);
+    std::vector<Trade> trades;
+    for (size_t i = 0; i < numTrades; ++i) {
+        trades.push_back(
+            Trade{.order = {}, .quantity = 2, .pnl = tradePnl(rng), .commission = 2.7});
+    }
+
+    std::normal_distribution<double> step(0.000001, 0.0005);
+    std::vector<EquityPoint> curve;
+    double equity = 100'000.0;
+    for (size_t i = 0; i < curveLength; ++i) {
+        equity *= std::exp(step(rng));
+        curve.push_back({static_cast<int64_t>(i) * 60, equity});
+    }
+
+    std::cout << "Samples: " << samples << ", trades: " << numTrades
+              << ", curve: " << curveLength << std::endl;
+    size_t hardware = std::max(1u, std::thread::hardware_concurrency());
+    for (size_t threads = 1; threads <= hardware; threads *= 2) {
+        MonteCarlo monteCarlo({.samples = samples, .threads = threads});
+
+        auto start = std::chrono::steady_clock::now();
+        MonteCarloResult byTrades = monteCarlo.bootstrapTrades(trades, 100'000.0, curveLength);
+        auto middle = std::chrono::steady_clock::now();
+        MonteCarloResult byBlocks = monteCarlo.blockBootstrap(curve);
+        auto end = std::chrono::steady_clock::now();
+
+        double tradeSeconds = std::chrono::duration<double>(middle - start).count();
+        double blockSeconds = std::chrono::duration<double>(end - middle).count();
+        std::cout << "Threads " << threads << ": trade bootstrap " << samples / tradeSeconds
+                  << " samples/s, block bootstrap " << samples / blockSeconds << " samples/s"
+                  << std::endl;
+        if (threads == 1) {
+            std::cout << "  Sharpe 95% [" << byBlocks.sharpe.lower << ", "
+                      << byBlocks.sharpe.upper << "], max drawdown 95% ["
+                      << byTrades.maxDrawdown.lower << ", " << byTrades.maxDrawdown.upper
+                      << "]" << std::endl;
+        }
+    }
+    return 0;
+}
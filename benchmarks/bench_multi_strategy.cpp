@@ -0,0 +1,76 @@
+// A book of SMACrossover strategies on one CSV: one standalone backtest per strategy, each
+// loading the file again, vs a MultiStrategyEngine loading it once.
+// Usage: ./bench_multi_strategy [numBars] [numStrategies]
+
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../strategies/smacrossover.h"
+#include "backtest-cpp/data.h"
+#include "backtest-cpp/engine.h"
+#include "backtest-cpp/multi_engine.h"
+#include "bench_util.h"
+
+namespace {
+
+template <typename F>
+double secondsFor(F&& f) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    size_t numBars = argc > 1 ? std::stoul(argv[1]) : 20'000;
+    size_t numStrategies = argc > 2 ? std::stoul(argv[2]) : 50;
+    const std::string path = "bench_multi_strategy.csv";
+    bench::writeCsv(path, numBars);
+
+    EngineConfig config{.warmupBars = 80, .maxInvest = 10'000, .logOrders = false};
+    PortfolioConfig portfolio{.initialCash = 100'000.0, .commission = 2.7, .logTrades = false};
+    auto makeStrategy = [](size_t i) {
+        int shortPeriod = 2 + static_cast<int>(i % 10) * 2;
+        int longPeriod = shortPeriod + 10 + static_cast<int>(i % 40);
+        return std::make_unique<SMACrossover>(shortPeriod, longPeriod);
+    };
+
+    double loadOnce = 0.0;
+    double separate = secondsFor([&] {
+        for (size_t i = 0; i < numStrategies; ++i) {
+            DataHandler data;
+            loadOnce += secondsFor([&] { data.loadCSV(path, "NQ"); });
+            std::unique_ptr<SMACrossover> strategy = makeStrategy(i);
+            Portfolio book(portfolio);
+            BacktestEngine(data, *strategy, book, config).run();
+        }
+    });
+    loadOnce /= static_cast<double>(numStrategies);
+
+    std::vector<std::unique_ptr<SMACrossover>> strategies;
+    double multi = secondsFor([&] {
+        DataHandler data;
+        data.loadCSV(path, "NQ");
+        MultiStrategyEngine engine(data, config);
+        for (size_t i = 0; i < numStrategies; ++i) {
+            strategies.push_back(makeStrategy(i));
+            engine.addStrategy(*strategies.back(),
+                               {.name = std::to_string(i), .portfolio = portfolio});
+        }
+        engine.run();
+    });
+    std::remove(path.c_str());
+
+    double barsPerMs = static_cast<double>(numBars * numStrategies) / (multi * 1e3);
+    std::cout << "Bars: " << numBars << ", strategies: " << numStrategies << std::endl;
+    std::cout << "Separate runs : " << separate << " s (load " << loadOnce << " s each)"
+              << std::endl;
+    std::cout << "Multi-strategy: " << multi << " s, " << barsPerMs << " strategy-bars/ms, "
+              << separate / multi << "x faster" << std::endl;
+    return 0;
+}
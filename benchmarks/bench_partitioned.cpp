@@ -0,0 +1,80 @@
+// SMACrossover over a universe of independent symbols: one BacktestEngine over the whole
+// universe vs a PartitionedEngine over the same symbols split into sub-accounts, by thread
+// count.
+// Usage: ./bench_partitioned [numBars] [numSymbols] [maxThreads] [partitions (0 = per symbol)]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../strategies/smacrossover.h"
+#include "backtest-cpp/data.h"
+#include "backtest-cpp/engine.h"
+#include "backtest-cpp/partitioned_engine.h"
+#include "bench_util.h"
+
+namespace {
+
+template <typename F>
+double secondsFor(F&& f) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    size_t numBars = argc > 1 ? std::stoul(argv[1]) : 5'000;
+    size_t numSymbols = argc > 2 ? std::stoul(argv[2]) : 200;
+    size_t maxThreads = argc > 3 ? std::stoul(argv[3])
+                                 : std::max(1u, std::thread::hardware_concurrency());
+    size_t partitions = argc > 4 ? std::stoul(argv[4]) : 64;
+
+    DataHandler data;
+    for (size_t s = 0; s < numSymbols; ++s) {
+        const std::string path = "bench_partitioned_" + std::to_string(s) + ".csv";
+        bench::writeCsv(path, numBars, 7 + s);
+        data.loadCSV(path, "S" + std::to_string(s));
+        std::remove(path.c_str());
+    }
+    data.synchronize();
+
+    PartitionConfig config{
+        .portfolio = {.initialCash = 10'000.0 * numSymbols, .commission = 2.7},
+        .engine = {.warmupBars = 80, .maxInvest = 10'000},
+        .partitions = partitions};
+
+    SMACrossover strategy(10, 30);
+    Portfolio portfolio({.initialCash = config.portfolio.initialCash,
+                         .commission = 2.7,
+                         .logTrades = false});
+    BacktestEngine whole(data, strategy, portfolio,
+                         {.warmupBars = 80, .maxInvest = 10'000, .logOrders = false});
+    double wholeSeconds = secondsFor([&] { whole.run(); });
+
+    std::cout << "Bars: " << numBars << ", symbols: " << numSymbols
+              << ", partitions: " << partitions << std::endl;
+    std::cout << "Single account, 1 thread : " << wholeSeconds << " s" << std::endl;
+    std::printf("%8s %10s %9s %11s %10s\n", "Threads", "Seconds", "Speedup", "Efficiency",
+                "Busy");
+
+    double baseline = 0.0;
+    for (size_t threads = 1; threads <= maxThreads; threads *= 2) {
+        config.threads = threads;
+        PartitionedEngine engine(data, [] { return std::make_unique<SMACrossover>(10, 30); },
+                                 config);
+        const PartitionStats& stats = engine.run();
+        if (threads == 1) baseline = stats.elapsedSeconds;
+
+        double speedup = baseline / stats.elapsedSeconds;
+        std::printf("%8zu %10.4f %8.2fx %10.1f%% %9.1f%%\n", threads, stats.elapsedSeconds,
+                    speedup, speedup / threads * 100, stats.efficiency() * 100);
+    }
+    return 0;
+}
@@ -0,0 +1,83 @@
+// SMACrossover over a universe of symbols: BacktestEngine on one thread vs PipelinedEngine
+// with data, strategy and accounting stages on three. The equity curves must match.
+// Usage: ./bench_pipeline [numBars] [numSymbols] [queueCapacity]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../strategies/smacrossover.h"
+#include "backtest-cpp/data.h"
+#include "backtest-cpp/engine.h"
+#include "backtest-cpp/pipeline.h"
+#include "bench_util.h"
+
+namespace {
+
+template <typename F>
+double secondsFor(F&& f) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    size_t numBars = argc > 1 ? std::stoul(argv[1]) : 20'000;
+    size_t numSymbols = argc > 2 ? std::stoul(argv[2]) : 50;
+    size_t capacity = argc > 3 ? std::stoul(argv[3]) : 1024;
+
+    DataHandler data;
+    for (size_t s = 0; s < numSymbols; ++s) {
+        const std::string path = "bench_pipeline_" + std::to_string(s) + ".csv";
+        bench::writeCsv(path, numBars, 7 + s);
+        data.loadCSV(path, "S" + std::to_string(s));
+        std::remove(path.c_str());
+    }
+    data.synchronize();
+
+    EngineConfig config{.warmupBars = 80, .maxInvest = 10'000, .logOrders = false};
+    PortfolioConfig book{.initialCash = 1'000'000.0, .commission = 2.7, .logTrades = false};
+
+    SMACrossover sequentialStrategy(10, 30);
+    Portfolio sequentialPortfolio(book);
+    BacktestEngine sequential(data, sequentialStrategy, sequentialPortfolio, config);
+    double sequentialSeconds = secondsFor([&] { sequential.run(); });
+
+    SMACrossover pipelinedStrategy(10, 30);
+    Portfolio pipelinedPortfolio(book);
+    PipelinedEngine pipelined(data, pipelinedStrategy, pipelinedPortfolio, config,
+                              {.queueCapacity = capacity});
+    PipelineStats stats;
+    double pipelinedSeconds = secondsFor([&] { stats = pipelined.run(); });
+
+    bool same = pipelined.getEquityCurve().size() == sequential.getEquityCurve().size() &&
+                std::equal(pipelined.getEquityCurve().begin(), pipelined.getEquityCurve().end(),
+                           sequential.getEquityCurve().begin(), [](const auto& a, const auto& b) {
+                               return a.time == b.time && a.equity == b.equity;
+                           });
+
+    std::cout << "Bars: " << numBars << ", symbols: " << numSymbols
+              << ", queue capacity: " << capacity << std::endl;
+    std::cout << "Sequential : " << sequentialSeconds << " s" << std::endl;
+    std::cout << "Pipelined  : " << pipelinedSeconds << " s, "
+              << sequentialSeconds / pipelinedSeconds << "x, equity curve "
+              << (same ? "identical" : "DIFFERENT") << std::endl;
+
+    const char* stageNames[] = {"data", "strategy", "accounting"};
+    for (size_t i = 0; i < stats.stages.size(); ++i) {
+        std::printf("  %-10s : %5.1f %% busy, %.3f s waiting\n", stageNames[i],
+                    stats.stages[i].utilization * 100, stats.stages[i].waitSeconds);
+    }
+    const char* queueNames[] = {"data -> strategy", "strategy -> accounting"};
+    for (size_t i = 0; i < stats.queues.size(); ++i) {
+        std::printf("  %-22s : mean depth %.1f, max %zu of %zu\n", queueNames[i],
+                    stats.queues[i].meanDepth, stats.queues[i].maxDepth,
+                    stats.queues[i].capacity);
+    }
+    return same ? 0 : 1;
+}
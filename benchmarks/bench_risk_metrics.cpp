@@ -0,0 +1,99 @@
+// Scoring a sweep's equity curves: Performance's per-metric functions (return, volatility,
+// Sharpe, max drawdown, each its own pass) vs Performance::riskMetrics, which computes those
+// and seven more in one pass, vs a PerformanceAccumulator fed one point at a time, and vs
+// batchRiskMetrics over all curves as one point-major matrix, by thread count.
+// Usage: ./bench_risk_metrics [numCurves] [curveLength] [maxThreads]
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "backtest-cpp/batch_metrics.h"
+#include "backtest-cpp/performance.h"
+
+namespace {
+
+template <typename F>
+double secondsFor(F&& f) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    size_t numCurves = argc > 1 ? std::stoul(argv[1]) : 1'000;
+    size_t length = argc > 2 ? std::stoul(argv[2]) : 10'000;
+    size_t maxThreads = argc > 3 ? std::stoul(argv[3])
+                                 : std::max(1u, std::thread::hardware_concurrency());
+
+    std::mt19937_64 rng(7);
+    std::normal_distribution<double> step(0.0, 0.001);
+    std::vector<std::vector<EquityPoint>> curves(numCurves);
+    for (std::vector<EquityPoint>& curve : curves) {
+        double equity = 100'000.0;
+        curve.reserve(length);
+        for (size_t i = 0; i < length; ++i) {
+            equity *= std::exp(step(rng));
+            curve.push_back({static_cast<int64_t>(i) * 60, equity});
+        }
+    }
+
+    double checksum = 0.0;
+    double perMetric = secondsFor([&] {
+        for (const std::vector<EquityPoint>& curve : curves) {
+            checksum += Performance::annualizedReturn(curve, Frequency::MINUTE);
+            checksum += Performance::annualizedVolatility(curve, Frequency::MINUTE);
+            checksum += Performance::sharpeRatio(curve, Frequency::MINUTE);
+            checksum += Performance::maxDrawdown(curve);
+        }
+    });
+    double fused = secondsFor([&] {
+        for (const std::vector<EquityPoint>& curve : curves) {
+            RiskMetrics metrics = Performance::riskMetrics(curve, Frequency::MINUTE);
+            checksum += metrics.annualizedReturn + metrics.annualizedVolatility +
+                        metrics.sharpe + metrics.maxDrawdown + metrics.sortino;
+        }
+    });
+    double streaming = secondsFor([&] {
+        for (const std::vector<EquityPoint>& curve : curves) {
+            PerformanceAccumulator acc;
+            for (const EquityPoint& point : curve) acc.add(point);
+            RiskMetrics metrics = acc.riskMetrics(Frequency::MINUTE);
+            checksum += metrics.annualizedReturn + metrics.annualizedVolatility +
+                        metrics.sharpe + metrics.maxDrawdown + metrics.sortino;
+        }
+    });
+
+    double points = static_cast<double>(numCurves * length);
+    std::cout << "Curves: " << numCurves << " x " << length << " points" << std::endl;
+    std::cout << "Per-metric passes (4 metrics) : " << perMetric << " s, "
+              << points / perMetric / 1e6 << " M points/s" << std::endl;
+    std::cout << "riskMetrics (11 metrics)      : " << fused << " s, "
+              << points / fused / 1e6 << " M points/s" << std::endl;
+    std::cout << "PerformanceAccumulator::add   : " << streaming << " s, "
+              << points / streaming / 1e6 << " M points/s" << std::endl;
+    std::cout << "Speedup: " << perMetric / fused << "x (checksum " << checksum << ")"
+              << std::endl;
+
+    // Building the matrix is the caller's layout choice, so it is not timed
+    EquityMatrix matrix = EquityMatrix::fromCurves(curves);
+    for (size_t threads = 1; threads <= maxThreads; threads *= 2) {
+        double batchSum = 0.0;
+        double batch = secondsFor([&] {
+            for (const RiskMetrics& metrics : batchRiskMetrics(matrix, {.threads = threads})) {
+                batchSum += metrics.sharpe;
+            }
+        });
+        std::cout << "batchRiskMetrics, " << threads << " thread(s)  : " << batch << " s, "
+                  << points / batch / 1e6 << " M points/s, " << perMetric / batch << "x"
+                  << std::endl;
+    }
+    return 0;
+}
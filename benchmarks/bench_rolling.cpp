@@ -0,0 +1,71 @@
+// Rolling Sharpe, volatility and drawdown at every point of a curve: Performance recomputed
+// on each sliding slice (O(N * W)) vs RollingPerformance updated per point (O(N)).
+// Usage: ./bench_rolling [numPoints] [window]
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "backtest-cpp/performance.h"
+
+namespace {
+
+template <typename F>
+double secondsFor(F&& f) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    size_t numPoints = argc > 1 ? std::stoul(argv[1]) : 50'000;
+    size_t window = argc > 2 ? std::stoul(argv[2]) : 23 * 60;  // One trading day of minutes
+
+    std::mt19937_64 rng(7);
+    std::normal_distribution<double> step(0.0, 0.001);
+    std::vector<EquityPoint> curve;
+    double equity = 100'000.0;
+    for (size_t i = 0; i < numPoints; ++i) {
+        equity *= std::exp(step(rng));
+        curve.push_back({static_cast<int64_t>(i) * 60, equity});
+    }
+
+    double naiveSum = 0.0;
+    double naive = secondsFor([&] {
+        std::vector<EquityPoint> slice;
+        for (size_t i = window; i < curve.size(); ++i) {
+            slice.assign(curve.begin() + i - window, curve.begin() + i + 1);
+            double peak = std::max_element(slice.begin(), slice.end(),
+                                           [](const EquityPoint& a, const EquityPoint& b) {
+                                               return a.equity < b.equity;
+                                           })->equity;
+            naiveSum += Performance::sharpeRatio(slice, Frequency::MINUTE) +
+                        Performance::annualizedVolatility(slice, Frequency::MINUTE) +
+                        (peak - slice.back().equity) / peak;
+        }
+    });
+
+    double rollingSum = 0.0;
+    double rolling = secondsFor([&] {
+        RollingPerformance metrics({.bars = window});
+        for (const EquityPoint& point : curve) {
+            metrics.add(point.equity);
+            if (!metrics.ready()) continue;
+            rollingSum +=
+                metrics.sharpeRatio() + metrics.annualizedVolatility() + metrics.drawdown();
+        }
+    });
+
+    std::cout << "Points: " << numPoints << ", window: " << window << std::endl;
+    std::cout << "Performance per slice : " << naive << " s" << std::endl;
+    std::cout << "RollingPerformance    : " << rolling << " s" << std::endl;
+    std::cout << "Speedup: " << naive / rolling << "x, relative difference "
+              << std::abs(rollingSum - naiveSum) / std::abs(naiveSum) << std::endl;
+    return 0;
+}
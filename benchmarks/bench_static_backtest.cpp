@@ -0,0 +1,114 @@
+// SMACrossover on a fixed universe: the dynamic build (BacktestEngine, virtual strategy,
+// runtime flags) vs the engine on the concrete strategy vs Backtest<> with everything fixed
+// at compile time, with runtime cost models, a dynamic and a static universe.
+// Usage: ./bench_static_backtest [numBars]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../strategies/smacrossover.h"
+#include "backtest-cpp/data.h"
+#include "backtest-cpp/engine.h"
+#include "backtest-cpp/static_backtest.h"
+#include "bench_util.h"
+
+namespace {
+
+constexpr size_t kSymbols = 8;
+
+struct Result {
+    double seconds;
+    double finalEquity;
+};
+
+// Best of three runs, each on a fresh strategy and portfolio
+template <typename Run>
+Result best(Run&& run) {
+    Result result{1e300, 0.0};
+    for (int i = 0; i < 3; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        double equity = run();
+        double seconds =
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        result = {std::min(result.seconds, seconds), equity};
+    }
+    return result;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    size_t numBars = argc > 1 ? std::stoul(argv[1]) : 100'000;
+
+    DataHandler data;
+    for (size_t s = 0; s < kSymbols; ++s) {
+        const std::string path = "bench_static_" + std::to_string(s) + ".csv";
+        bench::writeCsv(path, numBars, 7 + s);
+        data.loadCSV(path, "S" + std::to_string(s));
+        std::remove(path.c_str());
+    }
+    data.synchronize();
+
+    PortfolioConfig book{.initialCash = 1'000'000.0, .commission = 2.7, .logTrades = false};
+    BacktestConfig config{.warmupBars = 80, .maxInvest = 10'000};
+
+    Result dynamic = best([&] {
+        SMACrossover strategy(10, 30);
+        Portfolio portfolio(book);
+        BacktestEngine engine(data, strategy, portfolio,
+                              {.warmupBars = 80, .maxInvest = 10'000, .logOrders = false});
+        engine.run();
+        return engine.getEquityCurve().back().equity;
+    });
+    Result typedEngine = best([&] {
+        SMACrossover strategy(10, 30);
+        Portfolio portfolio(book);
+        BasicBacktestEngine<SMACrossover> engine(
+            data, strategy, portfolio, {.warmupBars = 80, .maxInvest = 10'000, .logOrders = false});
+        engine.run();
+        return engine.getEquityCurve().back().equity;
+    });
+    Result runtimeCosts = best([&] {
+        SMACrossover strategy(10, 30);
+        Backtest<Strategy, RuntimeCommission, RuntimeSlippage> backtest(data, strategy, book,
+                                                                        config);
+        backtest.run();
+        return backtest.getEquityCurve().back().equity;
+    });
+    Result dynamicUniverse = best([&] {
+        SMACrossover strategy(10, 30);
+        Backtest<SMACrossover> backtest(data, strategy, book, config);
+        backtest.run();
+        return backtest.getEquityCurve().back().equity;
+    });
+    Result staticUniverse = best([&] {
+        SMACrossover strategy(10, 30);
+        Backtest<SMACrossover, FlatCommission, NoSlippage, kSymbols> backtest(data, strategy,
+                                                                             book, config);
+        backtest.run();
+        return backtest.getEquityCurve().back().equity;
+    });
+
+    double bars = static_cast<double>(data.size());
+    auto print = [&](const char* name, const Result& result) {
+        std::printf("%-44s %8.4f s %10.0f bars/s %6.2fx\n", name, result.seconds,
+                    bars / result.seconds, dynamic.seconds / result.seconds);
+    };
+    std::cout << "Bars: " << data.size() << ", symbols: " << kSymbols << std::endl;
+    print("BacktestEngine, virtual strategy", dynamic);
+    print("BasicBacktestEngine<SMACrossover>", typedEngine);
+    print("Backtest<Strategy, Runtime costs>", runtimeCosts);
+    print("Backtest<SMACrossover>, dynamic universe", dynamicUniverse);
+    print("Backtest<SMACrossover, Flat, None, 8>", staticUniverse);
+
+    bool same = typedEngine.finalEquity == dynamic.finalEquity &&
+                runtimeCosts.finalEquity == dynamic.finalEquity &&
+                dynamicUniverse.finalEquity == dynamic.finalEquity &&
+                staticUniverse.finalEquity == dynamic.finalEquity;
+    std::cout << "Final equity " << (same ? "identical" : "DIFFERENT") << std::endl;
+    return same ? 0 : 1;
+}
@@ -0,0 +1,140 @@
+// SMACrossover::onBars through the virtual map-returning interface vs the SignalBuffer one,
+// and per-symbol SMA state as one SMA object per symbol vs a structure-of-arrays SMABank.
+// Usage: ./bench_strategy [numBars] [numSymbols]
+
+#include <chrono>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../strategies/smacrossover.h"
+
+namespace {
+
+std::vector<std::map<std::string, Bar>> makeBars(size_t numBars) {
+    std::mt19937_64 rng(7);
+    std::normal_distribution<double> step(0.0, 2.0);
+    double price = 10'000.0;
+
+    std::vector<std::map<std::string, Bar>> bars;
+    bars.reserve(numBars);
+    for (size_t i = 0; i < numBars; ++i) {
+        double open = price;
+        price = std::max(1.0, price + step(rng));
+        Bar bar{.symbol = "NQ",
+                .time = static_cast<int64_t>(i),
+                .open = open,
+                .high = std::max(open, price),
+                .low = std::min(open, price),
+                .close = price,
+                .volume = 500};
+        bars.push_back({{"NQ", bar}});
+    }
+    return bars;
+}
+
+// Runs `step` over every bar after the warm-up; returns seconds and counts signals
+template <typename Step>
+double timeLoop(const std::vector<std::map<std::string, Bar>>& bars, SMACrossover& strategy,
+                size_t& signalCount, Step step) {
+    std::vector<std::map<std::string, Bar>> history(bars.begin(), bars.begin() + 30);
+    strategy.onInit(history);
+
+    signalCount = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 30; i < bars.size(); ++i) {
+        signalCount += step(bars[i]);
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(end - start).count();
+}
+
+// Seconds to advance `numSymbols` SMAs by `steps` values, one object per symbol or one bank
+std::pair<double, double> timeSymbolState(size_t numSymbols, size_t steps) {
+    std::vector<double> closes(numSymbols);
+    for (size_t s = 0; s < numSymbols; ++s) closes[s] = 100.0 + static_cast<double>(s);
+
+    std::vector<SMA> objects(numSymbols, SMA(30));
+    auto start = std::chrono::steady_clock::now();
+    for (size_t t = 0; t < steps; ++t) {
+        for (size_t s = 0; s < numSymbols; ++s) objects[s].update(closes[s] + t);
+    }
+    auto mid = std::chrono::steady_clock::now();
+
+    SMABank bank(30, numSymbols);
+    std::vector<double> values(numSymbols);
+    for (size_t t = 0; t < steps; ++t) {
+        for (size_t s = 0; s < numSymbols; ++s) values[s] = closes[s] + t;
+        bank.updateAll(values);
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    if (std::abs(bank.value(numSymbols - 1) - objects.back().value()) > 1e-6) {
+        std::cerr << "SMABank and SMA disagree" << std::endl;
+    }
+    return {std::chrono::duration<double>(mid - start).count(),
+            std::chrono::duration<double>(end - mid).count()};
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    size_t numBars = argc > 1 ? std::stoul(argv[1]) : 1'000'000;
+    size_t numSymbols = argc > 2 ? std::stoul(argv[2]) : 2'000;
+    std::vector<std::map<std::string, Bar>> bars = makeBars(numBars);
+    std::map<std::string, Position> positions;
+    SignalBuffer signals;
+
+    SMACrossover mapStrategy(10, 30);
+    Strategy& mapVirtual = mapStrategy;
+    size_t mapSignals = 0;
+    double mapSec = timeLoop(bars, mapStrategy, mapSignals, [&](const auto& bar) {
+        size_t count = 0;
+        for (const auto& [symbol, signal] : mapVirtual.onBars(bar, positions)) {
+            count += signal.has_value();
+        }
+        return count;
+    });
+
+    SMACrossover bufferStrategy(10, 30);
+    Strategy& bufferVirtual = bufferStrategy;
+    size_t bufferSignals = 0;
+    double bufferSec = timeLoop(bars, bufferStrategy, bufferSignals, [&](const auto& bar) {
+        signals.clear();
+        bufferVirtual.onBars(bar, positions, signals);
+        return signals.count();
+    });
+
+    SMACrossover staticStrategy(10, 30);
+    size_t staticSignals = 0;
+    double staticSec = timeLoop(bars, staticStrategy, staticSignals, [&](const auto& bar) {
+        signals.clear();
+        staticStrategy.onBars(bar, positions, signals);  // SMACrossover is final
+        return signals.count();
+    });
+
+    double n = static_cast<double>(numBars - 30);
+    std::cout << "Bars                 : " << numBars << " (" << staticSignals << " signals)"
+              << std::endl;
+    std::cout << "Virtual, map         : " << n / mapSec << " bars/s" << std::endl;
+    std::cout << "Virtual, SignalBuffer: " << n / bufferSec << " bars/s" << std::endl;
+    std::cout << "Static, SignalBuffer : " << n / staticSec << " bars/s" << std::endl;
+
+    size_t steps = std::max<size_t>(1, numBars / numSymbols);
+    auto [objectSec, bankSec] = timeSymbolState(numSymbols, steps);
+    double updates = static_cast<double>(numSymbols * steps);
+    std::cout << "Symbols              : " << numSymbols << " x " << steps << " bars" << std::endl;
+    std::cout << "SMA per symbol       : " << updates / objectSec << " updates/s" << std::endl;
+    std::cout << "SMABank              : " << updates / bankSec << " updates/s" << std::endl;
+
+    if (mapSignals != bufferSignals || bufferSignals != staticSignals) {
+        std::cerr << "Signal counts differ between interfaces" << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,94 @@
+// Parameter sweep throughput for 1, 2, 4, ... threads up to the hardware thread count,
+// with the scaling efficiency relative to one thread. Then the full gridSize x gridSize grid
+// through SharedSMASweep, priced in standalone engine and vectorized runs.
+// Usage: ./bench_sweep [numBars] [numRuns] [gridSize]
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "backtest-cpp/data.h"
+#include "backtest-cpp/sweep.h"
+#include "backtest-cpp/vectorized.h"
+
+namespace {
+
+template <typename F>
+double secondsFor(F&& f) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    size_t numBars = argc > 1 ? std::stoul(argv[1]) : 20'000;
+    size_t numRuns = argc > 2 ? std::stoul(argv[2]) : 64;
+    int gridSize = argc > 3 ? std::stoi(argv[3]) : 200;
+
+    std::mt19937_64 rng(7);
+    std::normal_distribution<double> step(0.0, 2.0);
+    double price = 10'000.0;
+    std::vector<std::map<std::string, Bar>> bars;
+    for (size_t i = 0; i < numBars; ++i) {
+        double open = price;
+        price = std::max(1.0, price + step(rng));
+        Bar bar{.symbol = "NQ",
+                .time = static_cast<int64_t>(i) * 60,
+                .open = open,
+                .high = std::max(open, price),
+                .low = std::min(open, price),
+                .close = price,
+                .volume = 500};
+        bars.push_back({{"NQ", bar}});
+    }
+    DataHandler data;
+    data.synchronize(bars);
+
+    std::vector<SMAParams> params = randomSearch({2, 50}, {20, 200}, numRuns);
+    SweepConfig config{.portfolio = {.initialCash = 100'000.0, .commission = 2.7},
+                       .engine = {.warmupBars = 200, .maxInvest = 10'000}};
+
+    size_t hardware = std::max(1u, std::thread::hardware_concurrency());
+    double baseline = 0.0;
+    std::cout << "Bars: " << numBars << ", runs: " << params.size() << std::endl;
+    for (size_t threads = 1; threads <= hardware; threads *= 2) {
+        config.threads = threads;
+        ParameterSweep sweep(data, config);
+
+        auto start = std::chrono::steady_clock::now();
+        std::vector<SweepResult> results = sweep.run(params);
+        auto end = std::chrono::steady_clock::now();
+
+        double seconds = std::chrono::duration<double>(end - start).count();
+        double runsPerSec = static_cast<double>(results.size()) / seconds;
+        if (threads == 1) baseline = runsPerSec;
+        std::cout << "Threads " << threads << ": " << runsPerSec << " runs/s, efficiency "
+                  << runsPerSec / (baseline * threads) * 100 << " %" << std::endl;
+    }
+
+    // One thread throughout, so the grid's cost reads directly in single runs
+    config.threads = 1;
+    config.engine.warmupBars = static_cast<size_t>(gridSize);
+    std::vector<SMAParams> grid = gridSearch({1, gridSize}, {1, gridSize});
+    BarColumns columns = BarColumns::fromData(data, "NQ");
+
+    double engineRun = secondsFor([&] { ParameterSweep(data, config).runOne({10, 30}); });
+    double vectorizedRun = secondsFor([&] {
+        VectorizedBacktest(config.portfolio, {.warmupBars = static_cast<size_t>(gridSize)})
+            .run(columns);
+    });
+    double shared = secondsFor([&] { SharedSMASweep(columns, config).run(grid); });
+
+    std::cout << "Shared sweep, " << grid.size() << " runs: " << shared << " s = "
+              << shared / engineRun << " engine runs = " << shared / vectorizedRun
+              << " vectorized runs (" << grid.size() / shared << " runs/s)" << std::endl;
+    return 0;
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+// Helpers shared by the benchmarks
+
+#include <algorithm>
+#include <cstdint>
+#include <ctime>
+#include <fstream>
+#include <random>
+#include <string>
+
+namespace bench {
+
+// Random-walk minute bars from 2020-09-13 on, in the CSV format DataHandler::loadCSV reads
+inline void writeCsv(const std::string& path, size_t numBars, uint64_t seed = 7) {
+    std::mt19937_64 rng(seed);
+    std::normal_distribution<double> step(0.0, 2.0);
+    double price = 10'000.0;
+
+    std::ofstream file(path);
+    file << "timestamp,open,high,low,close,volume\n";
+    for (size_t i = 0; i < numBars; ++i) {
+        double open = price;
+        price = std::max(1.0, price + step(rng));
+        std::time_t time = 1'600'000'000 + static_cast<std::time_t>(i) * 60;
+        char stamp[32];
+        std::strftime(stamp, sizeof(stamp), "%Y-%m-%d %H:%M:%S", std::gmtime(&time));
+        file << stamp << "," << open << "," << std::max(open, price) << ","
+             << std::min(open, price) << "," << price << ",500\n";
+    }
+}
+
+}  // namespace bench
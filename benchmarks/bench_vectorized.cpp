@@ -0,0 +1,96 @@
+// SMA crossover over the same bars with the event-driven BacktestEngine and with
+// VectorizedBacktest; both must end on the same equity.
+// Usage: ./bench_vectorized [numBars] [repeats]
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../strategies/smacrossover.h"
+#include "backtest-cpp/data.h"
+#include "backtest-cpp/engine.h"
+#include "backtest-cpp/portfolio.h"
+#include "backtest-cpp/vectorized.h"
+
+namespace {
+
+// Random walk on a quarter-point tick grid
+std::vector<std::map<std::string, Bar>> makeBars(size_t numBars) {
+    std::mt19937_64 rng(7);
+    std::uniform_int_distribution<int> ticks(-8, 8);
+    double price = 10'000.0;
+
+    std::vector<std::map<std::string, Bar>> bars;
+    bars.reserve(numBars);
+    for (size_t i = 0; i < numBars; ++i) {
+        double open = price;
+        price = std::max(1.0, price + 0.25 * ticks(rng));
+        Bar bar{.symbol = "NQ",
+                .time = static_cast<int64_t>(i) * 60,
+                .open = open,
+                .high = std::max(open, price),
+                .low = std::min(open, price),
+                .close = price,
+                .volume = 500};
+        bars.push_back({{"NQ", bar}});
+    }
+    return bars;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    size_t numBars = argc > 1 ? std::stoul(argv[1]) : 1'000'000;
+    size_t repeats = argc > 2 ? std::stoul(argv[2]) : 20;
+
+    std::vector<std::map<std::string, Bar>> bars = makeBars(numBars);
+    DataHandler data;
+    data.synchronize(bars);
+    BarColumns columns = BarColumns::fromData(data, "NQ");
+    PortfolioConfig config{.initialCash = 100'000.0, .commission = 2.7};
+
+    // Portfolio logs every trade; keep that out of the output
+    std::ostringstream sink;
+    std::streambuf* stdoutBuf = std::cout.rdbuf(sink.rdbuf());
+    Portfolio portfolio(config);
+    SMACrossover strategy(10, 30);
+    BacktestEngine engine(data, strategy, portfolio,
+                          {.warmupBars = 30, .maxInvest = 10'000, .logOrders = false});
+    auto start = std::chrono::steady_clock::now();
+    engine.run();
+    auto end = std::chrono::steady_clock::now();
+    std::cout.rdbuf(stdoutBuf);
+    double engineSec = std::chrono::duration<double>(end - start).count();
+
+    VectorizedBacktest backtest(config);
+    double vectorSec = 1e300;
+    double vectorEquity = 0.0;
+    for (size_t r = 0; r < repeats; ++r) {
+        start = std::chrono::steady_clock::now();
+        vectorEquity = backtest.run(columns).equityCurve.back().equity;
+        end = std::chrono::steady_clock::now();
+        vectorSec = std::min(vectorSec, std::chrono::duration<double>(end - start).count());
+    }
+
+    double n = static_cast<double>(numBars);
+    double engineEquity = engine.getEquityCurve().back().equity;
+    std::cout << "Bars           : " << numBars << " (" << portfolio.getAllTrades().size()
+              << " trades)" << std::endl;
+    std::cout << "Event engine   : " << n / engineSec / 1e3 << " bars/ms" << std::endl;
+    std::cout << "Vectorized     : " << n / vectorSec / 1e3 << " bars/ms (best of " << repeats
+              << ")" << std::endl;
+    std::cout << "Speedup        : " << engineSec / vectorSec << "x" << std::endl;
+
+    if (std::abs(engineEquity - vectorEquity) > 1e-6 * std::abs(engineEquity)) {
+        std::cerr << "Final equity differs: " << engineEquity << " vs " << vectorEquity
+                  << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "backtest-cpp/performance.h"
+
+// Equity curves of many runs over the same points, stored point-major: the equities of all
+// runs at one point are contiguous, so a kernel stepping through time updates a block of
+// runs with SIMD lanes across runs.
+struct EquityMatrix {
+    size_t runs = 0;
+    std::vector<int64_t> time;   // One per point
+    std::vector<double> equity;  // equity[point * runs + run]
+
+    size_t points() const { return time.size(); }
+    double& at(size_t point, size_t run) { return equity[point * runs + run]; }
+    double at(size_t point, size_t run) const { return equity[point * runs + run]; }
+
+    // Transposes curves of equal length, taking the times of the first. Throws
+    // std::invalid_argument if the lengths differ.
+    static EquityMatrix fromCurves(const std::vector<std::vector<EquityPoint>>& curves);
+};
+
+struct BatchMetricsConfig {
+    Frequency frequency = Frequency::MINUTE;
+    double riskFreeRate = 0.0;
+    size_t blockRuns = 256;  // Runs per task; their running sums stay in L1
+    size_t threads = 0;      // 0 = one per hardware thread
+};
+
+// Performance::riskMetrics for every run of `curves`, results[run], in one pass over the
+// matrix. Each point's log returns are computed once per block and shared by every metric;
+// the per-run sums are structure-of-arrays updated branch-free, so the compiler vectorizes
+// across runs. Blocks of runs are spread over a ThreadPool. Results are identical to
+// Performance::riskMetrics on each curve and independent of the thread count. Throws
+// std::runtime_error for fewer than 3 points.
+std::vector<RiskMetrics> batchRiskMetrics(const EquityMatrix& curves,
+                                          const BatchMetricsConfig& config = {});
@@ -0,0 +1,279 @@
+#pragma once
+
+#include <array>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "backtest-cpp/indicator_graph.h"
+#include "backtest-cpp/strategy.h"
+#include "backtest-cpp/symbol_table.h"
+#include "backtest-cpp/types.h"
+
+// Coroutine frames in 64-byte size classes, carved from 64 KiB chunks and kept on free lists
+// when their coroutine ends. Once a strategy has run each of its coroutines, starting them
+// again does not allocate. Every frame starts with a header naming its pool, so frames
+// larger than the biggest class, or created while no strategy is active, use ::operator new.
+class FramePool {
+   public:
+    FramePool() = default;
+    FramePool(const FramePool&) = delete;
+    FramePool& operator=(const FramePool&) = delete;
+
+    // `pool` may be null
+    static void* allocate(FramePool* pool, size_t size);
+    static void deallocate(void* frame, size_t size);
+
+    // Pool of the strategy starting or resuming its coroutines on this thread, null outside.
+    // activate returns the previous one for restoring.
+    static FramePool* active() { return active_; }
+    static FramePool* activate(FramePool* pool) { return std::exchange(active_, pool); }
+
+    size_t chunks() const { return chunks_.size(); }
+    size_t live() const { return live_; }  // Pooled frames not yet freed
+
+   private:
+    static constexpr size_t kClassSize = 64;
+    static constexpr size_t kClasses = 32;
+    static constexpr size_t kChunkSize = 64 * 1024;
+
+    std::byte* take(size_t sizeClass);
+    void give(std::byte* block, size_t sizeClass);
+
+    std::vector<std::unique_ptr<std::byte[]>> chunks_;
+    size_t chunkUsed_ = kChunkSize;
+    std::array<std::byte*, kClasses> free_ = {};  // Next block stored in each free block
+    size_t live_ = 0;
+
+    static inline thread_local FramePool* active_ = nullptr;
+};
+
+// Strategy written as a coroutine instead of a callback: run() is started in onInit and
+// co_awaits the next bar, a number of bars, a time or a fill, so multi-step logic such as
+// "wait for a crossover, then a pullback, then scale in over three bars" reads top to
+// bottom instead of as a state machine in onBars. A Task can co_await another Task, and
+// spawn() starts more top-level tasks that wait independently. Coroutines are only ever
+// resumed from onBars, so orders placed after any await belong to the current bar; fills
+// arriving during a bar are delivered on the next one. Frames of coroutines created while
+// the strategy runs (run() and the tasks it awaits or spawns) come from its FramePool, so
+// waiting and resuming cost about a function call.
+// Coroutine frames cannot be serialized, so these strategies do not support checkpoints.
+class CoroutineStrategy : public Strategy {
+   public:
+    class Task;
+
+    CoroutineStrategy() = default;
+    ~CoroutineStrategy() override;
+    CoroutineStrategy(const CoroutineStrategy&) = delete;  // Frames point to the strategy
+    CoroutineStrategy& operator=(const CoroutineStrategy&) = delete;
+
+    void onInit(const std::vector<std::map<std::string, Bar>>& availableData) override;
+    void onInit(const std::vector<std::map<std::string, Bar>>& availableData,
+                IndicatorGraph& indicators) override;
+
+    std::map<std::string, std::optional<Signal>> onBars(
+        const std::map<std::string, Bar>& bars,
+        std::map<std::string, Position>& positions) override;
+    void onBars(const std::map<std::string, Bar>& bars, std::map<std::string, Position>& positions,
+                SignalBuffer& signals) override;
+    void onFill(const Order& fill) override;
+
+    Order generateOrder(const Signal& signal, const Bar& currentBar, const double& maxInvest,
+                        std::map<std::string, Position>& positions) override;
+    std::map<std::string, Order> generateOrders(
+        const std::map<std::string, Signal>& signals, const std::map<std::string, Bar>& currentBars,
+        const double& maxInvest, std::map<std::string, Position>& positions) override;
+    void generateOrders(const SignalBuffer& signals, const std::map<std::string, Bar>& currentBars,
+                        const double& maxInvest, std::map<std::string, Position>& positions,
+                        std::vector<Order>& orders) override;
+
+    void saveState(BinaryWriter& writer) const override;  // Both throw
+    void loadState(BinaryReader& reader) override;
+
+    const FramePool& framePool() const { return framePool_; }
+    size_t numTasks() const;  // Top-level tasks still running
+
+   protected:
+    struct BarAwaiter;
+    struct FillAwaiter;
+
+    // The strategy's body, started in onInit: declare indicators, then loop over bars
+    virtual Task run() = 0;
+
+    // Starts `task` now, running it until its first await
+    void spawn(Task task);
+
+    // Awaitables, resumed from onBars. The bar ones return the bar's cross-section
+    BarAwaiter nextBar();
+    BarAwaiter skipBars(size_t count);  // The count-th bar from now, count 0 resumes at once
+    BarAwaiter waitUntil(int64_t time);  // First later bar at or after `time`
+    FillAwaiter nextFill(const std::string& symbol);  // The bar after the symbol's next fill
+
+    // Orders for the current bar, priced at its close like SMACrossover's. The last order
+    // for a symbol in a bar wins.
+    void trade(const std::string& symbol, int quantity);
+    // Go to floor(|fraction| * maxInvest / open) contracts, short for a negative fraction
+    void target(const std::string& symbol, double fraction);
+
+    const std::vector<std::map<std::string, Bar>>& history() const { return *history_; }
+    const std::map<std::string, Bar>& bars() const { return *bars_; }
+    int position(const std::string& symbol) const;
+
+    IndicatorGraph& indicators() { return ownsIndicators_ ? ownIndicators_ : *sharedIndicators_; }
+
+   private:
+    enum class WaitKind : uint8_t { BARS, TIME, FILL };
+
+    struct Wait {
+        WaitKind kind = WaitKind::BARS;
+        uint64_t bars = 1;    // BARS: bars left
+        int64_t time = 0;     // TIME
+        uint32_t symbol = 0;  // FILL: id in symbols_
+        std::coroutine_handle<> handle = {};
+    };
+
+    struct Root;
+
+    struct Intent {
+        bool isTarget = false;
+        int quantity = 0;
+        double fraction = 0.0;
+    };
+
+    void start(const std::vector<std::map<std::string, Bar>>& history);
+    void setIntent(const std::string& symbol, const Intent& intent, SignalType direction);
+    int orderQuantity(const Intent& intent, const Bar& bar, double maxInvest,
+                      int currentPosition) const;
+
+    FramePool framePool_;  // Declared first, so every frame is destroyed before it
+    std::vector<Root> roots_;
+
+    IndicatorGraph ownIndicators_;
+    IndicatorGraph* sharedIndicators_ = nullptr;
+    bool ownsIndicators_ = true;
+
+    const std::vector<std::map<std::string, Bar>>* history_ = nullptr;  // During onInit
+    const std::map<std::string, Bar>* bars_ = nullptr;
+    std::map<std::string, Position>* positions_ = nullptr;
+    SignalBuffer* signals_ = nullptr;  // Set while onBars runs
+
+    uint64_t barCount_ = 0;
+
+    SymbolTable symbols_;  // Indexes intents_ and fill waits
+    std::vector<Intent> intents_;
+
+    SignalBuffer scratch_;  // Backs the map-returning onBars
+};
+
+class CoroutineStrategy::Task {
+   public:
+    struct promise_type;
+    using Handle = std::coroutine_handle<promise_type>;
+
+    struct promise_type {
+        std::coroutine_handle<> continuation;  // Awaiting task, null for a top-level one
+        uint32_t root = 0;  // Slot in roots_ of the top-level task
+        std::exception_ptr error;
+
+        Task get_return_object() { return Task(Handle::from_promise(*this)); }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+
+        struct FinalAwaiter {
+            bool await_ready() const noexcept { return false; }
+            std::coroutine_handle<> await_suspend(Handle handle) noexcept {
+                std::coroutine_handle<> next = handle.promise().continuation;
+                return next ? next : std::noop_coroutine();
+            }
+            void await_resume() const noexcept {}
+        };
+        FinalAwaiter final_suspend() noexcept { return {}; }
+
+        void return_void() {}
+        void unhandled_exception() { error = std::current_exception(); }
+
+        // Frames created while a strategy runs its coroutines come from its pool. Plain
+        // operator new rather than one taking the coroutine's arguments, so that new and
+        // delete match for GCC's -Wmismatched-new-delete.
+        static void* operator new(size_t size) {
+            return FramePool::allocate(FramePool::active(), size);
+        }
+        static void operator delete(void* frame, size_t size) {
+            FramePool::deallocate(frame, size);
+        }
+    };
+
+    Task(Task&& other) noexcept : handle_(std::exchange(other.handle_, {})) {}
+    Task& operator=(Task&& other) noexcept {
+        if (this != &other) {
+            if (handle_) handle_.destroy();
+            handle_ = std::exchange(other.handle_, {});
+        }
+        return *this;
+    }
+    ~Task() {
+        if (handle_) handle_.destroy();
+    }
+
+    bool done() const { return !handle_ || handle_.done(); }
+
+    // Awaiting a task runs it to completion; its own awaits suspend the awaiting task too
+    bool await_ready() const noexcept { return false; }
+    Handle await_suspend(Handle caller) noexcept {
+        promise_type& promise = handle_.promise();
+        promise.continuation = caller;
+        promise.root = caller.promise().root;
+        return handle_;
+    }
+    void await_resume() {
+        if (handle_.promise().error) std::rethrow_exception(handle_.promise().error);
+    }
+
+   private:
+    friend class CoroutineStrategy;
+    explicit Task(Handle handle) : handle_(handle) {}
+
+    Handle handle_;
+};
+
+// Slot of a top-level task, reused once it has finished so the indices tasks hold stay valid
+struct CoroutineStrategy::Root {
+    Task task;
+    Wait wait = {};
+    uint64_t startedAt = 0;  // barCount_ when spawned, not resumed again in that bar
+    bool filled = false;
+    Order fill = {};  // FILL: delivered on resume
+};
+
+struct CoroutineStrategy::BarAwaiter {
+    CoroutineStrategy* strategy;
+    Wait wait;
+
+    bool await_ready() const noexcept { return wait.kind == WaitKind::BARS && wait.bars == 0; }
+    void await_suspend(Task::Handle handle) noexcept {
+        wait.handle = handle;
+        strategy->roots_[handle.promise().root].wait = wait;
+    }
+    const std::map<std::string, Bar>& await_resume() const noexcept { return *strategy->bars_; }
+};
+
+struct CoroutineStrategy::FillAwaiter {
+    CoroutineStrategy* strategy;
+    uint32_t symbol;
+    uint32_t root = 0;
+
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(Task::Handle handle) noexcept {
+        root = handle.promise().root;
+        Root& waiting = strategy->roots_[root];
+        waiting.wait = {.kind = WaitKind::FILL, .symbol = symbol, .handle = handle};
+        waiting.filled = false;
+    }
+    Order await_resume() const { return strategy->roots_[root].fill; }
+};
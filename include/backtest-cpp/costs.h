@@ -0,0 +1,163 @@
+#pragma once
+
+#include <cmath>
+#include <concepts>
+#include <cstdlib>
+#include <limits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+// ============================================================================
+// Commission models: fee charged for filling `quantity` contracts at `price`
+// ============================================================================
+
+template <typename T>
+concept CommissionModel = requires(const T& model, int quantity, double price) {
+    { model.cost(quantity, price) } -> std::convertible_to<double>;
+};
+
+// Fixed fee per order, independent of size (the original Portfolio behaviour)
+struct FlatCommission {
+    double perOrder = 0.0;
+
+    double cost(int, double) const { return perOrder; }
+};
+
+struct PerContractCommission {
+    double perContract = 0.0;
+
+    double cost(int quantity, double) const { return perContract * std::abs(quantity); }
+};
+
+// Fraction of traded notional, e.g. 0.0005 = 5 bps
+struct PercentageCommission {
+    double rate = 0.0;
+
+    double cost(int quantity, double price) const { return rate * std::abs(quantity) * price; }
+};
+
+struct CommissionTier {
+    int upToContracts;  // Inclusive upper bound of the tier
+    double perContract;
+};
+
+// Marginal per-contract rates: the first tier's contracts at its rate, the next
+// contracts at the following tier's rate, and so on. The last tier is open-ended.
+struct TieredCommission {
+    std::vector<CommissionTier> tiers;
+    double minimum = 0.0;
+
+    double cost(int quantity, double) const {
+        int remaining = std::abs(quantity);
+        int lowerBound = 0;
+        double fee = 0.0;
+
+        for (size_t i = 0; i < tiers.size() && remaining > 0; ++i) {
+            bool last = (i + 1 == tiers.size());
+            int tierSize =
+                last ? std::numeric_limits<int>::max() : tiers[i].upToContracts - lowerBound;
+            int filled = remaining < tierSize ? remaining : tierSize;
+
+            fee += filled * tiers[i].perContract;
+            remaining -= filled;
+            lowerBound = tiers[i].upToContracts;
+        }
+        return fee > minimum ? fee : minimum;
+    }
+};
+
+// Broker + exchange + clearing fees per contract, plus a regulatory fee on notional
+struct ExchangeFeeCommission {
+    double brokerPerContract = 0.0;
+    double exchangePerContract = 0.0;
+    double clearingPerContract = 0.0;
+    double regulatoryRate = 0.0;
+
+    double cost(int quantity, double price) const {
+        int contracts = std::abs(quantity);
+        return contracts * (brokerPerContract + exchangePerContract + clearingPerContract) +
+               regulatoryRate * contracts * price;
+    }
+};
+
+// ============================================================================
+// Slippage models: price actually paid (quantity > 0) or received (quantity < 0)
+// ============================================================================
+
+template <typename T>
+concept SlippageModel = requires(const T& model, double price, int quantity, long volume) {
+    { model.fillPrice(price, quantity, volume) } -> std::convertible_to<double>;
+};
+
+struct NoSlippage {
+    double fillPrice(double price, int, long) const { return price; }
+};
+
+// Cross half the bid/ask spread
+struct SpreadSlippage {
+    double halfSpread = 0.0;
+
+    double fillPrice(double price, int quantity, long) const {
+        return quantity > 0 ? price + halfSpread : price - halfSpread;
+    }
+};
+
+struct FixedTickSlippage {
+    int ticks = 1;
+    double tickSize = 0.25;
+
+    double fillPrice(double price, int quantity, long) const {
+        double offset = ticks * tickSize;
+        return quantity > 0 ? price + offset : price - offset;
+    }
+};
+
+// Square-root market impact: price * coefficient * sqrt(|quantity| / barVolume).
+// Unknown volume (0) means no impact.
+struct VolumeImpactSlippage {
+    double coefficient = 0.1;
+
+    double fillPrice(double price, int quantity, long volume) const {
+        if (volume <= 0 || quantity == 0) return price;
+        double impact = price * coefficient * std::sqrt(std::abs(quantity) / double(volume));
+        return quantity > 0 ? price + impact : price - impact;
+    }
+};
+
+// ============================================================================
+// Runtime-selected models for exploratory runs (one std::visit per call)
+// ============================================================================
+
+class RuntimeCommission {
+   public:
+    using Model = std::variant<FlatCommission, PerContractCommission, PercentageCommission,
+                               TieredCommission, ExchangeFeeCommission>;
+
+    RuntimeCommission(double perOrder = 0.0) : model_(FlatCommission{perOrder}) {}
+    RuntimeCommission(Model model) : model_(std::move(model)) {}
+
+    double cost(int quantity, double price) const {
+        return std::visit([&](const auto& m) { return m.cost(quantity, price); }, model_);
+    }
+
+   private:
+    Model model_;
+};
+
+class RuntimeSlippage {
+   public:
+    using Model =
+        std::variant<NoSlippage, SpreadSlippage, FixedTickSlippage, VolumeImpactSlippage>;
+
+    RuntimeSlippage() = default;
+    RuntimeSlippage(Model model) : model_(std::move(model)) {}
+
+    double fillPrice(double price, int quantity, long volume) const {
+        return std::visit([&](const auto& m) { return m.fillPrice(price, quantity, volume); },
+                          model_);
+    }
+
+   private:
+    Model model_;
+};
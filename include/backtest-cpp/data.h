@@ -2,8 +2,10 @@
 
 #include <cstring>
 #include <map>
+#include <string>
 #include <vector>
 
+#include "backtest-cpp/serialization.h"
 #include "backtest-cpp/types.h"
 
 class DataHandler {
@@ -14,11 +16,25 @@ class DataHandler {
     void loadAllCSVs(const std::string& directory);
     std::map<std::string, Bar> getNextBars();
     std::map<std::string, Bar> getCurrentBars() const;
+    const std::map<std::string, Bar>& getBarsAt(size_t index) const;  // No copy, no cursor move
     bool hasMoreData() const;
     void reset();
+    // Merges bars into one map per timestamp across all instruments (see data.cpp)
+    void synchronize();
     void synchronize(std::vector<std::map<std::string, Bar>>& rawData);
     size_t size() const;
 
+    // Symbols present in any cross-section, sorted
+    std::vector<std::string> symbols() const;
+    // One copy of the data per group of symbols, in a single pass: parts[g] holds the
+    // cross-sections restricted to groups[g], without those where none of them has a bar yet.
+    // A symbol listed in several groups only goes to the first.
+    std::vector<DataHandler> split(const std::vector<std::vector<std::string>>& groups) const;
+
+    // Cursor of getNextBars; loading checks the same number of bars is loaded
+    void saveState(BinaryWriter& writer) const;
+    void loadState(BinaryReader& reader);
+
    private:
     std::vector<std::map<std::string, Bar>> instrumentData_;  // Loaded, synced data
     size_t currentIndex_ = 0;                                 // Current position in data
@@ -0,0 +1,678 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "backtest-cpp/data.h"
+#include "backtest-cpp/events.h"
+#include "backtest-cpp/indicator_graph.h"
+#include "backtest-cpp/performance.h"
+#include "backtest-cpp/portfolio.h"
+#include "backtest-cpp/ring_buffer.h"
+#include "backtest-cpp/serialization.h"
+#include "backtest-cpp/strategy.h"
+
+struct EngineConfig {
+    size_t warmupBars = 30;           // Bars handed to Strategy::onInit before trading starts
+    double maxInvest = 10'000;        // Passed to Strategy::generateOrder
+    size_t eventCapacity = 1024;      // Max events queued at once
+    bool logOrders = true;            // Print every order and fill
+    bool keepEquityCurve = true;      // Store every point, else only getPerformance() is kept
+    size_t checkpointEvery = 0;       // Snapshot every N bars, 0 = off
+    std::string checkpointDir = ".";  // Written as checkpoint_<last bar index>.bin
+    size_t checkpointKeep = 0;        // Newest snapshots of the run kept on disk, 0 = all
+    std::vector<RollingWindow> rollingWindows = {};  // A RollingPoint series for each
+    size_t quantileSketchK = 0;  // > 0 sketches every return and trade PnL with this k
+};
+
+// Config of engines run on worker threads: their order and trade logs would all go through
+// std::cout and serialize the threads
+inline void silenceLogs(EngineConfig& engine, PortfolioConfig& portfolio) {
+    engine.logOrders = false;
+    portfolio.logTrades = false;
+}
+
+struct EngineStats {
+    uint64_t bars = 0;
+    uint64_t events = 0;
+    std::array<uint64_t, 4> eventsByType = {};  // Indexed by EventType
+    double elapsedSeconds = 0.0;
+
+    double eventsPerSecond() const;
+};
+
+// Event-driven backtest loop:
+// MARKET -> Strategy::onBars -> SIGNAL -> Strategy::generateOrders -> ORDER -> Portfolio -> FILL
+// Events are processed FIFO from a preallocated ring and dispatched with std::visit, so a
+// run is deterministic. Signals and orders of one bar are batched: generateOrders and
+// Portfolio::executeOrders run once per bar once the queue has drained. The ring and the
+// signal, order and fill buffers are reused, and generateOrders writes into the order
+// buffer, so once every symbol has traded a bar does not allocate beyond the Portfolio's
+// order and trade logs (see Portfolio::reserveJournals). Strategies without the buffer-based
+// generateOrders are adapted through the map-based one, which allocates on signal bars.
+// The strategy type is a template parameter: BacktestEngine calls any Strategy through the
+// virtual interface, BasicBacktestEngine<MyStrategy> calls MyStrategy directly, so its
+// onBars can be inlined into the loop. Signals go into a SignalBuffer reused every bar.
+// The portfolio type is the second parameter, Portfolio by default; any BasicPortfolio,
+// e.g. RuntimePortfolio or one with other cost policies, drives the same loop.
+// Strategies declare shared indicators in an IndicatorGraph the engine owns, or one it is
+// given with shareIndicators(); either way it is evaluated once per bar before onBars.
+template <StaticStrategy S = Strategy, AnyPortfolio P = Portfolio>
+class BasicBacktestEngine {
+   public:
+    BasicBacktestEngine(const DataHandler& data, S& strategy, P& portfolio,
+                        const EngineConfig& config = {});
+
+    // Runs warm-up, the main loop and the final liquidation
+    const EngineStats& run();
+
+    // The phases of run(), for drivers stepping several engines over one data pass:
+    // warmUp with the first bars, then processBar for every following index in order, then
+    // finish. Elapsed time is only measured by run().
+    void warmUp(const std::vector<std::map<std::string, Bar>>& history);
+    void processBar(size_t index);
+    void finish();
+
+    // Use `graph` instead of the engine's own. The caller owns its updates: warmUp() only
+    // declares the strategy's nodes, so warm the graph up after every engine sharing it, then
+    // update it once per bar before calling processBar on each. Checkpoints do not cover it.
+    void shareIndicators(IndicatorGraph& graph) {
+        indicators_ = &graph;
+        ownsIndicators_ = false;
+    }
+    const IndicatorGraph& getIndicators() const { return *indicators_; }
+
+    // Empty unless EngineConfig::keepEquityCurve
+    const std::vector<EquityPoint>& getEquityCurve() const;
+    // Metrics over the same points, updated every bar
+    const PerformanceAccumulator& getPerformance() const { return performance_; }
+    // One point per equity point, whether or not the curve is kept, for
+    // EngineConfig::rollingWindows[window]
+    const std::vector<RollingPoint>& getRollingSeries(size_t window) const {
+        return rollingSeries_.at(window);
+    }
+    // Log return of every bar and PnL of every trade, if EngineConfig::quantileSketchK is set
+    const QuantileSketch& getReturnSketch() const { return returnSketch_; }
+    const QuantileSketch& getTradeSketch() const { return tradeSketch_; }
+    const EngineStats& getStats() const;
+
+    // Snapshot of the run after the last processed bar: bar cursor, stats, equity curve and
+    // metrics, indicator graph, portfolio and strategy state. loadCheckpoint makes the next
+    // run() continue from there bit-identically; data, strategy, portfolio, rolling windows
+    // and sketch k must be set up as for the original run.
+    // The append-only logs (equity curve, rolling series, orders, trades) go to
+    // checkpoint_journal.bin in the same directory: each snapshot appends what was added
+    // since the previous one and records the journal's length, so a snapshot's size and
+    // cost do not grow with the run. Keep the journal next to the snapshots.
+    void saveCheckpoint(const std::string& path);
+    void loadCheckpoint(const std::string& path);
+
+    std::string checkpointPath(size_t barIndex) const;
+    // Latest snapshot in `dir` taken at or before `barIndex`
+    static std::optional<std::string> findCheckpoint(const std::string& dir,
+                                                     size_t barIndex = SIZE_MAX);
+
+   private:
+    void push(Event event);
+    void drain();
+    void flushSignals();
+    void flushOrders();
+    void recordEquity();
+
+    void handle(const MarketEvent& event);
+    void handle(const SignalEvent& event);
+    void handle(const OrderEvent& event);
+    void handle(const FillEvent& event);
+
+    const DataHandler& data_;
+    S& strategy_;
+    P& portfolio_;
+    EngineConfig config_;
+
+    RingBuffer<Event> queue_;
+    SignalBuffer signals_;  // Scratch buffers reused for every bar
+    std::vector<Order> fills_;
+    SignalBuffer signalBatch_;
+    std::vector<Order> orderBatch_;  // Filled by generateOrders
+    std::vector<ExecutionResult> results_;
+    std::vector<EquityPoint> equityCurve_;
+    PerformanceAccumulator performance_;
+    std::vector<RollingPerformance> rolling_;
+    std::vector<std::vector<RollingPoint>> rollingSeries_;
+    QuantileSketch returnSketch_;
+    QuantileSketch tradeSketch_;
+    size_t tradesSketched_ = 0;
+    const std::map<std::string, Bar>* currentBars_ = nullptr;
+    IndicatorGraph ownIndicators_;
+    IndicatorGraph* indicators_ = &ownIndicators_;
+    bool ownsIndicators_ = true;
+    EngineStats stats_;
+
+    size_t nextBar_ = 0;    // Data cursor, next bar to process
+    bool resumed_ = false;  // Set by loadCheckpoint, skips the warm-up
+    BinaryWriter checkpointBuffer_;
+
+    // Checkpoint journal this engine appends to, and how much of each log is in it
+    struct JournalMarks {
+        uint64_t equity = 0;
+        std::vector<uint64_t> rolling = {};
+        uint64_t orders = 0;
+        uint64_t trades = 0;
+    };
+    void appendJournal(const std::string& path);
+    JournalMarks currentMarks() const;
+
+    std::string journalPath_;
+    uint64_t journalId_ = 0;     // Random, written first in the journal and in each snapshot
+    uint64_t journalBytes_ = 0;  // Journal length after the last snapshot
+    JournalMarks journaled_;
+    BinaryWriter journalBuffer_;
+    std::deque<std::string> checkpointsWritten_;  // By this run, oldest first, for pruning
+};
+
+using BacktestEngine = BasicBacktestEngine<Strategy>;
+
+// Instantiated once in engine.cpp
+extern template class BasicBacktestEngine<Strategy>;
+
+// ============================================================================
+// Implementation
+// ============================================================================
+
+namespace detail {
+inline constexpr uint32_t kCheckpointMagic = 0x4B435442;  // "BTCK"
+inline constexpr uint32_t kCheckpointVersion = 9;
+
+// Wall-clock timing of the engines' stats
+using Clock = std::chrono::steady_clock;
+inline double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+}  // namespace detail
+
+template <StaticStrategy S, AnyPortfolio P>
+BasicBacktestEngine<S, P>::BasicBacktestEngine(const DataHandler& data, S& strategy,
+                                               P& portfolio, const EngineConfig& config)
+    : data_(data),
+      strategy_(strategy),
+      portfolio_(portfolio),
+      config_(config),
+      queue_(config.eventCapacity) {
+    fills_.reserve(64);
+    orderBatch_.reserve(64);
+    results_.reserve(64);
+    for (const RollingWindow& window : config_.rollingWindows) rolling_.emplace_back(window);
+    rollingSeries_.resize(rolling_.size());
+    if (config_.quantileSketchK != 0) {
+        returnSketch_ = tradeSketch_ = QuantileSketch(config_.quantileSketchK);
+    }
+}
+
+template <StaticStrategy S, AnyPortfolio P>
+const EngineStats& BasicBacktestEngine<S, P>::run() {
+    auto start = std::chrono::steady_clock::now();
+    size_t numBars = data_.size();
+
+    // -------------------------------------------------
+    // Strategy warm-up, skipped when resuming from a checkpoint
+    // -------------------------------------------------
+    if (!resumed_) {
+        size_t warmup = std::min(config_.warmupBars, numBars);
+
+        std::vector<std::map<std::string, Bar>> history;
+        history.reserve(warmup);
+        for (size_t i = 0; i < warmup; ++i) {
+            history.push_back(data_.getBarsAt(i));
+        }
+        warmUp(history);
+    }
+    resumed_ = false;
+
+    // -------------------------------------------------
+    // Main loop, one MARKET event per bar
+    // -------------------------------------------------
+    while (nextBar_ < numBars) {
+        processBar(nextBar_);
+    }
+
+    finish();  // Final liquidation
+
+    auto end = std::chrono::steady_clock::now();
+    stats_.elapsedSeconds = std::chrono::duration<double>(end - start).count();
+    return stats_;
+}
+
+template <StaticStrategy S, AnyPortfolio P>
+void BasicBacktestEngine<S, P>::warmUp(const std::vector<std::map<std::string, Bar>>& history) {
+    if constexpr (requires { strategy_.onInit(history, *indicators_); }) {
+        strategy_.onInit(history, *indicators_);
+    } else {
+        strategy_.onInit(history);
+    }
+    if (ownsIndicators_ && !indicators_->empty()) {
+        indicators_->warmUp(history);
+    }
+
+    equityCurve_.clear();
+    if (config_.keepEquityCurve) {
+        equityCurve_.reserve(data_.size() - history.size() + 1);
+    }
+    performance_ = {};
+    if (config_.quantileSketchK != 0) {
+        returnSketch_ = tradeSketch_ = QuantileSketch(config_.quantileSketchK);
+        tradesSketched_ = portfolio_.getTrades().size();
+    }
+    for (size_t w = 0; w < rolling_.size(); ++w) {
+        rolling_[w] = RollingPerformance(config_.rollingWindows[w]);
+        rollingSeries_[w].clear();
+        rollingSeries_[w].reserve(data_.size() - history.size() + 1);
+    }
+    nextBar_ = history.size();
+}
+
+template <StaticStrategy S, AnyPortfolio P>
+void BasicBacktestEngine<S, P>::processBar(size_t index) {
+    nextBar_ = index + 1;
+    currentBars_ = &data_.getBarsAt(index);
+    if (ownsIndicators_ && !indicators_->empty()) {
+        indicators_->update(*currentBars_);
+    }
+
+    push(MarketEvent{currentBars_});
+    drain();
+
+    recordEquity();
+    ++stats_.bars;
+
+    if (config_.checkpointEvery != 0 && stats_.bars % config_.checkpointEvery == 0) {
+        checkpointsWritten_.push_back(checkpointPath(index));
+        saveCheckpoint(checkpointsWritten_.back());
+        while (config_.checkpointKeep != 0 &&
+               checkpointsWritten_.size() > config_.checkpointKeep) {
+            std::filesystem::remove(checkpointsWritten_.front());
+            checkpointsWritten_.pop_front();
+        }
+    }
+}
+
+template <StaticStrategy S, AnyPortfolio P>
+void BasicBacktestEngine<S, P>::finish() {
+    if (currentBars_ != nullptr) {
+        portfolio_.closeAllPositions(*currentBars_);
+        recordEquity();
+    }
+}
+
+template <StaticStrategy S, AnyPortfolio P>
+void BasicBacktestEngine<S, P>::recordEquity() {
+    EquityPoint point{currentBars_->begin()->second.time,
+                      portfolio_.getTotalEquity(*currentBars_)};
+    if (config_.quantileSketchK != 0) {
+        if (performance_.size() != 0) {
+            returnSketch_.add(std::log(point.equity / performance_.lastEquity()));
+        }
+        for (const Trade& trade : portfolio_.getTrades(tradesSketched_)) {
+            tradeSketch_.add(trade.pnl);
+            ++tradesSketched_;
+        }
+    }
+    performance_.add(point);
+    if (config_.keepEquityCurve) equityCurve_.push_back(point);
+    for (size_t w = 0; w < rolling_.size(); ++w) {
+        RollingPerformance& window = rolling_[w];
+        window.add(point.equity);
+        rollingSeries_[w].push_back({point.time, window.annualizedVolatility(),
+                                     window.sharpeRatio(), window.drawdown()});
+    }
+}
+
+template <StaticStrategy S, AnyPortfolio P>
+const std::vector<EquityPoint>& BasicBacktestEngine<S, P>::getEquityCurve() const {
+    return equityCurve_;
+}
+
+template <StaticStrategy S, AnyPortfolio P>
+const EngineStats& BasicBacktestEngine<S, P>::getStats() const {
+    return stats_;
+}
+
+// -------------------------------------------------
+// Checkpoints
+// -------------------------------------------------
+
+template <StaticStrategy S, AnyPortfolio P>
+void BasicBacktestEngine<S, P>::saveCheckpoint(const std::string& path) {
+    BinaryWriter& writer = checkpointBuffer_;
+    writer.clear();
+
+    writer.write(detail::kCheckpointMagic);
+    writer.write(detail::kCheckpointVersion);
+
+    // Cursor, plus enough of the data to notice a different file on resume
+    writer.write<uint64_t>(data_.size());
+    writer.write<uint64_t>(nextBar_);
+    writer.write<int64_t>(currentBars_ ? currentBars_->begin()->second.time : 0);
+
+    writer.write(stats_.bars);
+    writer.write(stats_.events);
+    writer.write(stats_.eventsByType);
+    appendJournal((std::filesystem::path(path).parent_path() / "checkpoint_journal.bin").string());
+    writer.write(journalId_);
+    writer.write(journalBytes_);
+    writer.write(performance_);
+    if (config_.quantileSketchK != 0) {
+        returnSketch_.saveState(writer);
+        tradeSketch_.saveState(writer);
+        writer.write<uint64_t>(tradesSketched_);
+    }
+    writer.write<uint64_t>(rolling_.size());
+    for (size_t w = 0; w < rolling_.size(); ++w) {
+        rolling_[w].saveState(writer);
+    }
+
+    ownIndicators_.saveState(writer);
+    portfolio_.saveState(writer, false);
+    strategy_.saveState(writer);
+
+    writer.saveToFile(path);
+}
+
+template <StaticStrategy S, AnyPortfolio P>
+typename BasicBacktestEngine<S, P>::JournalMarks BasicBacktestEngine<S, P>::currentMarks() const {
+    JournalMarks marks{.equity = equityCurve_.size(),
+                       .orders = portfolio_.getOrderCount(),
+                       .trades = portfolio_.getTrades().size()};
+    for (const std::vector<RollingPoint>& series : rollingSeries_) {
+        marks.rolling.push_back(series.size());
+    }
+    return marks;
+}
+
+// Appends the logs' growth since the last snapshot; a journal new to this engine is
+// started over from the beginning of the logs
+template <StaticStrategy S, AnyPortfolio P>
+void BasicBacktestEngine<S, P>::appendJournal(const std::string& path) {
+    BinaryWriter& writer = journalBuffer_;
+    if (path != journalPath_) {
+        std::random_device entropy;
+        journalId_ = (uint64_t{entropy()} << 32) ^ entropy();
+        journalPath_ = path;
+        journaled_ = {.rolling = std::vector<uint64_t>(rollingSeries_.size(), 0)};
+        writer.clear();
+        writer.write(journalId_);
+        writer.saveToFile(path);
+        journalBytes_ = writer.size();
+    } else if (std::filesystem::file_size(path) != journalBytes_) {
+        // Resumed: drop what the original run appended after our snapshot
+        std::filesystem::resize_file(path, journalBytes_);
+    }
+
+    writer.clear();
+    writer.write(std::span<const EquityPoint>(equityCurve_).subspan(journaled_.equity));
+    for (size_t w = 0; w < rollingSeries_.size(); ++w) {
+        std::span<const RollingPoint> series(rollingSeries_[w]);
+        writer.write(series.subspan(journaled_.rolling[w]));
+    }
+    portfolio_.saveJournals(writer, journaled_.orders, journaled_.trades);
+    writer.appendToFile(path);
+    journalBytes_ += writer.size();
+    journaled_ = currentMarks();
+}
+
+template <StaticStrategy S, AnyPortfolio P>
+void BasicBacktestEngine<S, P>::loadCheckpoint(const std::string& path) {
+    BinaryReader reader = BinaryReader::fromFile(path);
+
+    if (reader.read<uint32_t>() != detail::kCheckpointMagic) {
+        throw std::runtime_error(path + " is not a checkpoint");
+    }
+    if (reader.read<uint32_t>() != detail::kCheckpointVersion) {
+        throw std::runtime_error(path + " has an unsupported checkpoint version");
+    }
+
+    uint64_t numBars = reader.read<uint64_t>();
+    size_t nextBar = reader.read<uint64_t>();
+    int64_t lastTime = reader.read<int64_t>();
+    if (numBars != data_.size() || nextBar == 0 || nextBar > data_.size() ||
+        data_.getBarsAt(nextBar - 1).begin()->second.time != lastTime) {
+        throw std::runtime_error(path + " was written for a different data set");
+    }
+
+    reader.read(stats_.bars);
+    reader.read(stats_.events);
+    reader.read(stats_.eventsByType);
+    uint64_t journalId = reader.read<uint64_t>();
+    uint64_t journalBytes = reader.read<uint64_t>();
+    reader.read(performance_);
+    if (config_.quantileSketchK != 0) {
+        returnSketch_.loadState(reader);
+        tradeSketch_.loadState(reader);
+        tradesSketched_ = reader.read<uint64_t>();
+    }
+    if (reader.read<uint64_t>() != rolling_.size()) {
+        throw std::runtime_error(path + " was written with other rolling windows");
+    }
+    for (size_t w = 0; w < rolling_.size(); ++w) {
+        rolling_[w].loadState(reader);
+    }
+
+    ownIndicators_.loadState(reader);
+    portfolio_.loadState(reader, false);
+    if constexpr (requires { strategy_.loadState(reader, *indicators_); }) {
+        strategy_.loadState(reader, *indicators_);
+    } else {
+        strategy_.loadState(reader);
+    }
+    if (!reader.atEnd()) {
+        throw std::runtime_error(path + " has trailing data");
+    }
+
+    // The logs up to this snapshot
+    std::string journalPath =
+        (std::filesystem::path(path).parent_path() / "checkpoint_journal.bin").string();
+    BinaryReader journal = BinaryReader::fromFile(journalPath, journalBytes);
+    if (journal.read<uint64_t>() != journalId) {
+        throw std::runtime_error(journalPath + " belongs to another run than " + path);
+    }
+    equityCurve_.clear();
+    for (std::vector<RollingPoint>& series : rollingSeries_) series.clear();
+    while (!journal.atEnd()) {
+        journal.readAppend(equityCurve_);
+        for (std::vector<RollingPoint>& series : rollingSeries_) journal.readAppend(series);
+        portfolio_.loadJournals(journal);
+    }
+    if (config_.keepEquityCurve) {
+        equityCurve_.reserve(data_.size() - nextBar + equityCurve_.size() + 1);
+    }
+    for (std::vector<RollingPoint>& series : rollingSeries_) {
+        series.reserve(data_.size() - nextBar + series.size() + 1);
+    }
+    journalPath_ = journalPath;
+    journalId_ = journalId;
+    journalBytes_ = journalBytes;
+    journaled_ = currentMarks();
+
+    nextBar_ = nextBar;
+    currentBars_ = &data_.getBarsAt(nextBar - 1);
+    resumed_ = true;
+}
+
+template <StaticStrategy S, AnyPortfolio P>
+std::string BasicBacktestEngine<S, P>::checkpointPath(size_t barIndex) const {
+    return (std::filesystem::path(config_.checkpointDir) /
+            ("checkpoint_" + std::to_string(barIndex) + ".bin"))
+        .string();
+}
+
+template <StaticStrategy S, AnyPortfolio P>
+std::optional<std::string> BasicBacktestEngine<S, P>::findCheckpoint(const std::string& dir,
+                                                                     size_t barIndex) {
+    std::optional<std::string> best;
+    size_t bestIndex = 0;
+
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator(dir, ec)) {
+        std::string name = entry.path().filename().string();
+        if (!name.starts_with("checkpoint_") || !name.ends_with(".bin")) {
+            continue;
+        }
+
+        std::string digits = name.substr(11, name.size() - 15);
+        if (digits.empty() || !std::all_of(digits.begin(), digits.end(), ::isdigit)) {
+            continue;
+        }
+
+        size_t index = std::stoull(digits);
+        if (index <= barIndex && (!best || index > bestIndex)) {
+            best = entry.path().string();
+            bestIndex = index;
+        }
+    }
+    return best;
+}
+
+// -------------------------------------------------
+// Event loop
+// -------------------------------------------------
+
+template <StaticStrategy S, AnyPortfolio P>
+void BasicBacktestEngine<S, P>::push(Event event) {
+    queue_.push_back(std::move(event));
+}
+
+template <StaticStrategy S, AnyPortfolio P>
+void BasicBacktestEngine<S, P>::drain() {
+    for (;;) {
+        while (!queue_.empty()) {
+            Event event = std::move(queue_.front());
+            queue_.pop_front();
+
+            ++stats_.events;
+            ++stats_.eventsByType[static_cast<size_t>(getEventType(event))];
+
+            std::visit([this](const auto& e) { handle(e); }, event);
+        }
+
+        if (!signalBatch_.empty()) {
+            flushSignals();
+        } else if (!orderBatch_.empty()) {
+            flushOrders();
+        } else {
+            break;
+        }
+    }
+}
+
+template <StaticStrategy S, AnyPortfolio P>
+void BasicBacktestEngine<S, P>::flushSignals() {
+    std::map<std::string, Position>& positions = portfolio_.getCurrentPositions();
+    if constexpr (requires {
+                      strategy_.generateOrders(signalBatch_, *currentBars_, config_.maxInvest,
+                                               positions, orderBatch_);
+                  }) {
+        strategy_.generateOrders(signalBatch_, *currentBars_, config_.maxInvest, positions,
+                                 orderBatch_);
+    } else {
+        generateOrdersFromMap(strategy_, signalBatch_, *currentBars_, config_.maxInvest,
+                              positions, orderBatch_);
+    }
+    signalBatch_.clear();
+    std::erase_if(orderBatch_, [](const Order& order) { return order.quantity == 0; });
+
+    for (const Order& order : orderBatch_) {
+        push(OrderEvent{order});
+    }
+    // With latency the orders are submitted one by one as their events are handled
+    if (portfolio_.hasLatency()) {
+        orderBatch_.clear();
+    }
+}
+
+template <StaticStrategy S, AnyPortfolio P>
+void BasicBacktestEngine<S, P>::flushOrders() {
+    results_.resize(orderBatch_.size());
+    fills_.clear();
+    portfolio_.executeOrders(orderBatch_, results_, &fills_, currentBars_);
+    orderBatch_.clear();
+
+    for (const Order& fill : fills_) {
+        push(FillEvent{fill});
+    }
+}
+
+template <StaticStrategy S, AnyPortfolio P>
+void BasicBacktestEngine<S, P>::handle(const MarketEvent& event) {
+    portfolio_.markToMarket(*event.bars);
+
+    // Orders delayed by the latency model fill on the first bar after they arrive
+    fills_.clear();
+    portfolio_.processPendingOrders(*event.bars, &fills_);
+    for (const Order& fill : fills_) {
+        push(FillEvent{fill});
+    }
+
+    signals_.clear();
+    strategy_.onBars(*event.bars, portfolio_.getCurrentPositions(), signals_);
+    signals_.forEach([this](const Signal& signal) { push(SignalEvent{signal}); });
+}
+
+template <StaticStrategy S, AnyPortfolio P>
+void BasicBacktestEngine<S, P>::handle(const SignalEvent& event) {
+    signalBatch_.set(event.signal);
+}
+
+template <StaticStrategy S, AnyPortfolio P>
+void BasicBacktestEngine<S, P>::handle(const OrderEvent& event) {
+    const Order& order = event.order;
+
+    if (config_.logOrders) {
+        std::cout << "Order at bar " << stats_.bars << ": "
+                  << (order.direction == SignalType::BUY ? "BUY " : "SELL ") << order.quantity
+                  << " @ " << order.price << std::endl;
+        std::cout << "INFO | Unrealized PnL : " << portfolio_.getUnrealizedPnL(*currentBars_)
+                  << " | Realized PnL : " << portfolio_.getRealizedPnL() << std::endl;
+    }
+
+    // Without latency the whole bar's orders are already in orderBatch_, executed as one batch
+    if (!portfolio_.hasLatency()) {
+        return;
+    }
+
+    fills_.clear();
+    portfolio_.submitOrder(order, false, &fills_, currentBars_->at(order.symbol).volume);
+    for (const Order& fill : fills_) {
+        push(FillEvent{fill});
+    }
+}
+
+template <StaticStrategy S, AnyPortfolio P>
+void BasicBacktestEngine<S, P>::handle(const FillEvent& event) {
+    if constexpr (requires { strategy_.onFill(event.fill); }) {
+        strategy_.onFill(event.fill);
+    }
+    if (!config_.logOrders) {
+        return;
+    }
+
+    auto it = portfolio_.getCurrentPositions().find(event.fill.symbol);
+    std::cout << "INFO | Filled " << event.fill.quantity << " " << event.fill.symbol << " @ "
+              << event.fill.price << std::endl;
+    std::cout << "INFO | Total Equity After: " << std::setprecision(7)
+              << portfolio_.getTotalEquity(*currentBars_) << std::endl;
+    std::cout << "INFO | Total Positions After: "
+              << (it != portfolio_.getCurrentPositions().end() ? it->second.quantity : 0)
+              << std::endl;
+    std::cout << "----------------------------------------------" << std::endl;
+}
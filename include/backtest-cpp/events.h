@@ -0,0 +1,36 @@
+#pragma once
+
+#include <map>
+#include <string>
+#include <variant>
+
+#include "backtest-cpp/types.h"
+
+// Event payloads for the BacktestEngine queue. Each payload knows its EventType so
+// handlers and statistics can be keyed by the enum without a virtual call.
+
+struct MarketEvent {
+    static constexpr EventType type = EventType::MARKET;
+    const std::map<std::string, Bar>* bars;  // Owned by the DataHandler
+};
+
+struct SignalEvent {
+    static constexpr EventType type = EventType::SIGNAL;
+    Signal signal;
+};
+
+struct OrderEvent {
+    static constexpr EventType type = EventType::ORDER;
+    Order order;
+};
+
+struct FillEvent {
+    static constexpr EventType type = EventType::FILL;
+    Order fill;  // Executed quantity and price
+};
+
+using Event = std::variant<MarketEvent, SignalEvent, OrderEvent, FillEvent>;
+
+inline EventType getEventType(const Event& event) {
+    return std::visit([](const auto& e) { return e.type; }, event);
+}
@@ -0,0 +1,319 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+#include "backtest-cpp/indicators.h"
+#include "backtest-cpp/serialization.h"
+#include "backtest-cpp/symbol_table.h"
+#include "backtest-cpp/types.h"
+
+enum class PriceField : uint8_t { OPEN, HIGH, LOW, CLOSE, VOLUME };
+
+// PRICE nodes are the graph's inputs, every other kind is computed from one input node
+enum class IndicatorKind : uint8_t { PRICE, SMA, EMA, WMA, STDDEV, RSI, MIN, MAX };
+
+// Read-only reference to a node of an IndicatorGraph, read through the graph's accessors.
+// Only the graph hands them out; a handle stays valid for the graph's lifetime and across
+// saveState/loadState, and copying the graph keeps it valid for the copy.
+class IndicatorHandle {
+   public:
+    IndicatorHandle() = default;
+
+    uint32_t node() const { return node_; }
+    bool valid() const { return node_ != UINT32_MAX; }
+    bool operator==(const IndicatorHandle&) const = default;
+
+   private:
+    friend class IndicatorGraph;
+    explicit IndicatorHandle(uint32_t node) : node_(node) {}
+
+    uint32_t node_ = UINT32_MAX;
+};
+
+// Indicators shared by every strategy of a run. Strategies declare what they need in onInit
+// and identical requests (same kind, period and input) get the same node, so an SMA(30) of
+// the closes used by five strategies is computed once per bar. Nodes form a DAG over the
+// price fields; a node's input always exists before it, so creation order is a topological
+// order and update() evaluates the nodes in it, each for every symbol at once, into a flat
+// buffer with one row per node and one column per symbol id. A symbol missing from a bar is
+// carried forward at its last price; a new one starts with empty windows.
+class IndicatorGraph {
+   public:
+    IndicatorHandle price(PriceField field) {
+        return node(IndicatorKind::PRICE, static_cast<size_t>(field), UINT32_MAX);
+    }
+
+    IndicatorHandle add(IndicatorKind kind, size_t period, IndicatorHandle input) {
+        if (kind == IndicatorKind::PRICE) throw std::invalid_argument("Use price() for inputs");
+        if (input.node_ >= nodes_.size()) throw std::invalid_argument("Unknown input node");
+        detail::checkPeriod(period);
+        return node(kind, period, input.node_);
+    }
+
+    IndicatorHandle sma(size_t period, PriceField field = PriceField::CLOSE) {
+        return add(IndicatorKind::SMA, period, price(field));
+    }
+
+    // Nodes added after warm-up start empty, like a symbol first seen mid-run
+    void warmUp(const std::vector<std::map<std::string, Bar>>& history) {
+        for (const auto& bars : history) update(bars);
+    }
+
+    // Advances every node by one bar; the values of the bar before move to previous()
+    void update(const std::map<std::string, Bar>& bars) {
+        // Bars usually carry the same symbols as the previous one, then the ids are reused
+        // without hashing
+        bool sameSymbols = bars.size() == barIds_.size();
+        size_t i = 0;
+        for (const auto& [symbol, bar] : bars) {
+            sameSymbols = sameSymbols && symbols_.name(barIds_[i]) == symbol;
+            if (!sameSymbols) {
+                barIds_.resize(i);
+                barIds_.push_back(symbols_.intern(symbol));
+            }
+            ++i;
+        }
+        if (symbols_.size() != numSymbols_) resize(symbols_.size());
+
+        previous_ = values_;
+        for (uint32_t n = 0; n < nodes_.size(); ++n) {
+            if (nodes_[n].kind == IndicatorKind::PRICE) {
+                setPrices(n, bars);
+            } else {
+                evaluate(n);
+            }
+        }
+    }
+
+    double value(IndicatorHandle h, uint32_t symbol) const {
+        return values_[h.node_ * numSymbols_ + symbol];
+    }
+    // Value after the bar before the last update
+    double previous(IndicatorHandle h, uint32_t symbol) const {
+        return previous_[h.node_ * numSymbols_ + symbol];
+    }
+    bool ready(IndicatorHandle h, uint32_t symbol) const {
+        return ready_[h.node_ * numSymbols_ + symbol];
+    }
+    std::span<const double> values(IndicatorHandle h) const {
+        return {values_.data() + h.node_ * numSymbols_, numSymbols_};
+    }
+
+    const SymbolTable& symbols() const { return symbols_; }
+    // Symbol ids of the last updated bar, in the bar's order
+    std::span<const uint32_t> barSymbols() const { return barIds_; }
+
+    size_t numNodes() const { return nodes_.size(); }
+    size_t numSymbols() const { return numSymbols_; }
+    bool empty() const { return nodes_.empty(); }
+
+    // Writes the nodes too, so loadState rebuilds the graph and re-declaring the same
+    // indicators afterwards returns the handles they had
+    void saveState(BinaryWriter& writer) const {
+        writer.write<uint64_t>(nodes_.size());
+        for (const Node& n : nodes_) {
+            writer.write(n.kind);
+            writer.write<uint64_t>(n.period);
+            writer.write(n.input);
+            std::visit(
+                [&](const auto& state) {
+                    using T = std::decay_t<decltype(state)>;
+                    if constexpr (std::is_same_v<T, SMABank>) {
+                        state.saveState(writer);
+                    } else if constexpr (!std::is_same_v<T, std::monostate>) {
+                        writer.write<uint64_t>(state.size());
+                        for (const auto& indicator : state) indicator.saveState(writer);
+                    }
+                },
+                n.state);
+        }
+        symbols_.saveState(writer);
+        writer.write(barIds_);
+        writer.write(values_);
+        writer.write(previous_);
+        writer.write(ready_);
+    }
+
+    void loadState(BinaryReader& reader) {
+        *this = IndicatorGraph();
+        size_t numNodes = reader.readSize();
+        for (size_t n = 0; n < numNodes; ++n) {
+            auto kind = reader.read<IndicatorKind>();
+            size_t period = reader.read<uint64_t>();
+            auto input = reader.read<uint32_t>();
+            if (kind != IndicatorKind::PRICE && input >= nodes_.size()) {
+                throw std::runtime_error("Indicator graph state is not topologically ordered");
+            }
+            node(kind, period, input);
+            std::visit(
+                [&](auto& state) {
+                    using T = std::decay_t<decltype(state)>;
+                    if constexpr (std::is_same_v<T, SMABank>) {
+                        state.loadState(reader);
+                    } else if constexpr (!std::is_same_v<T, std::monostate>) {
+                        state.resize(reader.readSize(), typename T::value_type(period));
+                        for (auto& indicator : state) indicator.loadState(reader);
+                    }
+                },
+                nodes_.back().state);
+        }
+        symbols_.loadState(reader);
+        numSymbols_ = symbols_.size();
+        reader.read(barIds_);
+        reader.read(values_);
+        reader.read(previous_);
+        reader.read(ready_);
+        if (values_.size() != nodes_.size() * numSymbols_ || previous_.size() != values_.size() ||
+            ready_.size() != values_.size()) {
+            throw std::runtime_error("Indicator graph state does not match its nodes");
+        }
+    }
+
+   private:
+    using State = std::variant<std::monostate, SMABank, std::vector<EMA>, std::vector<WMA>,
+                               std::vector<RollingStdDev>, std::vector<RSI>,
+                               std::vector<RollingMin>, std::vector<RollingMax>>;
+
+    struct Node {
+        IndicatorKind kind;
+        size_t period;   // PRICE: the PriceField
+        uint32_t input;  // PRICE: unused
+        State state;
+    };
+
+    static State makeState(IndicatorKind kind, size_t period) {
+        switch (kind) {
+            case IndicatorKind::PRICE:
+                return std::monostate{};
+            case IndicatorKind::SMA:
+                return SMABank(period);
+            case IndicatorKind::EMA:
+                return std::vector<EMA>();
+            case IndicatorKind::WMA:
+                return std::vector<WMA>();
+            case IndicatorKind::STDDEV:
+                return std::vector<RollingStdDev>();
+            case IndicatorKind::RSI:
+                return std::vector<RSI>();
+            case IndicatorKind::MIN:
+                return std::vector<RollingMin>();
+            case IndicatorKind::MAX:
+                return std::vector<RollingMax>();
+        }
+        throw std::invalid_argument("Unknown indicator kind");
+    }
+
+    // Existing node for the request, or a new one with an empty row
+    IndicatorHandle node(IndicatorKind kind, size_t period, uint32_t input) {
+        auto [it, inserted] = index_.try_emplace(std::make_tuple(kind, period, input),
+                                                 static_cast<uint32_t>(nodes_.size()));
+        if (!inserted) return IndicatorHandle(it->second);
+
+        nodes_.push_back({kind, period, input, makeState(kind, period)});
+        resizeState(nodes_.back());
+        values_.resize(nodes_.size() * numSymbols_, 0.0);
+        previous_.resize(values_.size(), 0.0);
+        ready_.resize(values_.size(), 0);
+        return IndicatorHandle(it->second);
+    }
+
+    void resizeState(Node& n) {
+        std::visit(
+            [&](auto& state) {
+                using T = std::decay_t<decltype(state)>;
+                if constexpr (std::is_same_v<T, SMABank>) {
+                    state.resize(numSymbols_);
+                } else if constexpr (!std::is_same_v<T, std::monostate>) {
+                    state.resize(numSymbols_, typename T::value_type(n.period));
+                }
+            },
+            n.state);
+    }
+
+    // Relays out the buffer for a new symbol count, so keep it out of the per-bar path
+    void resize(size_t numSymbols) {
+        auto relayout = [&](auto& buffer) {
+            std::remove_reference_t<decltype(buffer)> resized(nodes_.size() * numSymbols);
+            for (size_t n = 0; n < nodes_.size(); ++n) {
+                for (size_t s = 0; s < numSymbols_; ++s) {
+                    resized[n * numSymbols + s] = buffer[n * numSymbols_ + s];
+                }
+            }
+            buffer = std::move(resized);
+        };
+        relayout(values_);
+        relayout(previous_);
+        relayout(ready_);
+        numSymbols_ = numSymbols;
+        for (Node& n : nodes_) resizeState(n);
+    }
+
+    void setPrices(uint32_t n, const std::map<std::string, Bar>& bars) {
+        double* row = values_.data() + n * numSymbols_;
+        uint8_t* ready = ready_.data() + n * numSymbols_;
+        size_t i = 0;
+        for (const auto& [symbol, bar] : bars) {
+            uint32_t id = barIds_[i++];
+            row[id] = field(bar, static_cast<PriceField>(nodes_[n].period));
+            ready[id] = 1;
+        }
+    }
+
+    static double field(const Bar& bar, PriceField field) {
+        switch (field) {
+            case PriceField::OPEN:
+                return bar.open;
+            case PriceField::HIGH:
+                return bar.high;
+            case PriceField::LOW:
+                return bar.low;
+            case PriceField::CLOSE:
+                return bar.close;
+            case PriceField::VOLUME:
+                return static_cast<double>(bar.volume);
+        }
+        return bar.close;
+    }
+
+    void evaluate(uint32_t n) {
+        Node& node = nodes_[n];
+        std::span<const double> in = values(IndicatorHandle(node.input));
+        double* out = values_.data() + n * numSymbols_;
+        uint8_t* ready = ready_.data() + n * numSymbols_;
+        std::visit(
+            [&](auto& state) {
+                using T = std::decay_t<decltype(state)>;
+                if constexpr (std::is_same_v<T, SMABank>) {
+                    state.updateAll(in);
+                    for (size_t s = 0; s < numSymbols_; ++s) {
+                        out[s] = state.value(s);
+                        ready[s] = state.ready(s);
+                    }
+                } else if constexpr (!std::is_same_v<T, std::monostate>) {
+                    for (size_t s = 0; s < numSymbols_; ++s) {
+                        out[s] = state[s].update(in[s]);
+                        ready[s] = state[s].ready();
+                    }
+                }
+            },
+            node.state);
+    }
+
+    std::vector<Node> nodes_;
+    std::map<std::tuple<IndicatorKind, size_t, uint32_t>, uint32_t> index_;  // Dedup
+
+    SymbolTable symbols_;
+    size_t numSymbols_ = 0;
+    std::vector<uint32_t> barIds_;   // Ids of the symbols in the last bar
+    std::vector<double> values_;     // [node * numSymbols + symbol]
+    std::vector<double> previous_;   // values_ before the last update
+    std::vector<uint8_t> ready_;
+};
@@ -0,0 +1,635 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include "backtest-cpp/ring_buffer.h"
+#include "backtest-cpp/serialization.h"
+#include "backtest-cpp/types.h"
+
+// Incremental indicators. Every update is O(1) (amortized for the rolling extremes), all
+// storage is allocated in the constructor and running sums are compensated, so values
+// don't drift over millions of bars. Before ready() an indicator reports what it has seen
+// so far. saveState/loadState let strategies include them in checkpoints.
+
+namespace detail {
+// One step of Neumaier's variant of Kahan summation: also exact when the added term is
+// larger than the running sum, which happens on every subtraction of a rolling window.
+// Both terms are computed up front so the select needs no branch and loops vectorize.
+inline void compensatedAdd(double& sum, double& compensation, double x) {
+    double t = sum + x;
+    double sumLarger = (sum - t) + x;
+    double xLarger = (x - t) + sum;
+    compensation += std::abs(sum) >= std::abs(x) ? sumLarger : xLarger;
+    sum = t;
+}
+}  // namespace detail
+
+class KahanSum {
+   public:
+    void add(double x) { detail::compensatedAdd(sum_, compensation_, x); }
+
+    double value() const { return sum_ + compensation_; }
+    void reset() { *this = {}; }
+
+   private:
+    double sum_ = 0.0;
+    double compensation_ = 0.0;
+};
+
+namespace detail {
+inline size_t checkPeriod(size_t period) {
+    if (period == 0) throw std::invalid_argument("Indicator period must be > 0");
+    return period;
+}
+
+template <typename T>
+void writeRing(BinaryWriter& writer, const RingBuffer<T>& ring) {
+    writer.write<uint64_t>(ring.size());
+    for (size_t i = 0; i < ring.size(); ++i) writer.write(ring[i]);
+}
+
+template <typename T>
+void readRing(BinaryReader& reader, RingBuffer<T>& ring) {
+    size_t size = reader.readSize();
+    if (size > ring.capacity()) throw std::runtime_error("Indicator window too large");
+    ring.clear();
+    for (size_t i = 0; i < size; ++i) ring.push_back(reader.read<T>());
+}
+}  // namespace detail
+
+// Simple moving average
+class SMA {
+   public:
+    explicit SMA(size_t period) : period_(detail::checkPeriod(period)), window_(period) {}
+
+    double update(double x) {
+        if (window_.size() == period_) {
+            sum_.add(-window_.front());
+            window_.pop_front();
+        }
+        window_.push_back(x);
+        sum_.add(x);
+        return value();
+    }
+
+    double value() const { return window_.empty() ? 0.0 : sum_.value() / window_.size(); }
+    bool ready() const { return window_.size() == period_; }
+    size_t period() const { return period_; }
+
+    void reset() {
+        window_.clear();
+        sum_.reset();
+    }
+
+    void saveState(BinaryWriter& writer) const {
+        detail::writeRing(writer, window_);
+        writer.write(sum_);
+    }
+    void loadState(BinaryReader& reader) {
+        detail::readRing(reader, window_);
+        reader.read(sum_);
+    }
+
+   private:
+    size_t period_;
+    RingBuffer<double> window_;
+    KahanSum sum_;
+};
+
+namespace detail {
+// One SMABank step. __restrict tells the compiler the arrays don't overlap, which it can't
+// prove for this many streams and would otherwise not vectorize.
+inline void smaBankStep(const double* __restrict in, double* __restrict slot,
+                        double* __restrict sum, double* __restrict compensation,
+                        double* __restrict count, double* __restrict mean, double period,
+                        size_t n) {
+    for (size_t s = 0; s < n; ++s) {
+        double x = in[s];
+        double out = slot[s];
+        slot[s] = x;
+        compensatedAdd(sum[s], compensation[s], x);
+        compensatedAdd(sum[s], compensation[s], -out);
+        count[s] = std::min(count[s] + 1.0, period);
+        mean[s] = (sum[s] + compensation[s]) / count[s];
+    }
+}
+}  // namespace detail
+
+// SMAs of one period for many symbols, advanced together on a common clock and stored
+// structure-of-arrays: window slot k of every symbol is contiguous, so updateAll walks
+// each array with unit stride and the loop vectorizes. A symbol added with resize() starts
+// with an empty window; its zero-filled slots drop out as it fills.
+class SMABank {
+   public:
+    explicit SMABank(size_t period, size_t numSymbols = 0) : period_(detail::checkPeriod(period)) {
+        resize(numSymbols);
+    }
+
+    // Reallocates and relays out the windows, so keep it out of the per-bar path
+    void resize(size_t numSymbols) {
+        if (numSymbols == numSymbols_) return;
+
+        std::vector<double> window(numSymbols * period_, 0.0);
+        size_t kept = std::min(numSymbols, numSymbols_);
+        for (size_t slot = 0; slot < period_; ++slot) {
+            for (size_t s = 0; s < kept; ++s) {
+                window[slot * numSymbols + s] = window_[slot * numSymbols_ + s];
+            }
+        }
+        window_ = std::move(window);
+        sum_.resize(numSymbols, 0.0);
+        compensation_.resize(numSymbols, 0.0);
+        count_.resize(numSymbols, 0.0);
+        mean_.resize(numSymbols, 0.0);
+        numSymbols_ = numSymbols;
+    }
+
+    // values[s] is the next value of symbol s, values.size() == numSymbols()
+    void updateAll(std::span<const double> values) {
+        detail::smaBankStep(values.data(), window_.data() + head_ * numSymbols_, sum_.data(),
+                            compensation_.data(), count_.data(), mean_.data(),
+                            static_cast<double>(period_), numSymbols_);
+        head_ = head_ + 1 == period_ ? 0 : head_ + 1;
+    }
+
+    double value(size_t symbol) const { return mean_[symbol]; }
+    std::span<const double> values() const { return mean_; }
+    bool ready(size_t symbol) const { return count_[symbol] == static_cast<double>(period_); }
+    size_t period() const { return period_; }
+    size_t numSymbols() const { return numSymbols_; }
+
+    void saveState(BinaryWriter& writer) const {
+        writer.write<uint64_t>(numSymbols_);
+        writer.write<uint64_t>(head_);
+        writer.write(window_);
+        writer.write(sum_);
+        writer.write(compensation_);
+        writer.write(count_);
+        writer.write(mean_);
+    }
+    void loadState(BinaryReader& reader) {
+        numSymbols_ = reader.read<uint64_t>();
+        head_ = reader.read<uint64_t>();
+        reader.read(window_);
+        reader.read(sum_);
+        reader.read(compensation_);
+        reader.read(count_);
+        reader.read(mean_);
+        if (window_.size() != numSymbols_ * period_ || head_ >= period_) {
+            throw std::runtime_error("SMABank state does not match its period");
+        }
+    }
+
+   private:
+    size_t period_;
+    size_t numSymbols_ = 0;
+    size_t head_ = 0;             // Window slot the next update overwrites
+    std::vector<double> window_;  // [slot * numSymbols + symbol]
+    std::vector<double> sum_;
+    std::vector<double> compensation_;
+    std::vector<double> count_;  // Values in the window, as double to keep the loop uniform
+    std::vector<double> mean_;
+};
+
+// Exponential moving average with alpha = 2 / (period + 1), seeded with the SMA of the
+// first `period` values
+class EMA {
+   public:
+    explicit EMA(size_t period)
+        : period_(detail::checkPeriod(period)), alpha_(2.0 / (static_cast<double>(period) + 1)) {}
+
+    double update(double x) {
+        if (count_ < period_) {
+            seed_.add(x);
+            value_ = seed_.value() / static_cast<double>(++count_);
+        } else {
+            value_ += alpha_ * (x - value_);
+        }
+        return value_;
+    }
+
+    double value() const { return value_; }
+    bool ready() const { return count_ >= period_; }
+    size_t period() const { return period_; }
+
+    void reset() {
+        seed_.reset();
+        value_ = 0.0;
+        count_ = 0;
+    }
+
+    void saveState(BinaryWriter& writer) const {
+        writer.write(seed_);
+        writer.write(value_);
+        writer.write<uint64_t>(count_);
+    }
+    void loadState(BinaryReader& reader) {
+        reader.read(seed_);
+        reader.read(value_);
+        count_ = reader.read<uint64_t>();
+    }
+
+   private:
+    size_t period_;
+    double alpha_;
+    KahanSum seed_;
+    double value_ = 0.0;
+    size_t count_ = 0;
+};
+
+// Linearly weighted moving average, newest value has weight `period`. The weighted sum is
+// updated from the plain window sum: N' = N + n * x - S.
+class WMA {
+   public:
+    explicit WMA(size_t period) : period_(detail::checkPeriod(period)), window_(period) {}
+
+    double update(double x) {
+        if (window_.size() == period_) {
+            weighted_.add(static_cast<double>(period_) * x - sum_.value());
+            sum_.add(-window_.front());
+            window_.pop_front();
+        } else {
+            weighted_.add(static_cast<double>(window_.size() + 1) * x);
+        }
+        window_.push_back(x);
+        sum_.add(x);
+        return value();
+    }
+
+    double value() const {
+        double n = static_cast<double>(window_.size());
+        return window_.empty() ? 0.0 : weighted_.value() / (n * (n + 1) / 2);
+    }
+    bool ready() const { return window_.size() == period_; }
+    size_t period() const { return period_; }
+
+    void reset() {
+        window_.clear();
+        sum_.reset();
+        weighted_.reset();
+    }
+
+    void saveState(BinaryWriter& writer) const {
+        detail::writeRing(writer, window_);
+        writer.write(sum_);
+        writer.write(weighted_);
+    }
+    void loadState(BinaryReader& reader) {
+        detail::readRing(reader, window_);
+        reader.read(sum_);
+        reader.read(weighted_);
+    }
+
+   private:
+    size_t period_;
+    RingBuffer<double> window_;
+    KahanSum sum_;
+    KahanSum weighted_;
+};
+
+// Rolling mean and population standard deviation. The sum of squared deviations uses the
+// sliding-window Welford update M2' = M2 + (x - out) * (x - mean' + out - mean).
+class RollingStdDev {
+   public:
+    explicit RollingStdDev(size_t period)
+        : period_(detail::checkPeriod(period)), window_(period) {}
+
+    double update(double x) {
+        double oldMean = mean();
+        if (window_.size() == period_) {
+            double out = window_.front();
+            window_.pop_front();
+            window_.push_back(x);
+            sum_.add(x);
+            sum_.add(-out);
+            m2_.add((x - out) * (x - mean() + out - oldMean));
+        } else {
+            window_.push_back(x);
+            sum_.add(x);
+            m2_.add((x - oldMean) * (x - mean()));
+        }
+        return stddev();
+    }
+
+    double mean() const { return window_.empty() ? 0.0 : sum_.value() / window_.size(); }
+    double variance() const {
+        return window_.empty() ? 0.0 : std::max(m2_.value(), 0.0) / window_.size();
+    }
+    double stddev() const { return std::sqrt(variance()); }
+    double value() const { return stddev(); }
+    bool ready() const { return window_.size() == period_; }
+    size_t period() const { return period_; }
+
+    void reset() {
+        window_.clear();
+        sum_.reset();
+        m2_.reset();
+    }
+
+    void saveState(BinaryWriter& writer) const {
+        detail::writeRing(writer, window_);
+        writer.write(sum_);
+        writer.write(m2_);
+    }
+    void loadState(BinaryReader& reader) {
+        detail::readRing(reader, window_);
+        reader.read(sum_);
+        reader.read(m2_);
+    }
+
+   private:
+    size_t period_;
+    RingBuffer<double> window_;
+    KahanSum sum_;
+    KahanSum m2_;
+};
+
+// Distance of the latest value from the rolling mean in standard deviations (0 while flat)
+class ZScore {
+   public:
+    explicit ZScore(size_t period) : stats_(period) {}
+
+    double update(double x) {
+        stats_.update(x);
+        double sd = stats_.stddev();
+        value_ = sd > 0.0 ? (x - stats_.mean()) / sd : 0.0;
+        return value_;
+    }
+
+    double value() const { return value_; }
+    bool ready() const { return stats_.ready(); }
+    size_t period() const { return stats_.period(); }
+
+    void reset() {
+        stats_.reset();
+        value_ = 0.0;
+    }
+
+    void saveState(BinaryWriter& writer) const {
+        stats_.saveState(writer);
+        writer.write(value_);
+    }
+    void loadState(BinaryReader& reader) {
+        stats_.loadState(reader);
+        reader.read(value_);
+    }
+
+   private:
+    RollingStdDev stats_;
+    double value_ = 0.0;
+};
+
+// Wilder's relative strength index, 0-100. The first average is the mean of the first
+// `period` changes, later ones are smoothed with weight 1 / period.
+class RSI {
+   public:
+    explicit RSI(size_t period) : period_(detail::checkPeriod(period)) {}
+
+    double update(double x) {
+        if (count_ == 0) {
+            prev_ = x;
+            ++count_;
+            return value();
+        }
+
+        double change = x - prev_;
+        double gain = change > 0.0 ? change : 0.0;
+        double loss = change < 0.0 ? -change : 0.0;
+        prev_ = x;
+
+        double n = static_cast<double>(period_);
+        if (count_ <= period_) {
+            gainSum_.add(gain);
+            lossSum_.add(loss);
+            avgGain_ = gainSum_.value() / static_cast<double>(count_);
+            avgLoss_ = lossSum_.value() / static_cast<double>(count_);
+        } else {
+            avgGain_ = (avgGain_ * (n - 1) + gain) / n;
+            avgLoss_ = (avgLoss_ * (n - 1) + loss) / n;
+        }
+        ++count_;
+        return value();
+    }
+
+    double value() const {
+        if (avgLoss_ == 0.0) return avgGain_ == 0.0 ? 50.0 : 100.0;
+        return 100.0 - 100.0 / (1.0 + avgGain_ / avgLoss_);
+    }
+    bool ready() const { return count_ > period_; }
+    size_t period() const { return period_; }
+
+    void reset() { *this = RSI(period_); }
+
+    void saveState(BinaryWriter& writer) const {
+        writer.write(prev_);
+        writer.write(avgGain_);
+        writer.write(avgLoss_);
+        writer.write(gainSum_);
+        writer.write(lossSum_);
+        writer.write<uint64_t>(count_);
+    }
+    void loadState(BinaryReader& reader) {
+        reader.read(prev_);
+        reader.read(avgGain_);
+        reader.read(avgLoss_);
+        reader.read(gainSum_);
+        reader.read(lossSum_);
+        count_ = reader.read<uint64_t>();
+    }
+
+   private:
+    size_t period_;
+    double prev_ = 0.0;
+    double avgGain_ = 0.0;
+    double avgLoss_ = 0.0;
+    KahanSum gainSum_;  // Seed sums over the first `period` changes
+    KahanSum lossSum_;
+    size_t count_ = 0;  // Values seen
+};
+
+// Wilder's average true range
+class ATR {
+   public:
+    explicit ATR(size_t period) : period_(detail::checkPeriod(period)) {}
+
+    double update(double high, double low, double close) {
+        double range = high - low;
+        if (count_ > 0) {
+            range = std::max({range, std::abs(high - prevClose_), std::abs(low - prevClose_)});
+        }
+        prevClose_ = close;
+        ++count_;
+
+        if (count_ <= period_) {
+            seed_.add(range);
+            value_ = seed_.value() / static_cast<double>(count_);
+        } else {
+            double n = static_cast<double>(period_);
+            value_ = (value_ * (n - 1) + range) / n;
+        }
+        return value_;
+    }
+    double update(const Bar& bar) { return update(bar.high, bar.low, bar.close); }
+
+    double value() const { return value_; }
+    bool ready() const { return count_ >= period_; }
+    size_t period() const { return period_; }
+
+    void reset() { *this = ATR(period_); }
+
+    void saveState(BinaryWriter& writer) const {
+        writer.write(prevClose_);
+        writer.write(value_);
+        writer.write(seed_);
+        writer.write<uint64_t>(count_);
+    }
+    void loadState(BinaryReader& reader) {
+        reader.read(prevClose_);
+        reader.read(value_);
+        reader.read(seed_);
+        count_ = reader.read<uint64_t>();
+    }
+
+   private:
+    size_t period_;
+    double prevClose_ = 0.0;
+    double value_ = 0.0;
+    KahanSum seed_;
+    size_t count_ = 0;
+};
+
+// Rolling minimum or maximum over a monotonic deque of (sequence, value). Each value is
+// pushed and popped at most once, so updates are amortized O(1).
+template <typename Compare>
+class RollingExtreme {
+   public:
+    explicit RollingExtreme(size_t period)
+        : period_(detail::checkPeriod(period)), candidates_(period) {}
+
+    double update(double x) {
+        // The oldest candidate leaves the window when x arrives
+        if (!candidates_.empty() && candidates_.front().sequence + period_ <= count_) {
+            candidates_.pop_front();
+        }
+        // Drop candidates that can no longer be the extreme
+        while (!candidates_.empty() && !Compare{}(candidates_.back().value, x)) {
+            candidates_.pop_back();
+        }
+        candidates_.push_back({count_, x});
+        ++count_;
+        return value();
+    }
+
+    double value() const { return candidates_.empty() ? 0.0 : candidates_.front().value; }
+    bool ready() const { return count_ >= period_; }
+    size_t period() const { return period_; }
+
+    void reset() {
+        candidates_.clear();
+        count_ = 0;
+    }
+
+    void saveState(BinaryWriter& writer) const {
+        detail::writeRing(writer, candidates_);
+        writer.write<uint64_t>(count_);
+    }
+    void loadState(BinaryReader& reader) {
+        detail::readRing(reader, candidates_);
+        count_ = reader.read<uint64_t>();
+    }
+
+   private:
+    struct Candidate {
+        uint64_t sequence;
+        double value;
+    };
+
+    size_t period_;
+    RingBuffer<Candidate> candidates_;  // Front is the current extreme
+    uint64_t count_ = 0;
+};
+
+struct StrictlyLess {
+    bool operator()(double a, double b) const { return a < b; }
+};
+struct StrictlyGreater {
+    bool operator()(double a, double b) const { return a > b; }
+};
+
+using RollingMin = RollingExtreme<StrictlyLess>;
+using RollingMax = RollingExtreme<StrictlyGreater>;
+
+// Volume-weighted average price over the last `period` bars, or since the last reset()
+// with period 0 (session VWAP). Bars are priced at their typical price (H + L + C) / 3.
+class VWAP {
+   public:
+    explicit VWAP(size_t period = 0) : period_(period), window_(period) {}
+
+    double update(double price, double volume) {
+        if (period_ != 0) {
+            if (window_.size() == period_) {
+                notional_.add(-window_.front().notional);
+                volume_.add(-window_.front().volume);
+                window_.pop_front();
+            }
+            window_.push_back({price * volume, volume});
+        }
+        notional_.add(price * volume);
+        volume_.add(volume);
+        lastPrice_ = price;
+        ++count_;
+        return value();
+    }
+    double update(const Bar& bar) {
+        return update((bar.high + bar.low + bar.close) / 3.0, static_cast<double>(bar.volume));
+    }
+
+    // Last price while no volume has traded
+    double value() const {
+        double volume = volume_.value();
+        return volume > 0.0 ? notional_.value() / volume : lastPrice_;
+    }
+    bool ready() const { return period_ == 0 ? count_ > 0 : window_.size() == period_; }
+    size_t period() const { return period_; }
+
+    void reset() {
+        window_.clear();
+        notional_.reset();
+        volume_.reset();
+        lastPrice_ = 0.0;
+        count_ = 0;
+    }
+
+    void saveState(BinaryWriter& writer) const {
+        detail::writeRing(writer, window_);
+        writer.write(notional_);
+        writer.write(volume_);
+        writer.write(lastPrice_);
+        writer.write<uint64_t>(count_);
+    }
+    void loadState(BinaryReader& reader) {
+        detail::readRing(reader, window_);
+        reader.read(notional_);
+        reader.read(volume_);
+        reader.read(lastPrice_);
+        count_ = reader.read<uint64_t>();
+    }
+
+   private:
+    struct Entry {
+        double notional;  // price * volume
+        double volume;
+    };
+
+    size_t period_;
+    RingBuffer<Entry> window_;
+    KahanSum notional_;
+    KahanSum volume_;
+    double lastPrice_ = 0.0;
+    size_t count_ = 0;
+};
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <random>
+#include <string>
+
+#include "backtest-cpp/serialization.h"
+
+enum class LatencyType {
+    FIXED,    // Always the base delay
+    UNIFORM,  // Base delay + U[0, jitter]
+    NORMAL    // Base delay + N(0, jitter), clamped at zero
+};
+
+struct LatencyConfig {
+    LatencyType type = LatencyType::FIXED;
+    int64_t delayNs = 0;                              // Base signal-to-exchange delay
+    int64_t jitterNs = 0;                             // Spread of the distribution
+    std::map<std::string, int64_t> perSymbolNs = {};  // Overrides delayNs for single symbols
+    uint64_t seed = 42;                               // Fixed seed keeps runs reproducible
+};
+
+class LatencyModel {
+   public:
+    LatencyModel() = default;
+    explicit LatencyModel(const LatencyConfig& config);
+
+    // Delay in nanoseconds for an order on `symbol`
+    int64_t sample(const std::string& symbol);
+
+    // True if every order would arrive at its signal time
+    bool isZero() const;
+
+    // Generator state only; the config is expected to match on load
+    void saveState(BinaryWriter& writer) const;
+    void loadState(BinaryReader& reader);
+
+   private:
+    LatencyConfig config_;
+    std::mt19937_64 rng_;
+};
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <vector>
+
+#include "backtest-cpp/performance.h"
+#include "backtest-cpp/random.h"
+#include "backtest-cpp/types.h"
+
+struct MonteCarloConfig {
+    size_t samples = 10'000;
+    uint64_t seed = 42;  // Sample i draws from Philox stream i of this seed
+    size_t threads = 0;  // 0 = one per hardware thread
+    double confidence = 0.95;
+    Frequency frequency = Frequency::MINUTE;  // Of the equity curves' points
+    size_t blockLength = 20;                  // Returns per block of blockBootstrap
+    double tickSize = 0.25;                   // For jitterFills
+    double slippageTicks = 1.0;               // Max adverse slippage per fill, in ticks
+};
+
+// Metrics of one resampled path, as Performance computes them, plus max drawdown as a
+// fraction of the running peak. A path that reaches zero equity gets a Sharpe of -inf.
+struct SampleStats {
+    double sharpe = 0.0;
+    double maxDrawdown = 0.0;
+    double finalEquity = 0.0;
+};
+
+// Percentile interval with the median
+struct Interval {
+    double lower = 0.0;
+    double median = 0.0;
+    double upper = 0.0;
+};
+
+struct MonteCarloResult {
+    std::vector<SampleStats> samples;  // samples[i] came from stream i
+    Interval sharpe;
+    Interval maxDrawdown;
+    Interval finalEquity;
+};
+
+// Robustness of a backtest under resampling. Samples run in chunks on a ThreadPool and each
+// draws only from its own counter-based stream, so a result is the same for any thread count.
+// The trade-based methods rebuild equity from initialCash one trade at a time, annualized
+// as `periods` bars of the configured frequency (the backtest's curve.size() - 1).
+class MonteCarlo {
+   public:
+    explicit MonteCarlo(const MonteCarloConfig& config = {});
+
+    // The trades in random order: same final equity, different paths
+    MonteCarloResult shuffleTrades(std::span<const Trade> trades, double initialCash,
+                                   size_t periods) const;
+
+    // As many trades drawn with replacement
+    MonteCarloResult bootstrapTrades(std::span<const Trade> trades, double initialCash,
+                                     size_t periods) const;
+
+    // Each trade worse by a uniform 0..slippageTicks on both its entry and exit fill
+    MonteCarloResult jitterFills(std::span<const Trade> trades, double initialCash,
+                                 size_t periods) const;
+
+    // Circular blocks of the curve's log returns, so volatility clusters stay together
+    MonteCarloResult blockBootstrap(const std::vector<EquityPoint>& curve) const;
+
+    // Full reruns: `backtest` runs with jitter drawn from the stream it is handed and
+    // returns its equity curve. It is called from several threads at once.
+    MonteCarloResult rerun(
+        const std::function<std::vector<EquityPoint>(Philox& rng)>& backtest) const;
+
+   private:
+    // Calls sample(rng, path) with stream i for every sample i and summarizes the paths
+    using Sampler = std::function<void(Philox&, std::vector<double>&)>;
+    MonteCarloResult run(const Sampler& sample, double periodsPerYear) const;
+
+    MonteCarloConfig config_;
+};
@@ -0,0 +1,158 @@
+#pragma once
+
+#include <algorithm>
+#include <concepts>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "backtest-cpp/data.h"
+#include "backtest-cpp/engine.h"
+#include "backtest-cpp/indicator_graph.h"
+#include "backtest-cpp/performance.h"
+#include "backtest-cpp/portfolio.h"
+#include "backtest-cpp/strategy.h"
+
+struct StrategyAllocation {
+    std::string name = {};
+    PortfolioConfig portfolio;  // initialCash is the capital allocated to the strategy
+    double maxInvest = 10'000;  // Passed to its generateOrder
+};
+
+// Runs a book of strategies over one pass of the data. Each registered strategy trades its
+// own sub-Portfolio through its own BacktestEngine, exactly as a standalone run would, but
+// the warm-up history is built once and every bar's cross-section is handed to all engines
+// in turn, so the data is loaded and walked once for the whole book. All engines share one
+// IndicatorGraph, so an indicator several strategies declare is computed once per bar.
+// The sub-portfolios are of type P, Portfolio by default.
+template <AnyPortfolio P = Portfolio>
+class BasicMultiStrategyEngine {
+   public:
+    using Commission = typename P::CommissionType;
+    using Slippage = typename P::SlippageType;
+
+    // `config` applies to every strategy; checkpoints are not supported and turned off
+    explicit BasicMultiStrategyEngine(const DataHandler& data, const EngineConfig& config = {});
+
+    // Returns the strategy's index. The strategy must outlive the engine. Without cost
+    // models the sub-portfolio is built from allocation.portfolio alone, as P(config) is.
+    size_t addStrategy(Strategy& strategy, const StrategyAllocation& allocation)
+        requires std::constructible_from<Commission, double> &&
+                 std::default_initializable<Slippage>
+    {
+        return addStrategy(strategy, allocation, Commission(allocation.portfolio.commission),
+                           Slippage{});
+    }
+    size_t addStrategy(Strategy& strategy, const StrategyAllocation& allocation,
+                       Commission commission, Slippage slippage = {});
+
+    void run();
+
+    size_t size() const { return books_.size(); }
+    const std::string& name(size_t index) const { return books_[index].name; }
+    const P& getPortfolio(size_t index) const { return *books_[index].portfolio; }
+    const std::vector<EquityPoint>& getEquityCurve(size_t index) const;
+    const EngineStats& getStats(size_t index) const;
+
+    // Sum of all strategies' equity at every point of their curves
+    const std::vector<EquityPoint>& getAggregateEquityCurve() const { return aggregate_; }
+
+    const IndicatorGraph& getIndicators() const { return indicators_; }
+
+   private:
+    struct Book {
+        std::string name = {};
+        std::unique_ptr<P> portfolio = {};  // Stable addresses for the engine's references
+        std::unique_ptr<BasicBacktestEngine<Strategy, P>> engine = {};
+    };
+
+    const DataHandler& data_;
+    EngineConfig config_;
+    std::vector<Book> books_;
+    IndicatorGraph indicators_;
+    std::vector<EquityPoint> aggregate_;
+};
+
+using MultiStrategyEngine = BasicMultiStrategyEngine<>;
+
+// Instantiated once in multi_engine.cpp
+extern template class BasicMultiStrategyEngine<Portfolio>;
+
+// ============================================================================
+// Implementation
+// ============================================================================
+
+template <AnyPortfolio P>
+BasicMultiStrategyEngine<P>::BasicMultiStrategyEngine(const DataHandler& data,
+                                                      const EngineConfig& config)
+    : data_(data), config_(config) {
+    config_.checkpointEvery = 0;
+}
+
+template <AnyPortfolio P>
+size_t BasicMultiStrategyEngine<P>::addStrategy(Strategy& strategy,
+                                                const StrategyAllocation& allocation,
+                                                Commission commission, Slippage slippage) {
+    EngineConfig engineConfig = config_;
+    engineConfig.maxInvest = allocation.maxInvest;
+
+    Book book{.name = allocation.name,
+              .portfolio = std::make_unique<P>(allocation.portfolio, std::move(commission),
+                                               std::move(slippage))};
+    book.engine = std::make_unique<BasicBacktestEngine<Strategy, P>>(
+        data_, strategy, *book.portfolio, engineConfig);
+    book.engine->shareIndicators(indicators_);
+    books_.push_back(std::move(book));
+    return books_.size() - 1;
+}
+
+template <AnyPortfolio P>
+void BasicMultiStrategyEngine<P>::run() {
+    const size_t numBars = data_.size();
+    const size_t warmup = std::min(config_.warmupBars, numBars);
+
+    std::vector<std::map<std::string, Bar>> history;
+    history.reserve(warmup);
+    for (size_t i = 0; i < warmup; ++i) {
+        history.push_back(data_.getBarsAt(i));
+    }
+    for (Book& book : books_) {
+        book.engine->warmUp(history);
+    }
+    indicators_.warmUp(history);  // Every strategy has declared its indicators by now
+
+    // Bar-major: each cross-section is touched once while it is hot, then every strategy
+    // reacts to it before the next bar is read
+    for (size_t index = warmup; index < numBars; ++index) {
+        if (!indicators_.empty()) {
+            indicators_.update(data_.getBarsAt(index));
+        }
+        for (Book& book : books_) {
+            book.engine->processBar(index);
+        }
+    }
+    for (Book& book : books_) {
+        book.engine->finish();
+    }
+
+    // Every curve has one point per bar after the warm-up plus the liquidation point
+    aggregate_.clear();
+    if (books_.empty()) return;
+    aggregate_ = books_.front().engine->getEquityCurve();
+    for (size_t b = 1; b < books_.size(); ++b) {
+        const std::vector<EquityPoint>& curve = books_[b].engine->getEquityCurve();
+        for (size_t i = 0; i < aggregate_.size(); ++i) {
+            aggregate_[i].equity += curve[i].equity;
+        }
+    }
+}
+
+template <AnyPortfolio P>
+const std::vector<EquityPoint>& BasicMultiStrategyEngine<P>::getEquityCurve(size_t index) const {
+    return books_[index].engine->getEquityCurve();
+}
+
+template <AnyPortfolio P>
+const EngineStats& BasicMultiStrategyEngine<P>::getStats(size_t index) const {
+    return books_[index].engine->getStats();
+}
@@ -0,0 +1,274 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "backtest-cpp/data.h"
+#include "backtest-cpp/engine.h"
+#include "backtest-cpp/performance.h"
+#include "backtest-cpp/portfolio.h"
+#include "backtest-cpp/strategy.h"
+#include "backtest-cpp/thread_pool.h"
+
+// Builds one strategy instance per partition; called concurrently from the workers
+using StrategyFactory = std::function<std::unique_ptr<Strategy>()>;
+
+struct PartitionConfig {
+    PortfolioConfig portfolio;  // initialCash is the whole account, split by symbol count
+    EngineConfig engine;        // Order logging and checkpoints are turned off
+    size_t partitions = 64;     // Sub-accounts, at most one per symbol; 0 = one per symbol
+    size_t threads = 0;         // 0 = one per hardware thread
+};
+
+struct PartitionStats {
+    EngineStats engine = {};     // Summed over the partitions
+    size_t partitions = 0;
+    size_t threads = 0;
+    double busySeconds = 0.0;    // Sum of the partitions' run times
+    double elapsedSeconds = 0.0;
+
+    // Share of the workers' time spent running partitions: 1 means the threads never
+    // waited for work, below that load imbalance or the serial reduction cost throughput
+    double efficiency() const {
+        return elapsedSeconds > 0.0 ? busySeconds / (elapsedSeconds * threads) : 0.0;
+    }
+};
+
+// Backtests strategies that trade every symbol independently, split by symbol across a
+// ThreadPool. The sorted symbols are cut into contiguous partitions, and each partition is
+// an independent sub-account: its own strategy instance, Portfolio and BacktestEngine over
+// a copy of just its symbols' bars (split off in one serial pass), with a share of the
+// capital proportional to its number of symbols. Partitions share nothing mutable while
+// they run, and the aggregate equity curve is reduced afterwards in partition order, so
+// results are bit-identical for any thread count; the partition count is fixed by the
+// config, not the threads, and should be a few times the cores for the work-stealing pool
+// to balance uneven symbols. Each sub-account only sees its own cash, so cash-constrained
+// strategies can trade differently than in one shared account. With a single partition
+// this is a plain BacktestEngine run. The sub-accounts are of type P, Portfolio by default,
+// and every one is built with the cost models given to the constructor.
+template <AnyPortfolio P = Portfolio>
+class BasicPartitionedEngine {
+   public:
+    using Commission = typename P::CommissionType;
+    using Slippage = typename P::SlippageType;
+
+    BasicPartitionedEngine(const DataHandler& data, StrategyFactory factory,
+                           const PartitionConfig& config)
+        requires std::constructible_from<Commission, double> &&
+                 std::default_initializable<Slippage>
+        : BasicPartitionedEngine(data, std::move(factory), config,
+                                 Commission(config.portfolio.commission), Slippage{}) {}
+
+    BasicPartitionedEngine(const DataHandler& data, StrategyFactory factory,
+                           const PartitionConfig& config, Commission commission,
+                           Slippage slippage = {});
+
+    // Rethrows the first exception a partition threw
+    const PartitionStats& run();
+
+    size_t size() const { return partitions_.size(); }
+    const std::vector<std::string>& getSymbols(size_t index) const;
+    const P& getPortfolio(size_t index) const;
+    const std::vector<EquityPoint>& getEquityCurve(size_t index) const;
+
+    // Sum of the sub-accounts' equity, aligned on the last bar. Synchronized data
+    // forward-fills every symbol from its first bar on, so a partition's curve is a suffix of
+    // the full timeline and before it starts the partition contributes its initial capital.
+    const std::vector<EquityPoint>& getAggregateEquityCurve() const { return aggregate_; }
+
+    size_t getTradeCount() const;
+    double getRealizedPnL() const;
+    // Every partition's trade PnL merged in partition order, if config.engine.quantileSketchK
+    // is set
+    const QuantileSketch& getTradeSketch() const { return tradeSketch_; }
+    const PartitionStats& getStats() const { return stats_; }
+
+   private:
+    struct Partition {
+        std::vector<std::string> symbols;
+        double initialCash = 0.0;
+        DataHandler data;  // Released once the partition has run
+        std::unique_ptr<P> portfolio;
+        std::vector<EquityPoint> equityCurve;
+        QuantileSketch tradeSketch;
+        EngineStats stats;
+        double seconds = 0.0;
+    };
+
+    void runPartition(Partition& partition) const;
+    void reduce();
+
+    const DataHandler& data_;
+    StrategyFactory factory_;
+    PartitionConfig config_;
+    Commission commission_;
+    Slippage slippage_;
+    std::vector<Partition> partitions_;
+    std::vector<EquityPoint> aggregate_;
+    QuantileSketch tradeSketch_;
+    PartitionStats stats_;
+};
+
+using PartitionedEngine = BasicPartitionedEngine<>;
+
+// Instantiated once in partitioned_engine.cpp
+extern template class BasicPartitionedEngine<Portfolio>;
+
+// ============================================================================
+// Implementation
+// ============================================================================
+
+template <AnyPortfolio P>
+BasicPartitionedEngine<P>::BasicPartitionedEngine(const DataHandler& data,
+                                                  StrategyFactory factory,
+                                                  const PartitionConfig& config,
+                                                  Commission commission, Slippage slippage)
+    : data_(data),
+      factory_(std::move(factory)),
+      config_(config),
+      commission_(std::move(commission)),
+      slippage_(std::move(slippage)) {
+    if (!factory_) {
+        throw std::invalid_argument("PartitionedEngine needs a strategy factory");
+    }
+    silenceLogs(config_.engine, config_.portfolio);
+    config_.engine.checkpointEvery = 0;
+
+    std::vector<std::string> symbols = data_.symbols();
+    size_t count = config_.partitions == 0 ? symbols.size()
+                                           : std::min(config_.partitions, symbols.size());
+    partitions_.resize(count);
+    for (size_t p = 0; p < count; ++p) {
+        Partition& partition = partitions_[p];
+        auto begin = symbols.begin() + p * symbols.size() / count;
+        auto end = symbols.begin() + (p + 1) * symbols.size() / count;
+        partition.symbols.assign(begin, end);
+        partition.initialCash = config_.portfolio.initialCash *
+                                static_cast<double>(partition.symbols.size()) / symbols.size();
+    }
+}
+
+template <AnyPortfolio P>
+const PartitionStats& BasicPartitionedEngine<P>::run() {
+    auto start = detail::Clock::now();
+
+    std::vector<std::vector<std::string>> groups;
+    for (const Partition& partition : partitions_) groups.push_back(partition.symbols);
+    std::vector<DataHandler> parts = data_.split(groups);
+    for (size_t p = 0; p < partitions_.size(); ++p) {
+        partitions_[p].data = std::move(parts[p]);
+    }
+
+    ThreadPool pool(config_.threads);
+    for (Partition& partition : partitions_) {
+        // Every task writes its own partition, so nothing needs a lock
+        pool.submit([this, &partition] { runPartition(partition); });
+    }
+    pool.wait();
+
+    reduce();
+
+    stats_ = {.partitions = partitions_.size(), .threads = pool.size()};
+    for (const Partition& partition : partitions_) {
+        stats_.engine.bars += partition.stats.bars;
+        stats_.engine.events += partition.stats.events;
+        for (size_t t = 0; t < stats_.engine.eventsByType.size(); ++t) {
+            stats_.engine.eventsByType[t] += partition.stats.eventsByType[t];
+        }
+        stats_.busySeconds += partition.seconds;
+    }
+    stats_.elapsedSeconds = stats_.engine.elapsedSeconds = detail::secondsSince(start);
+    return stats_;
+}
+
+template <AnyPortfolio P>
+void BasicPartitionedEngine<P>::runPartition(Partition& partition) const {
+    auto start = detail::Clock::now();
+
+    std::unique_ptr<Strategy> strategy = factory_();
+
+    PortfolioConfig portfolio = config_.portfolio;
+    portfolio.initialCash = partition.initialCash;
+    partition.portfolio = std::make_unique<P>(portfolio, commission_, slippage_);
+
+    BasicBacktestEngine<Strategy, P> engine(partition.data, *strategy, *partition.portfolio,
+                                            config_.engine);
+    partition.stats = engine.run();
+    partition.equityCurve = engine.getEquityCurve();
+    partition.tradeSketch = engine.getTradeSketch();
+    partition.data = {};
+
+    partition.seconds = detail::secondsSince(start);
+}
+
+template <AnyPortfolio P>
+void BasicPartitionedEngine<P>::reduce() {
+    if (config_.engine.quantileSketchK != 0) {
+        tradeSketch_ = QuantileSketch(config_.engine.quantileSketchK);
+        for (const Partition& partition : partitions_) tradeSketch_.merge(partition.tradeSketch);
+    }
+
+    aggregate_.clear();
+    const Partition* longest = nullptr;
+    for (const Partition& partition : partitions_) {
+        if (!longest || partition.equityCurve.size() > longest->equityCurve.size()) {
+            longest = &partition;
+        }
+    }
+    if (longest == nullptr) return;
+
+    // Summed in partition order from 0.0, so one partition reproduces its curve exactly
+    aggregate_ = longest->equityCurve;
+    for (EquityPoint& point : aggregate_) point.equity = 0.0;
+    for (const Partition& partition : partitions_) {
+        size_t offset = aggregate_.size() - partition.equityCurve.size();
+        for (size_t i = 0; i < aggregate_.size(); ++i) {
+            aggregate_[i].equity +=
+                i < offset ? partition.initialCash : partition.equityCurve[i - offset].equity;
+        }
+    }
+}
+
+template <AnyPortfolio P>
+const std::vector<std::string>& BasicPartitionedEngine<P>::getSymbols(size_t index) const {
+    return partitions_.at(index).symbols;
+}
+
+template <AnyPortfolio P>
+const P& BasicPartitionedEngine<P>::getPortfolio(size_t index) const {
+    const Partition& partition = partitions_.at(index);
+    if (!partition.portfolio) {
+        throw std::logic_error("PartitionedEngine::run() has not been called");
+    }
+    return *partition.portfolio;
+}
+
+template <AnyPortfolio P>
+const std::vector<EquityPoint>& BasicPartitionedEngine<P>::getEquityCurve(size_t index) const {
+    return partitions_.at(index).equityCurve;
+}
+
+template <AnyPortfolio P>
+size_t BasicPartitionedEngine<P>::getTradeCount() const {
+    size_t trades = 0;
+    for (const Partition& partition : partitions_) {
+        if (partition.portfolio) trades += partition.portfolio->getTradeStats().trades;
+    }
+    return trades;
+}
+
+template <AnyPortfolio P>
+double BasicPartitionedEngine<P>::getRealizedPnL() const {
+    double pnl = 0.0;
+    for (const Partition& partition : partitions_) {
+        if (partition.portfolio) pnl += partition.portfolio->getRealizedPnL();
+    }
+    return pnl;
+}
@@ -1,9 +1,14 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <ctime>
 #include <vector>
 
+#include "backtest-cpp/random.h"
+#include "backtest-cpp/ring_buffer.h"
+#include "backtest-cpp/serialization.h"
+
 struct EquityPoint {
     int64_t time;
     double equity;
@@ -15,6 +20,35 @@ struct Annualization {
     double periodsPerYear;
 };
 
+// Everything Performance reports about a curve. Returns are per-period log returns as for
+// the volatility; drawdowns are fractions of the running peak.
+struct RiskMetrics {
+    double annualizedReturn = 0.0;
+    double annualizedVolatility = 0.0;
+    double sharpe = 0.0;
+    double sortino = 0.0;  // Excess return over the annualized downside deviation (target 0)
+    double calmar = 0.0;   // Annualized return over max drawdown
+    double maxDrawdown = 0.0;
+    size_t maxDrawdownDuration = 0;  // Most consecutive points below an earlier peak
+    double ulcerIndex = 0.0;         // Root mean square of the drawdown over all points
+    double skewness = 0.0;           // Of the returns, 0 when they are constant
+    double excessKurtosis = 0.0;
+    double hitRate = 0.0;  // Fraction of periods with a positive return
+};
+
+// What RiskMetrics is derived from, however it was accumulated: the curve's end points,
+// sums of powers of the returns' deviations from their mean, and the drawdown sums
+struct RiskSums {
+    size_t points;
+    double first, last;
+    double m2, m3, m4;
+    double downside2;  // Sum of squared negative returns
+    size_t gains;
+    double maxDrawdown;
+    double drawdown2;  // Sum of squared drawdowns
+    size_t maxUnderwater;
+};
+
 class Performance {
    public:
     static double annualizedReturn(const std::vector<EquityPoint>& curve, Frequency freq);
@@ -24,6 +58,172 @@ class Performance {
     static double sharpeRatio(const std::vector<EquityPoint>& curve, Frequency freq,
                               double riskFreeRate = 0.0);
 
-   private:
+    // Largest fall from a running peak, as a fraction of that peak
+    static double maxDrawdown(const std::vector<EquityPoint>& curve);
+
+    // All of the above and more in one pass, the same as a PerformanceAccumulator fed the
+    // curve. Ratios with a zero denominator are 0. Needs at least 3 points.
+    static RiskMetrics riskMetrics(const std::vector<EquityPoint>& curve, Frequency freq,
+                                   double riskFreeRate = 0.0);
+    static RiskMetrics riskMetrics(const RiskSums& sums, Frequency freq,
+                                   double riskFreeRate = 0.0);
+
     static Annualization getAnnualization(Frequency freq);
 };
+
+// The metrics of Performance kept up to date one equity point at a time, in O(1) time and
+// space: log returns go through Welford's running moments (extended to the 3rd and 4th as
+// by Terriberry) and drawdowns through a running peak, so no curve or returns vector is
+// stored. Results match the batch functions on the same points to rounding, and
+// can be read at any point of a run. Trivially copyable, so checkpoints store it as is.
+class PerformanceAccumulator {
+   public:
+    void add(double equity);
+    void add(const EquityPoint& point) { add(point.equity); }
+
+    size_t size() const { return count_; }
+    double lastEquity() const { return last_; }
+
+    // Same preconditions and exceptions as the Performance functions
+    double annualizedReturn(Frequency freq) const;
+    double annualizedVolatility(Frequency freq) const;
+    double sharpeRatio(Frequency freq, double riskFreeRate = 0.0) const;
+    double maxDrawdown() const;
+    RiskMetrics riskMetrics(Frequency freq, double riskFreeRate = 0.0) const;
+
+   private:
+    size_t count_ = 0;
+    double first_ = 0.0;
+    double last_ = 0.0;
+
+    double meanReturn_ = 0.0;  // Central moment sums of the log returns
+    double m2_ = 0.0;
+    double m3_ = 0.0;
+    double m4_ = 0.0;
+    double downside2_ = 0.0;  // Sum of squared negative returns
+    size_t gains_ = 0;
+
+    double peak_ = 0.0;
+    double maxDrawdown_ = 0.0;
+    double drawdown2_ = 0.0;  // Sum of squared drawdowns
+    size_t underwater_ = 0;   // Points since the last peak
+    size_t maxUnderwater_ = 0;
+};
+
+// Metrics over a sliding window of the last `bars` returns, one set per point of the curve
+struct RollingWindow {
+    size_t bars;
+    Frequency frequency = Frequency::MINUTE;
+    double riskFreeRate = 0.0;
+};
+
+struct RollingPoint {
+    int64_t time;
+    double volatility;  // Annualized
+    double sharpe;
+    double drawdown;  // Below the highest equity in the window
+};
+
+// Performance's volatility and Sharpe over the last window.bars returns, plus the drawdown
+// from the window's high, updated in O(1) per point instead of recomputed on every slice.
+// Returns sit in a ring with a running sum and sum of squares, shifted for conditioning and
+// re-summed exactly every window.bars updates so removals cannot drift; the high comes from
+// a monotonic deque of the window's equities. Every metric is NaN until the window is full.
+class RollingPerformance {
+   public:
+    // Throws std::invalid_argument for windows of fewer than 2 returns
+    explicit RollingPerformance(const RollingWindow& window);
+
+    void add(double equity);
+
+    bool ready() const { return returns_.size() == window_.bars; }
+    const RollingWindow& window() const { return window_; }
+
+    double annualizedReturn() const;
+    double annualizedVolatility() const;
+    double sharpeRatio() const;
+    double drawdown() const;
+
+    void saveState(BinaryWriter& writer) const;
+    void loadState(BinaryReader& reader);
+
+   private:
+    struct Peak {
+        size_t index;
+        double equity;
+    };
+
+    void renormalize();
+
+    RollingWindow window_;
+    double periodsPerYear_;
+    RingBuffer<double> returns_;   // The window's log returns
+    RingBuffer<double> equities_;  // Its bars + 1 equities
+    RingBuffer<Peak> maxima_;      // Monotonic deque, equities decreasing from the front
+    size_t index_ = 0;             // Of the next equity
+    double shift_ = 0.0;           // Subtracted from returns in the sums
+    double sum_ = 0.0;
+    double sumSquares_ = 0.0;
+    size_t sinceRenormalize_ = 0;
+};
+
+// KLL quantile sketch (Karnin, Lang and Liberty, "Optimal quantile approximation in
+// streams", 2016) for distributions too long to keep, such as every bar's return of a run or
+// every trade of a sweep. Values go into a stack of compactors; a full level is sorted and
+// every other value, from a random offset, moves up a level with twice the weight. Level
+// capacities shrink geometrically downwards from k, so memory stays O(k) plus a slot per
+// level however many values are added, and ranks are off by about 1.7 / k of the count.
+// Sketches with the same k merge into one of the combined stream, so parallel runs and
+// partitions can be sketched separately. Compaction coins come from a seeded Philox stream:
+// the same values, merges and seed give the same sketch.
+class QuantileSketch {
+   public:
+    explicit QuantileSketch(size_t k = 200, uint64_t seed = 0);
+
+    void add(double value);
+    // Throws std::invalid_argument if k differs
+    void merge(const QuantileSketch& other);
+
+    uint64_t count() const { return count_; }
+    size_t retained() const { return retained_; }  // Values stored
+    size_t k() const { return k_; }
+
+    // Throw std::runtime_error while empty
+    double min() const;
+    double max() const;
+    // Smallest stored value whose weighted rank reaches q * count, q in [0, 1]
+    double quantile(double q) const;
+    // Fraction of the values <= value
+    double rank(double value) const;
+    // Mean of the lowest q of the values
+    double tailMean(double q) const;
+
+    // For returns or PnL: the loss not exceeded with `confidence`, and the mean loss beyond it
+    double valueAtRisk(double confidence = 0.95) const { return -quantile(1.0 - confidence); }
+    double conditionalValueAtRisk(double confidence = 0.95) const {
+        return -tailMean(1.0 - confidence);
+    }
+
+    void saveState(BinaryWriter& writer) const;
+    void loadState(BinaryReader& reader);
+
+   private:
+    struct Weighted {
+        double value;
+        uint64_t weight;
+    };
+
+    size_t capacity(size_t level) const;
+    void grow();
+    void compress();
+    std::vector<Weighted> sorted() const;  // Every stored value with its weight, ascending
+
+    size_t k_;
+    std::vector<std::vector<double>> levels_;  // A value at levels_[h] stands for 2^h
+    size_t retained_ = 0;
+    size_t maxRetained_ = 0;  // Sum of the level capacities
+    uint64_t count_ = 0;
+    double min_ = 0.0;
+    double max_ = 0.0;
+    Philox rng_;
+};
@@ -0,0 +1,358 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "backtest-cpp/data.h"
+#include "backtest-cpp/engine.h"
+#include "backtest-cpp/indicator_graph.h"
+#include "backtest-cpp/performance.h"
+#include "backtest-cpp/portfolio.h"
+#include "backtest-cpp/spsc_queue.h"
+#include "backtest-cpp/strategy.h"
+
+struct PipelineConfig {
+    size_t queueCapacity = 1024;             // Bars in flight between two stages
+    std::array<int, 3> cpus = {-1, -1, -1};  // Core per stage (data, strategy, accounting)
+};
+
+struct StageStats {
+    uint64_t items = 0;         // Bars handled
+    double waitSeconds = 0.0;   // Blocked on an empty input or a full output
+    double utilization = 0.0;   // 1 - waitSeconds / elapsed
+};
+
+struct QueueStats {
+    double meanDepth = 0.0;  // Slots in use, sampled at every publish
+    size_t maxDepth = 0;
+    size_t capacity = 0;
+};
+
+struct PipelineStats {
+    EngineStats engine;                 // Same counts as BacktestEngine would report
+    std::array<StageStats, 3> stages;   // Data, strategy, accounting
+    std::array<QueueStats, 2> queues;   // Data -> strategy, strategy -> accounting
+};
+
+// BacktestEngine's loop split into three threads connected by SpscQueues: a data stage
+// walking the bars, a strategy stage updating the IndicatorGraph and calling onBars, and an
+// accounting stage that does everything touching the Portfolio (pending fills,
+// generateOrders, execution, the equity curve). While the accounting stage settles bar t
+// the strategy stage already evaluates bar t + 1, so heavy strategies and large universes
+// overlap with the bookkeeping. Results are identical to BacktestEngine as onBars does not
+// depend on the bars still being settled: it is handed an empty position map, onFill is not
+// called and strategies whose readsPortfolio() is true are rejected. Orders are not logged.
+// Like BasicBacktestEngine it is templated on the portfolio type, Portfolio by default.
+template <AnyPortfolio P = Portfolio>
+class BasicPipelinedEngine {
+   public:
+    // Throws std::invalid_argument for such strategies and for checkpoints, rolling windows
+    // or quantile sketches in `config`, none of which the pipeline records
+    BasicPipelinedEngine(const DataHandler& data, Strategy& strategy, P& portfolio,
+                         const EngineConfig& config = {}, const PipelineConfig& pipeline = {});
+
+    // Runs warm-up on the calling thread, then the three stages until the final liquidation.
+    // An exception in any stage stops all of them and is rethrown here.
+    const PipelineStats& run();
+
+    // Empty unless EngineConfig::keepEquityCurve
+    const std::vector<EquityPoint>& getEquityCurve() const { return equityCurve_; }
+    const PerformanceAccumulator& getPerformance() const { return performance_; }
+    const PipelineStats& getStats() const { return stats_; }
+
+   private:
+    // Strategy -> accounting message, reused in place so its vector keeps its capacity
+    struct SignalBatch {
+        const std::map<std::string, Bar>* bars = nullptr;  // nullptr ends the run
+        std::vector<Signal> signals;
+    };
+
+    void accountBar(const SignalBatch& batch);
+    void recordEquity(const std::map<std::string, Bar>& bars);
+
+    const DataHandler& data_;
+    Strategy& strategy_;
+    P& portfolio_;
+    EngineConfig config_;
+    PipelineConfig pipeline_;
+
+    IndicatorGraph indicators_;
+    std::vector<EquityPoint> equityCurve_;
+    PerformanceAccumulator performance_;
+    PipelineStats stats_;
+
+    // Accounting stage scratch, reused every bar
+    std::map<std::string, Signal> signalBatch_;
+    std::vector<Order> orderBatch_;
+    std::vector<Order> fills_;
+    std::vector<ExecutionResult> results_;
+};
+
+using PipelinedEngine = BasicPipelinedEngine<>;
+
+// Instantiated once in pipeline.cpp
+extern template class BasicPipelinedEngine<Portfolio>;
+
+// ============================================================================
+// Implementation
+// ============================================================================
+
+namespace detail {
+// Throws std::runtime_error if the thread cannot be pinned; a no-op for cpu < 0 and off Linux
+void pinToCpu(int cpu);
+
+// Retries `attempt` until it yields a slot, or nullptr once the run is aborted. The clock
+// is only read when the first attempt fails, so an unblocked stage pays nothing for it.
+template <typename Attempt>
+auto waitFor(Attempt attempt, const std::atomic<bool>& abort, StageStats& stage) {
+    auto slot = attempt();
+    if (slot != nullptr) return slot;
+
+    auto start = Clock::now();
+    for (unsigned spins = 0; (slot = attempt()) == nullptr; ++spins) {
+        if (abort.load(std::memory_order_relaxed)) break;
+        if (spins >= 64) std::this_thread::yield();  // Let a stage sharing the core run
+    }
+    stage.waitSeconds += secondsSince(start);
+    return slot;
+}
+
+struct DepthSampler {
+    uint64_t samples = 0;
+    uint64_t total = 0;
+    size_t max = 0;
+
+    void add(size_t depth) {
+        ++samples;
+        total += depth;
+        max = std::max(max, depth);
+    }
+
+    QueueStats stats(size_t capacity) const {
+        return {.meanDepth = samples ? static_cast<double>(total) / samples : 0.0,
+                .maxDepth = max,
+                .capacity = capacity};
+    }
+};
+}  // namespace detail
+
+template <AnyPortfolio P>
+BasicPipelinedEngine<P>::BasicPipelinedEngine(const DataHandler& data, Strategy& strategy,
+                                              P& portfolio, const EngineConfig& config,
+                                              const PipelineConfig& pipeline)
+    : data_(data),
+      strategy_(strategy),
+      portfolio_(portfolio),
+      config_(config),
+      pipeline_(pipeline) {
+    if (strategy.readsPortfolio()) {
+        throw std::invalid_argument(
+            "PipelinedEngine needs a strategy whose onBars ignores positions and fills");
+    }
+    if (config.checkpointEvery != 0 || !config.rollingWindows.empty() ||
+        config.quantileSketchK != 0) {
+        throw std::invalid_argument(
+            "PipelinedEngine takes no checkpoints, rolling windows or quantile sketches");
+    }
+    orderBatch_.reserve(64);
+    fills_.reserve(64);
+    results_.reserve(64);
+}
+
+template <AnyPortfolio P>
+const PipelineStats& BasicPipelinedEngine<P>::run() {
+    auto start = detail::Clock::now();
+    size_t numBars = data_.size();
+    size_t warmup = std::min(config_.warmupBars, numBars);
+
+    // Warm-up on the calling thread, as BacktestEngine::warmUp does it
+    std::vector<std::map<std::string, Bar>> history;
+    history.reserve(warmup);
+    for (size_t i = 0; i < warmup; ++i) {
+        history.push_back(data_.getBarsAt(i));
+    }
+    strategy_.onInit(history, indicators_);
+    if (!indicators_.empty()) {
+        indicators_.warmUp(history);
+    }
+    equityCurve_.clear();
+    if (config_.keepEquityCurve) {
+        equityCurve_.reserve(numBars - warmup + 1);
+    }
+    performance_ = {};
+    stats_ = {};
+
+    SpscQueue<const std::map<std::string, Bar>*> barQueue(pipeline_.queueCapacity);
+    SpscQueue<SignalBatch> signalQueue(pipeline_.queueCapacity);
+    detail::DepthSampler barDepth;
+    detail::DepthSampler signalDepth;
+    const std::map<std::string, Bar>* lastBars = nullptr;
+
+    std::atomic<bool> abort = false;
+    std::mutex errorMutex;
+    std::exception_ptr error;
+    auto stage = [&](size_t index, auto body) {
+        return std::thread([&, index, body] {
+            try {
+                detail::pinToCpu(pipeline_.cpus[index]);
+                body(stats_.stages[index]);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(errorMutex);
+                if (!error) error = std::current_exception();
+                abort = true;
+            }
+        });
+    };
+
+    auto loopStart = detail::Clock::now();
+    std::thread dataStage = stage(0, [&](StageStats& self) {
+        // The data is already decoded by DataHandler, so this stage only walks the
+        // cross-sections; a streaming decoder would take its place
+        for (size_t i = warmup; i <= numBars; ++i) {
+            auto* slot = detail::waitFor([&] { return barQueue.tryClaim(); }, abort, self);
+            if (slot == nullptr) return;
+            *slot = i < numBars ? &data_.getBarsAt(i) : nullptr;  // nullptr ends the run
+            barDepth.add(barQueue.publish());
+            self.items += i < numBars;
+        }
+    });
+
+    std::thread strategyStage = stage(1, [&](StageStats& self) {
+        std::map<std::string, Position> noPositions;
+        SignalBuffer signals;
+        for (;;) {
+            auto* in = detail::waitFor([&] { return barQueue.tryPeek(); }, abort, self);
+            if (in == nullptr) return;
+            const std::map<std::string, Bar>* bars = *in;
+            barQueue.release();
+
+            SignalBatch* out =
+                detail::waitFor([&] { return signalQueue.tryClaim(); }, abort, self);
+            if (out == nullptr) return;
+            out->bars = bars;
+            out->signals.clear();
+            if (bars != nullptr) {
+                if (!indicators_.empty()) {
+                    indicators_.update(*bars);
+                }
+                signals.clear();
+                strategy_.onBars(*bars, noPositions, signals);
+                signals.forEach([&](const Signal& signal) { out->signals.push_back(signal); });
+                ++self.items;
+            }
+            signalDepth.add(signalQueue.publish());
+            if (bars == nullptr) return;
+        }
+    });
+
+    std::thread accountingStage = stage(2, [&](StageStats& self) {
+        for (;;) {
+            SignalBatch* in =
+                detail::waitFor([&] { return signalQueue.tryPeek(); }, abort, self);
+            if (in == nullptr) return;
+            if (in->bars == nullptr) {
+                signalQueue.release();
+                return;
+            }
+            accountBar(*in);
+            lastBars = in->bars;
+            signalQueue.release();
+            ++self.items;
+        }
+    });
+
+    dataStage.join();
+    strategyStage.join();
+    accountingStage.join();
+    if (error) {
+        std::rethrow_exception(error);
+    }
+    double loopSeconds = detail::secondsSince(loopStart);
+
+    // Final liquidation
+    if (lastBars != nullptr) {
+        portfolio_.closeAllPositions(*lastBars);
+        recordEquity(*lastBars);
+    }
+
+    for (StageStats& s : stats_.stages) {
+        s.utilization = loopSeconds > 0.0 ? 1.0 - s.waitSeconds / loopSeconds : 0.0;
+    }
+    stats_.queues = {barDepth.stats(barQueue.capacity()),
+                     signalDepth.stats(signalQueue.capacity())};
+    stats_.engine.elapsedSeconds = detail::secondsSince(start);
+    return stats_;
+}
+
+// The engine's MARKET -> SIGNAL -> ORDER -> FILL sequence for one bar, with the same calls
+// into the Portfolio in the same order and the same event counts
+template <AnyPortfolio P>
+void BasicPipelinedEngine<P>::accountBar(const SignalBatch& batch) {
+    const std::map<std::string, Bar>& bars = *batch.bars;
+    EngineStats& engine = stats_.engine;
+    auto count = [&](EventType type, size_t n) {
+        engine.events += n;
+        engine.eventsByType[static_cast<size_t>(type)] += n;
+    };
+
+    ++engine.bars;
+    count(EventType::MARKET, 1);
+    portfolio_.markToMarket(bars);
+
+    fills_.clear();
+    portfolio_.processPendingOrders(bars, &fills_);
+    count(EventType::FILL, fills_.size());
+
+    count(EventType::SIGNAL, batch.signals.size());
+    if (!batch.signals.empty()) {
+        signalBatch_.clear();
+        for (const Signal& signal : batch.signals) {
+            signalBatch_.insert_or_assign(signal.symbol, signal);
+        }
+        std::map<std::string, Order> orders = strategy_.generateOrders(
+            signalBatch_, bars, config_.maxInvest, portfolio_.getCurrentPositions());
+
+        orderBatch_.clear();
+        for (auto& [symbol, order] : orders) {
+            if (order.quantity != 0) {
+                orderBatch_.push_back(std::move(order));
+            }
+        }
+        count(EventType::ORDER, orderBatch_.size());
+
+        if (!portfolio_.hasLatency()) {
+            if (!orderBatch_.empty()) {
+                results_.resize(orderBatch_.size());
+                fills_.clear();
+                portfolio_.executeOrders(orderBatch_, results_, &fills_, &bars);
+                count(EventType::FILL, fills_.size());
+            }
+        } else {
+            for (const Order& order : orderBatch_) {
+                fills_.clear();
+                portfolio_.submitOrder(order, false, &fills_, bars.at(order.symbol).volume);
+                count(EventType::FILL, fills_.size());
+            }
+        }
+    }
+
+    recordEquity(bars);
+}
+
+template <AnyPortfolio P>
+void BasicPipelinedEngine<P>::recordEquity(const std::map<std::string, Bar>& bars) {
+    EquityPoint point{bars.begin()->second.time, portfolio_.getTotalEquity(bars)};
+    performance_.add(point);
+    if (config_.keepEquityCurve) equityCurve_.push_back(point);
+}
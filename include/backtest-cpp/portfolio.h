@@ -1,40 +1,798 @@
 #pragma once
 
+#include <algorithm>
+#include <cmath>
 #include <cstdint>
+#include <iostream>
+#include <limits>
 #include <map>
 #include <optional>
+#include <span>
+#include <stdexcept>
+#include <utility>
 #include <vector>
 
+#include "backtest-cpp/costs.h"
+#include "backtest-cpp/latency.h"
+#include "backtest-cpp/serialization.h"
 #include "backtest-cpp/types.h"
 
 struct PortfolioConfig {
     double initialCash;
-    double commission;
+    double commission;  // Passed to the commission policy if it is constructible from it
     double leverage = 1.0;
+    LatencyConfig latency = {};           // Zero by default: fill on the signal bar
+    double maxVolumeParticipation = 1.0;  // Max share of a bar's volume one fill may take
+    int maxPositionSize = std::numeric_limits<int>::max();  // Per symbol, in contracts
+    bool logTrades = true;                                  // Print every closed trade
 };
 
-class Portfolio {
+// Order waiting for its simulated arrival at the exchange
+struct PendingOrder {
+    int64_t arrivalTime;
+    uint64_t sequence;  // Submission order, breaks ties between equal arrival times
+    Order order;        // quantity holds the still unfilled remainder
+    bool close;         // Skip the overdraft check on fill, as in executeOrder
+};
+
+// REJECTED: passed the batch checks, but the netted fill was refused by executeOrder.
+// NO_TRADE: the symbol's bar is Bar::synthetic, there is no trade to fill against.
+enum class ExecutionStatus { FILLED, ZERO_QUANTITY, OVERDRAFT, POSITION_LIMIT, REJECTED, NO_TRADE };
+
+struct ExecutionResult {
+    ExecutionStatus status;
+    int filledQuantity;
+};
+
+// One fill booked against a symbol's position. executeOrder and SimulatedPosition (see
+// vectorized.h) both book fills through bookFill, so they cannot drift apart.
+struct BookedFill {
+    int quantity;          // Position after the fill
+    double averagePrice;   // Its entry price, 0 when flat
+    double cashIn;         // Credited first: margin released by the closed part and its PnL
+    double cashOut;        // Then paid: cost of the opened part and its fee
+    int closedQuantity;    // Part of the old position that was closed, with its sign; 0 if none
+    double pnl;            // Realized on the closed part, net of the fee
+    bool reversed;         // The fill closed the position and opened the other side
+};
+
+inline BookedFill bookFill(int quantity, double averagePrice, int fillQuantity, double fillPrice,
+                           double fee) {
+    // New position
+    if (quantity == 0) {
+        return {fillQuantity, fillPrice, 0.0, abs(fillQuantity) * fillPrice + fee, 0, 0.0, false};
+    }
+
+    // Add to position
+    if ((fillQuantity > 0) == (quantity > 0)) {
+        double entry = (quantity * averagePrice + fillQuantity * fillPrice) /
+                       static_cast<double>(quantity + fillQuantity);
+        return {quantity + fillQuantity, entry, 0.0, abs(fillQuantity) * fillPrice + fee,
+                0,        0.0,   false};
+    }
+
+    // Reduce, close or reverse. The remainder of a reduced position keeps its entry price.
+    int netQuantity = quantity + fillQuantity;
+    int closedQuantity = abs(fillQuantity) >= abs(quantity) ? quantity : -fillQuantity;
+    double pnl = closedQuantity * (fillPrice - averagePrice) - fee;
+    bool reversed = abs(fillQuantity) > abs(quantity);
+    return {netQuantity,
+            netQuantity == 0 ? 0.0
+            : reversed       ? fillPrice
+                             : averagePrice,
+            abs(closedQuantity) * averagePrice + pnl + fee,
+            reversed ? abs(netQuantity) * fillPrice + fee : 0.0,
+            closedQuantity,
+            pnl,
+            reversed};
+}
+
+// Closed-trade aggregates, updated by executeOrder as each trade closes. PnL is net of
+// commission; a trade with zero PnL is neither a win nor a loss.
+struct TradeStats {
+    size_t trades = 0;
+    size_t wins = 0;
+    size_t losses = 0;
+    double pnl = 0.0;          // Summed in trade order
+    double grossProfit = 0.0;  // Sum of winning PnL
+    double grossLoss = 0.0;    // Sum of losing PnL, <= 0
+    double largestWin = 0.0;
+    double largestLoss = 0.0;
+    int64_t holdingTime = 0;  // Sum of exit minus entry time, in Bar::time units
+    double mae = 0.0;         // Sums of Trade::mae and Trade::mfe
+    double mfe = 0.0;
+    double worstMae = 0.0;
+    double bestMfe = 0.0;
+
+    void add(const Trade& trade);
+
+    double winRate() const;
+    double profitFactor() const;  // Infinite without losses, 0 without trades
+    double averageWin() const;
+    double averageLoss() const;
+    double expectancy() const;  // Mean PnL per trade
+    double averageHoldingTime() const;
+    double averageMae() const;
+    double averageMfe() const;
+};
+
+// Commission and slippage are compile-time policies (see costs.h), so the default
+// Portfolio inlines a flat fee and no slippage into executeOrder. RuntimePortfolio
+// selects the models at runtime through std::variant instead. LogTrades = false compiles
+// the trade log out of executeOrder, whatever PortfolioConfig::logTrades says.
+template <CommissionModel Commission = FlatCommission, SlippageModel Slippage = NoSlippage,
+          bool LogTrades = true>
+class BasicPortfolio {
    public:
-    Portfolio(const PortfolioConfig& config);
+    using CommissionType = Commission;
+    using SlippageType = Slippage;
+
+    BasicPortfolio(const PortfolioConfig& config)
+        requires std::constructible_from<Commission, double> &&
+                 std::default_initializable<Slippage>
+        : BasicPortfolio(config, Commission(config.commission), Slippage{}) {}
+
+    BasicPortfolio(const PortfolioConfig& config, Commission commission, Slippage slippage = {});
 
     std::map<std::string, Position>& getCurrentPositions();
     const double getInvestedValue(const std::map<std::string, Bar>& currentBars) const;
     const double getTotalEquity(const std::map<std::string, Bar>& currentBar) const;
     double getRealizedPnL() const;
+    const TradeStats& getTradeStats() const { return tradeStats_; }
     double getUnrealizedPnL(const std::map<std::string, Bar>& currentBars) const;
     bool checkOverdraft(const Order& order) const;
+    bool exceedsPositionLimit(const Order& order) const;
     std::vector<Order> getAllOrders(int64_t fromTime) const;
     std::vector<Trade> getAllTrades() const;
+    // Trades from index `from` on, without the copy
+    std::span<const Trade> getTrades(size_t from = 0) const {
+        return std::span<const Trade>(trades_).subspan(std::min(from, trades_.size()));
+    }
     double getAvailableCash() const;
     void closeAllPositions(const std::map<std::string, Bar>& currentBars);
-    void executeOrder(const Order& order, const bool close);
+    // Widens the price range of every open position by its bar's high and low. Called at
+    // the start of each bar, before that bar's fills, so MAE/MFE only see prices held through.
+    void markToMarket(const std::map<std::string, Bar>& bars);
+
+    // Applies slippage and commission; `barVolume` feeds volume-dependent slippage (0 = unknown).
+    // The executed order, at its fill price, is appended to the order log.
+    bool executeOrder(const Order& order, const bool close = false, long barVolume = 0);
+
+    // Executes a batch at once: risk checks run in order over the whole batch, accepted
+    // orders are netted per symbol and each symbol gets a single fill priced at the net
+    // signed notional per contract, so cash matches executing them one by one. Each check
+    // charges the commission and slippage of the netted fill it would produce; slippage
+    // sees the symbol's volume in `bars` if given, and orders on a synthetic bar there are
+    // refused. Orders that cancel out never reach the book. `results[i]` describes
+    // `orders[i]`; netted fills are appended to `fills`.
+    void executeOrders(std::span<const Order> orders, std::span<ExecutionResult> results,
+                       std::vector<Order>* fills = nullptr,
+                       const std::map<std::string, Bar>* bars = nullptr);
+
+    // Routes an order through the latency model. Without latency it executes immediately.
+    // Either way executeOrder's risk checks (skipped if `close`) run when it fills.
+    // Executed fills are appended to `fills` if given.
+    void submitOrder(const Order& order, const bool close = false,
+                     std::vector<Order>* fills = nullptr, long barVolume = 0);
+    // Fills pending orders that have arrived by the time of `bars`; returns number of fills
+    size_t processPendingOrders(const std::map<std::string, Bar>& bars,
+                                std::vector<Order>* fills = nullptr);
+    size_t getPendingOrderCount() const;
+    bool hasLatency() const { return hasLatency_; }
+
+    const Commission& getCommissionModel() const { return commission_; }
+    const Slippage& getSlippageModel() const { return slippage_; }
+
+    // Checkpointing: cash, positions, journals, trade stats, pending orders and the latency
+    // generator. Config and cost policies are not stored, load into a portfolio built the
+    // same way. Without `journals` the order and trade logs are left out (loadState then
+    // empties them), for callers that store them incrementally with saveJournals.
+    void saveState(BinaryWriter& writer, bool journals = true) const;
+    void loadState(BinaryReader& reader, bool journals = true);
+    size_t getOrderCount() const { return orders_.size(); }
+    // Room for this many orders and trades in the logs, so a run of known length does not
+    // grow them
+    void reserveJournals(size_t orders, size_t trades) {
+        orders_.reserve(orders);
+        trades_.reserve(trades);
+    }
+    // Orders and trades from the given counts on; loadJournals appends them
+    void saveJournals(BinaryWriter& writer, size_t ordersFrom, size_t tradesFrom) const;
+    void loadJournals(BinaryReader& reader);
 
    private:
+    // Per-symbol working state of an executeOrders call
+    struct BatchSlot {
+        const std::string* symbol;
+        int64_t time;
+        long volume;         // Bar volume for slippage, 0 if unknown
+        bool synthetic;      // No trade in the bar, nothing fills
+        int position;        // Quantity held before the batch
+        double heldMargin;   // Its margin at the average entry price
+        double margin;       // Margin after the orders accepted so far
+        int netQuantity;     // Sum of accepted order quantities
+        double netNotional;  // Sum of quantity * price of accepted orders
+    };
+
+    // Margin of `slot`'s position after a netted fill of `netQuantity` at `netNotional`,
+    // with the fill's slippage and commission
+    double batchMargin(const BatchSlot& slot, int netQuantity, double netNotional) const;
+
     double availableCash_ = 10000;
     const double leverage_ = 1;
-    const double commission_ = 2.70;
+    const int maxPositionSize_ = std::numeric_limits<int>::max();
+    Commission commission_;
+    Slippage slippage_;
 
     std::map<std::string, Position> positions_;  // Open Positions
-    std::vector<Order> orders_;                  // Open Orders
+    std::vector<Order> orders_;                  // Executed Orders
     std::vector<Trade> trades_;                  // Elapsed Trades
-};
\ No newline at end of file
+    TradeStats tradeStats_;
+
+    LatencyModel latency_;
+    bool hasLatency_ = false;
+    double maxVolumeParticipation_ = 1.0;
+    bool logTrades_ = true;
+    uint64_t nextSequence_ = 0;
+    std::vector<PendingOrder> pending_;                     // Min-heap on (arrivalTime, sequence)
+    std::vector<PendingOrder> deferred_;                    // Arrived, no tradeable bar yet
+    std::vector<std::pair<std::string, long>> volumeUsed_;  // Volume already filled this bar
+
+    std::vector<uint32_t> batchOrder_;   // Order indices sorted by symbol
+    std::vector<uint32_t> batchSlotOf_;  // Order index -> slot
+    std::vector<BatchSlot> batchSlots_;
+};
+
+using Portfolio = BasicPortfolio<FlatCommission, NoSlippage>;
+using RuntimePortfolio = BasicPortfolio<RuntimeCommission, RuntimeSlippage>;
+
+namespace detail {
+template <typename P>
+inline constexpr bool isBasicPortfolio = false;
+template <CommissionModel Commission, SlippageModel Slippage, bool LogTrades>
+inline constexpr bool isBasicPortfolio<BasicPortfolio<Commission, Slippage, LogTrades>> = true;
+}  // namespace detail
+
+// Any BasicPortfolio, whatever its policies: the portfolio parameter of the engines
+template <typename P>
+concept AnyPortfolio = detail::isBasicPortfolio<P>;
+
+// Instantiated once in portfolio.cpp
+extern template class BasicPortfolio<FlatCommission, NoSlippage>;
+extern template class BasicPortfolio<RuntimeCommission, RuntimeSlippage>;
+
+// ============================================================================
+// Implementation
+// ============================================================================
+
+namespace detail {
+// std::push_heap builds a max-heap, so "greater" puts the earliest arrival on top
+inline bool arrivesLater(const PendingOrder& a, const PendingOrder& b) {
+    if (a.arrivalTime != b.arrivalTime) return a.arrivalTime > b.arrivalTime;
+    return a.sequence > b.sequence;
+}
+}  // namespace detail
+
+template <CommissionModel Commission, SlippageModel Slippage, bool LogTrades>
+BasicPortfolio<Commission, Slippage, LogTrades>::BasicPortfolio(const PortfolioConfig& config,
+                                                                Commission commission,
+                                                                Slippage slippage)
+    : availableCash_(config.initialCash),
+      leverage_(config.leverage),
+      maxPositionSize_(config.maxPositionSize),
+      commission_(std::move(commission)),
+      slippage_(std::move(slippage)),
+      latency_(config.latency),
+      hasLatency_(!latency_.isZero()),
+      maxVolumeParticipation_(config.maxVolumeParticipation),
+      logTrades_(config.logTrades) {
+    pending_.reserve(64);
+    deferred_.reserve(64);
+}
+
+template <CommissionModel Commission, SlippageModel Slippage, bool LogTrades>
+std::map<std::string, Position>&
+BasicPortfolio<Commission, Slippage, LogTrades>::getCurrentPositions() {
+    return positions_;
+}
+
+template <CommissionModel Commission, SlippageModel Slippage, bool LogTrades>
+const double BasicPortfolio<Commission, Slippage, LogTrades>::getInvestedValue(
+    const std::map<std::string, Bar>& currentBars) const {
+    double totalPositionValue = 0;
+    for (const auto& [symbol, position] : positions_) {
+        // std::cout << "CurrentBars.size() " << currentBars.size() << std::endl;
+        auto it = currentBars.find(symbol);
+        if (it == currentBars.end()) {
+            // Use last known price or throw error - don't just skip!
+            std::cerr << "ERROR: Missing price for position " << symbol << std::endl;
+            // throw std::runtime_error("Cannot calculate equity without price");
+        }
+        totalPositionValue += position.quantity * it->second.close;
+    }
+    return fabs(totalPositionValue);
+}
+
+template <CommissionModel Commission, SlippageModel Slippage, bool LogTrades>
+const double BasicPortfolio<Commission, Slippage, LogTrades>::getTotalEquity(
+    const std::map<std::string, Bar>& currentBars) const {
+    return getInvestedValue(currentBars) + availableCash_;
+}
+
+template <CommissionModel Commission, SlippageModel Slippage, bool LogTrades>
+std::vector<Order> BasicPortfolio<Commission, Slippage, LogTrades>::getAllOrders(
+    int64_t fromTime) const {
+    std::vector<Order> ordersWithinTimeline;
+    for (const Order& order : orders_) {
+        if (order.time >= fromTime) {
+            ordersWithinTimeline.push_back(order);
+        }
+    }
+    return ordersWithinTimeline;
+}
+
+template <CommissionModel Commission, SlippageModel Slippage, bool LogTrades>
+void BasicPortfolio<Commission, Slippage, LogTrades>::closeAllPositions(
+    const std::map<std::string, Bar>& currentBars) {
+    auto it = positions_.begin();
+    while (it != positions_.end()) {
+        const std::string& symbol = it->first;
+        const Position& position = it->second;
+
+        // Check if bar exists
+        auto barIt = currentBars.find(symbol);
+        if (barIt == currentBars.end()) {
+            std::cerr << "WARNING: No price data for symbol " << symbol << std::endl;
+            //++it;
+            // continue;
+        }
+
+        // Build order using const references (no copies)
+        Order closeOrder{.time = barIt->second.time,
+                         .symbol = symbol,
+                         .direction = (position.quantity > 0) ? SignalType::SELL : SignalType::BUY,
+                         .price = barIt->second.close,
+                         .type = OrderType::MARKET,
+                         .quantity = -position.quantity};
+
+        // CRITICAL: Increment iterator BEFORE executeOrder modifies positions_
+        ++it;
+
+        executeOrder(closeOrder, true, barIt->second.volume);
+    }
+}
+
+template <CommissionModel Commission, SlippageModel Slippage, bool LogTrades>
+void BasicPortfolio<Commission, Slippage, LogTrades>::markToMarket(
+    const std::map<std::string, Bar>& bars) {
+    for (auto& [symbol, position] : positions_) {
+        auto barIt = bars.find(symbol);
+        if (barIt == bars.end()) continue;
+        position.lowPrice = std::min(position.lowPrice, barIt->second.low);
+        position.highPrice = std::max(position.highPrice, barIt->second.high);
+    }
+}
+
+template <CommissionModel Commission, SlippageModel Slippage, bool LogTrades>
+bool BasicPortfolio<Commission, Slippage, LogTrades>::checkOverdraft(const Order& order) const {
+    auto posIt = positions_.find(order.symbol);
+    bool hasPosition = (posIt != positions_.end());
+    double fee = commission_.cost(order.quantity, order.price);
+
+    if (hasPosition) {
+        const Position& pos = positions_.at(order.symbol);
+        int netPositionSize = pos.quantity + order.quantity;
+
+        return (abs(netPositionSize) * order.price + fee >
+                (availableCash_ * leverage_ + pos.averagePrice * abs(pos.quantity) - fee));
+    } else {
+        return (abs(order.quantity) * order.price + fee) >
+               (availableCash_ * leverage_);  // NEEDS fixing for adjusting pos size
+    }
+}
+
+template <CommissionModel Commission, SlippageModel Slippage, bool LogTrades>
+bool BasicPortfolio<Commission, Slippage, LogTrades>::exceedsPositionLimit(
+    const Order& order) const {
+    auto posIt = positions_.find(order.symbol);
+    int current = posIt != positions_.end() ? posIt->second.quantity : 0;
+    return abs(current + order.quantity) > maxPositionSize_;
+}
+
+template <CommissionModel Commission, SlippageModel Slippage, bool LogTrades>
+double BasicPortfolio<Commission, Slippage, LogTrades>::getRealizedPnL() const {
+    return tradeStats_.pnl;
+}
+
+template <CommissionModel Commission, SlippageModel Slippage, bool LogTrades>
+double BasicPortfolio<Commission, Slippage, LogTrades>::getUnrealizedPnL(
+    const std::map<std::string, Bar>& currentBars) const {
+    double UnrealizedPnl = 0;
+    for (const auto& [symbol, position] : positions_) {
+        double close = currentBars.at(symbol).close;
+        UnrealizedPnl += position.quantity * (close - position.averagePrice) -
+                         commission_.cost(position.quantity, close);
+    }
+    return UnrealizedPnl;
+}
+
+template <CommissionModel Commission, SlippageModel Slippage, bool LogTrades>
+bool BasicPortfolio<Commission, Slippage, LogTrades>::executeOrder(const Order& order,
+                                                                   const bool close,
+                                                                   long barVolume) {
+    if (order.quantity == 0) {
+        std::cerr << "Order quantity cannot be 0" << std::endl;
+        return false;
+    }
+
+    // Slippage moves the fill price against us, commission is charged on the fill
+    Order fill = order;
+    fill.price = slippage_.fillPrice(order.price, order.quantity, barVolume);
+    const double fee = commission_.cost(fill.quantity, fill.price);
+
+    if (!close && checkOverdraft(fill)) {
+        std::cerr << "Insufficient funds for order" << std::endl;
+        return false;
+    }
+
+    if (!close && exceedsPositionLimit(fill)) {
+        std::cerr << "Position limit exceeded for " << fill.symbol << std::endl;
+        return false;
+    }
+
+    auto posIt = positions_.find(fill.symbol);
+    bool hasPosition = (posIt != positions_.end());
+    const BookedFill booked =
+        hasPosition ? bookFill(posIt->second.quantity, posIt->second.averagePrice, fill.quantity,
+                               fill.price, fee)
+                    : bookFill(0, 0.0, fill.quantity, fill.price, fee);
+    availableCash_ += booked.cashIn;
+    availableCash_ -= booked.cashOut;
+
+    if (!hasPosition) {
+        positions_[fill.symbol] = Position{
+            .symbol = fill.symbol,
+            .quantity = booked.quantity,
+            .averagePrice = booked.averagePrice,
+            .direction = (fill.quantity > 0) ? SignalType::BUY : SignalType::SELL,
+            .openTime = fill.time,
+            .lowPrice = fill.price,
+            .highPrice = fill.price,
+        };
+        orders_.push_back(std::move(fill));
+        return true;
+    }
+
+    Position& pos = posIt->second;
+    pos.lowPrice = std::min(pos.lowPrice, fill.price);
+    pos.highPrice = std::max(pos.highPrice, fill.price);
+
+    if (booked.closedQuantity != 0) {
+        // Excursions of the closed units against the entry, the exit price included
+        double atLow = booked.closedQuantity * (pos.lowPrice - pos.averagePrice);
+        double atHigh = booked.closedQuantity * (pos.highPrice - pos.averagePrice);
+        trades_.push_back(Trade{.order = fill,
+                                .quantity = booked.closedQuantity,
+                                .pnl = booked.pnl,
+                                .commission = fee,
+                                .entryTime = pos.openTime,
+                                .mae = std::min(atLow, atHigh),
+                                .mfe = std::max(atLow, atHigh)});
+        tradeStats_.add(trades_.back());
+        if constexpr (LogTrades) {
+            if (logTrades_) {
+                std::cout << "Logged Trade | "
+                          << "Closed: " << booked.closedQuantity << " Entered @ "
+                          << pos.averagePrice << " Exited @ " << fill.price
+                          << " P&L: " << booked.pnl << std::endl;
+            }
+        }
+    }
+
+    if (booked.quantity == 0) {
+        positions_.erase(posIt);  // Remove Empty Position
+    } else {
+        pos.direction = booked.quantity > 0 ? SignalType::BUY : SignalType::SELL;
+        pos.quantity = booked.quantity;
+        pos.averagePrice = booked.averagePrice;
+        // Reversed: the remainder is a new position opened by this fill
+        if (booked.reversed) {
+            pos.openTime = fill.time;
+            pos.lowPrice = pos.highPrice = fill.price;
+        }
+    }
+
+    orders_.push_back(std::move(fill));
+    return true;
+}
+
+template <CommissionModel Commission, SlippageModel Slippage, bool LogTrades>
+void BasicPortfolio<Commission, Slippage, LogTrades>::executeOrders(
+    std::span<const Order> orders, std::span<ExecutionResult> results, std::vector<Order>* fills,
+    const std::map<std::string, Bar>* bars) {
+    if (results.size() < orders.size()) {
+        throw std::invalid_argument("executeOrders: results span is smaller than orders");
+    }
+
+    const size_t n = orders.size();
+    batchOrder_.resize(n);
+    batchSlotOf_.resize(n);
+    batchSlots_.clear();
+
+    // 1. Group by symbol and merge-join against the (sorted) position map, so every
+    //    position is looked up once per batch instead of once per order. Ties break on the
+    //    index, which keeps batch order without stable_sort's heap scratch buffer
+    for (uint32_t i = 0; i < n; ++i) batchOrder_[i] = i;
+    std::sort(batchOrder_.begin(), batchOrder_.end(), [&](uint32_t a, uint32_t b) {
+        int c = orders[a].symbol.compare(orders[b].symbol);
+        return c < 0 || (c == 0 && a < b);
+    });
+
+    auto posIt = positions_.begin();
+    for (uint32_t i : batchOrder_) {
+        const std::string& symbol = orders[i].symbol;
+        if (batchSlots_.empty() || *batchSlots_.back().symbol != symbol) {
+            while (posIt != positions_.end() && posIt->first < symbol) ++posIt;
+            bool hasPosition = posIt != positions_.end() && posIt->first == symbol;
+            double heldMargin =
+                hasPosition ? abs(posIt->second.quantity) * posIt->second.averagePrice : 0.0;
+            long volume = 0;
+            bool synthetic = false;
+            if (bars != nullptr) {
+                auto barIt = bars->find(symbol);
+                if (barIt != bars->end()) {
+                    volume = barIt->second.volume;
+                    synthetic = barIt->second.synthetic;
+                }
+            }
+
+            batchSlots_.push_back(BatchSlot{
+                .symbol = &symbol,
+                .time = orders[i].time,
+                .volume = volume,
+                .synthetic = synthetic,
+                .position = hasPosition ? posIt->second.quantity : 0,
+                .heldMargin = heldMargin,
+                .margin = heldMargin,
+                .netQuantity = 0,
+                .netNotional = 0.0,
+            });
+        }
+        batchSlotOf_[i] = static_cast<uint32_t>(batchSlots_.size() - 1);
+    }
+
+    // 2. Risk checks in submission order against a running margin budget. Each order is
+    //    charged the change it makes to its symbol's netted fill, costs included.
+    double freeCash = availableCash_ * leverage_;
+    for (size_t i = 0; i < n; ++i) {
+        const Order& order = orders[i];
+        BatchSlot& slot = batchSlots_[batchSlotOf_[i]];
+
+        if (order.quantity == 0) {
+            results[i] = {ExecutionStatus::ZERO_QUANTITY, 0};
+            continue;
+        }
+        if (slot.synthetic) {
+            results[i] = {ExecutionStatus::NO_TRADE, 0};
+            continue;
+        }
+
+        int netQuantity = slot.netQuantity + order.quantity;
+        if (abs(slot.position + netQuantity) > maxPositionSize_) {
+            results[i] = {ExecutionStatus::POSITION_LIMIT, 0};
+            continue;
+        }
+
+        double netNotional = slot.netNotional + order.quantity * order.price;
+        double margin = batchMargin(slot, netQuantity, netNotional);
+        if (margin - slot.margin > freeCash) {
+            results[i] = {ExecutionStatus::OVERDRAFT, 0};
+            continue;
+        }
+
+        freeCash -= margin - slot.margin;
+        slot.margin = margin;
+        slot.netQuantity = netQuantity;
+        slot.netNotional = netNotional;
+        slot.time = std::max(slot.time, order.time);
+        results[i] = {ExecutionStatus::FILLED, order.quantity};
+    }
+
+    // 3. One netted fill per symbol; orders that cancel out never reach the book
+    for (size_t s = 0; s < batchSlots_.size(); ++s) {
+        const BatchSlot& slot = batchSlots_[s];
+        if (slot.netQuantity == 0) continue;
+
+        Order fill{.time = slot.time,
+                   .symbol = *slot.symbol,
+                   .direction = slot.netQuantity > 0 ? SignalType::BUY : SignalType::SELL,
+                   .price = slot.netNotional / slot.netQuantity,
+                   .type = OrderType::MARKET,
+                   .quantity = slot.netQuantity};
+
+        if (executeOrder(fill, true, slot.volume)) {
+            if (fills) fills->push_back(orders_.back());
+            continue;
+        }
+        for (size_t i = 0; i < n; ++i) {
+            if (batchSlotOf_[i] == s && results[i].status == ExecutionStatus::FILLED) {
+                results[i] = {ExecutionStatus::REJECTED, 0};
+            }
+        }
+    }
+}
+
+template <CommissionModel Commission, SlippageModel Slippage, bool LogTrades>
+double BasicPortfolio<Commission, Slippage, LogTrades>::batchMargin(
+    const BatchSlot& slot, int netQuantity, double netNotional) const {
+    if (netQuantity == 0) return slot.heldMargin;  // No fill
+    double price = slippage_.fillPrice(netNotional / netQuantity, netQuantity, slot.volume);
+    return abs(slot.position + netQuantity) * price + commission_.cost(netQuantity, price);
+}
+
+template <CommissionModel Commission, SlippageModel Slippage, bool LogTrades>
+void BasicPortfolio<Commission, Slippage, LogTrades>::submitOrder(const Order& order,
+                                                                  const bool close,
+                                                                  std::vector<Order>* fills,
+                                                                  long barVolume) {
+    if (!hasLatency_) {
+        if (executeOrder(order, close, barVolume) && fills) {
+            fills->push_back(orders_.back());
+        }
+        return;
+    }
+
+    if (order.quantity == 0) {
+        std::cerr << "Order quantity cannot be 0" << std::endl;
+        return;
+    }
+
+    pending_.push_back(PendingOrder{.arrivalTime = order.time + latency_.sample(order.symbol),
+                                    .sequence = nextSequence_++,
+                                    .order = order,
+                                    .close = close});
+    std::push_heap(pending_.begin(), pending_.end(), detail::arrivesLater);
+}
+
+template <CommissionModel Commission, SlippageModel Slippage, bool LogTrades>
+size_t BasicPortfolio<Commission, Slippage, LogTrades>::processPendingOrders(
+    const std::map<std::string, Bar>& bars, std::vector<Order>* fills) {
+    if (pending_.empty() || bars.empty()) {
+        return 0;
+    }
+
+    int64_t now = bars.begin()->second.time;
+    size_t filled = 0;
+    volumeUsed_.clear();
+
+    while (!pending_.empty() && pending_.front().arrivalTime <= now) {
+        std::pop_heap(pending_.begin(), pending_.end(), detail::arrivesLater);
+        PendingOrder pending = std::move(pending_.back());
+        pending_.pop_back();
+
+        // First traded bar at or after arrival for this symbol
+        auto barIt = bars.find(pending.order.symbol);
+        if (barIt == bars.end() || barIt->second.time < pending.arrivalTime ||
+            barIt->second.synthetic) {
+            deferred_.push_back(std::move(pending));
+            continue;
+        }
+        const Bar& bar = barIt->second;
+
+        auto usedIt = std::find_if(volumeUsed_.begin(), volumeUsed_.end(),
+                                   [&](const auto& used) { return used.first == bar.symbol; });
+        if (usedIt == volumeUsed_.end()) {
+            volumeUsed_.emplace_back(bar.symbol, 0);
+            usedIt = volumeUsed_.end() - 1;
+        }
+
+        // Partial fill: never trade more than the bar's (participation-limited) volume
+        long capacity =
+            static_cast<long>(std::floor(bar.volume * maxVolumeParticipation_)) - usedIt->second;
+        int remaining = pending.order.quantity;
+        int fillSize =
+            static_cast<int>(std::min<long>(std::abs(remaining), std::max(capacity, 0L)));
+
+        if (fillSize == 0) {
+            deferred_.push_back(std::move(pending));
+            continue;
+        }
+
+        Order fill = pending.order;
+        fill.time = bar.time;
+        fill.price = bar.open;
+        fill.quantity = remaining > 0 ? fillSize : -fillSize;
+
+        if (!executeOrder(fill, pending.close, bar.volume)) {
+            continue;  // Rejected on arrival, the remainder is dropped too
+        }
+        usedIt->second += fillSize;  // Only fills take up the bar's volume
+        ++filled;
+        if (fills) {
+            fills->push_back(orders_.back());
+        }
+
+        pending.order.quantity -= fill.quantity;
+        if (pending.order.quantity != 0) {
+            deferred_.push_back(std::move(pending));
+        }
+    }
+
+    for (PendingOrder& pending : deferred_) {
+        pending_.push_back(std::move(pending));
+        std::push_heap(pending_.begin(), pending_.end(), detail::arrivesLater);
+    }
+    deferred_.clear();
+
+    return filled;
+}
+
+template <CommissionModel Commission, SlippageModel Slippage, bool LogTrades>
+size_t BasicPortfolio<Commission, Slippage, LogTrades>::getPendingOrderCount() const {
+    return pending_.size();
+}
+
+template <CommissionModel Commission, SlippageModel Slippage, bool LogTrades>
+std::vector<Trade> BasicPortfolio<Commission, Slippage, LogTrades>::getAllTrades() const {
+    return trades_;
+}
+
+template <CommissionModel Commission, SlippageModel Slippage, bool LogTrades>
+double BasicPortfolio<Commission, Slippage, LogTrades>::getAvailableCash() const {
+    return availableCash_;
+}
+
+template <CommissionModel Commission, SlippageModel Slippage, bool LogTrades>
+void BasicPortfolio<Commission, Slippage, LogTrades>::saveState(BinaryWriter& writer,
+                                                                bool journals) const {
+    writer.write(availableCash_);
+    writer.write(positions_);
+    if (journals) saveJournals(writer, 0, 0);
+    writer.write(tradeStats_);
+
+    latency_.saveState(writer);
+    writer.write(nextSequence_);
+    // Stored in heap layout, so equal arrival times still fill in submission order
+    writer.write<uint64_t>(pending_.size());
+    for (const PendingOrder& pending : pending_) {
+        writer.write(pending.arrivalTime);
+        writer.write(pending.sequence);
+        writer.write(pending.order);
+        writer.write(pending.close);
+    }
+}
+
+template <CommissionModel Commission, SlippageModel Slippage, bool LogTrades>
+void BasicPortfolio<Commission, Slippage, LogTrades>::loadState(BinaryReader& reader,
+                                                                bool journals) {
+    reader.read(availableCash_);
+    reader.read(positions_);
+    orders_.clear();
+    trades_.clear();
+    if (journals) loadJournals(reader);
+    reader.read(tradeStats_);
+
+    latency_.loadState(reader);
+    reader.read(nextSequence_);
+    pending_.resize(reader.readSize());
+    for (PendingOrder& pending : pending_) {
+        reader.read(pending.arrivalTime);
+        reader.read(pending.sequence);
+        reader.read(pending.order);
+        reader.read(pending.close);
+    }
+}
+
+template <CommissionModel Commission, SlippageModel Slippage, bool LogTrades>
+void BasicPortfolio<Commission, Slippage, LogTrades>::saveJournals(BinaryWriter& writer,
+                                                                   size_t ordersFrom,
+                                                                   size_t tradesFrom) const {
+    writer.write(std::span<const Order>(orders_).subspan(std::min(ordersFrom, orders_.size())));
+    writer.write(getTrades(tradesFrom));
+}
+
+template <CommissionModel Commission, SlippageModel Slippage, bool LogTrades>
+void BasicPortfolio<Commission, Slippage, LogTrades>::loadJournals(BinaryReader& reader) {
+    reader.readAppend(orders_);
+    reader.readAppend(trades_);
+}
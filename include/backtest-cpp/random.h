@@ -0,0 +1,62 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+// Philox4x32-10 (Salmon et al., "Parallel random numbers: as easy as 1, 2, 3"): a
+// counter-based generator whose i-th output of a stream is a pure function of (seed,
+// stream, i). Giving every Monte Carlo sample its own stream makes its numbers independent
+// of which thread draws them and in what order, so results do not depend on thread count.
+class Philox {
+   public:
+    using Block = std::array<uint32_t, 4>;
+    using Key = std::array<uint32_t, 2>;
+
+    Philox(uint64_t seed, uint64_t stream)
+        : key_{static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32)}, stream_(stream) {}
+
+    // Ten rounds of the Philox bijection: the whole generator
+    static Block block(Block counter, Key key) {
+        for (int round = 0; round < 10; ++round) {
+            if (round > 0) {
+                key[0] += 0x9E3779B9u;
+                key[1] += 0xBB67AE85u;
+            }
+            uint64_t product0 = uint64_t{0xD2511F53u} * counter[0];
+            uint64_t product1 = uint64_t{0xCD9E8D57u} * counter[2];
+            counter = {static_cast<uint32_t>(product1 >> 32) ^ counter[1] ^ key[0],
+                       static_cast<uint32_t>(product1),
+                       static_cast<uint32_t>(product0 >> 32) ^ counter[3] ^ key[1],
+                       static_cast<uint32_t>(product0)};
+        }
+        return counter;
+    }
+
+    uint64_t next() {
+        if (used_ == 4) {
+            Block counter = {static_cast<uint32_t>(counter_), static_cast<uint32_t>(counter_ >> 32),
+                             static_cast<uint32_t>(stream_), static_cast<uint32_t>(stream_ >> 32)};
+            buffer_ = block(counter, key_);
+            ++counter_;
+            used_ = 0;
+        }
+        uint64_t value = (uint64_t{buffer_[used_]} << 32) | buffer_[used_ + 1];
+        used_ += 2;
+        return value;
+    }
+
+    // Uniform in [0, 1) from the top 53 bits
+    double uniform() { return static_cast<double>(next() >> 11) * 0x1p-53; }
+
+    // Uniform in [0, n) by multiply-shift; the bias of at most n / 2^64 is far below noise
+    uint64_t below(uint64_t n) {
+        return static_cast<uint64_t>((static_cast<unsigned __int128>(next()) * n) >> 64);
+    }
+
+   private:
+    Key key_;
+    uint64_t stream_;
+    uint64_t counter_ = 0;
+    Block buffer_{};
+    int used_ = 4;  // Words of buffer_ handed out
+};
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+// Fixed-capacity FIFO. All storage is allocated in the constructor, so pushing and
+// popping never touches the heap. Capacity is rounded up to a power of two so the
+// index wrap is a mask instead of a modulo.
+template <typename T>
+class RingBuffer {
+   public:
+    explicit RingBuffer(size_t capacity = 0)
+        : buffer_(roundUp(capacity)), mask_(buffer_.size() - 1) {}
+
+    void push_back(const T& value) {
+        if (full()) throw std::length_error("RingBuffer is full");
+        buffer_[(head_ + size_) & mask_] = value;
+        ++size_;
+    }
+
+    void push_back(T&& value) {
+        if (full()) throw std::length_error("RingBuffer is full");
+        buffer_[(head_ + size_) & mask_] = std::move(value);
+        ++size_;
+    }
+
+    template <typename... Args>
+    T& emplace_back(Args&&... args) {
+        if (full()) throw std::length_error("RingBuffer is full");
+        T& slot = buffer_[(head_ + size_) & mask_];
+        slot = T(std::forward<Args>(args)...);
+        ++size_;
+        return slot;
+    }
+
+    void pop_front() {
+        head_ = (head_ + 1) & mask_;
+        --size_;
+    }
+
+    void pop_back() { --size_; }
+
+    T& front() { return buffer_[head_]; }
+    const T& front() const { return buffer_[head_]; }
+    T& back() { return buffer_[(head_ + size_ - 1) & mask_]; }
+    const T& back() const { return buffer_[(head_ + size_ - 1) & mask_]; }
+
+    // Index 0 is the oldest element
+    T& operator[](size_t i) { return buffer_[(head_ + i) & mask_]; }
+    const T& operator[](size_t i) const { return buffer_[(head_ + i) & mask_]; }
+
+    size_t size() const { return size_; }
+    size_t capacity() const { return buffer_.size(); }
+    bool empty() const { return size_ == 0; }
+    bool full() const { return size_ == buffer_.size(); }
+
+    void clear() {
+        head_ = 0;
+        size_ = 0;
+    }
+
+   private:
+    static size_t roundUp(size_t n) {
+        size_t capacity = 1;
+        while (capacity < n) capacity <<= 1;
+        return capacity;
+    }
+
+    std::vector<T> buffer_;
+    size_t mask_;
+    size_t head_ = 0;
+    size_t size_ = 0;
+};
@@ -0,0 +1,301 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "backtest-cpp/types.h"
+
+// Compact binary encoding used for checkpoints. Values are stored as raw bytes in native
+// byte order, so a checkpoint restores bit-identical doubles but is only portable between
+// machines of the same architecture. Containers are prefixed with their element count.
+class BinaryWriter {
+   public:
+    void clear() { buffer_.clear(); }  // Keeps capacity, so repeated snapshots don't allocate
+    const std::vector<char>& data() const { return buffer_; }
+    size_t size() const { return buffer_.size(); }
+
+    template <typename T>
+        requires std::is_trivially_copyable_v<T>
+    void write(const T& value) {
+        const char* bytes = reinterpret_cast<const char*>(&value);
+        buffer_.insert(buffer_.end(), bytes, bytes + sizeof(T));
+    }
+
+    void write(const std::string& value) {
+        write<uint64_t>(value.size());
+        buffer_.insert(buffer_.end(), value.begin(), value.end());
+    }
+
+    template <typename T>
+    void write(const std::vector<T>& values) {
+        write(std::span<const T>(values));
+    }
+
+    // Same encoding as a vector, so it reads back into one
+    template <typename T>
+    void write(std::span<const T> values) {
+        write<uint64_t>(values.size());
+        if constexpr (std::is_trivially_copyable_v<T>) {
+            const char* bytes = reinterpret_cast<const char*>(values.data());
+            buffer_.insert(buffer_.end(), bytes, bytes + values.size() * sizeof(T));
+        } else {
+            for (const T& value : values) write(value);
+        }
+    }
+
+    template <typename T>
+    void write(const std::deque<T>& values) {
+        write<uint64_t>(values.size());
+        for (const T& value : values) write(value);
+    }
+
+    template <typename K, typename V>
+    void write(const std::map<K, V>& values) {
+        write<uint64_t>(values.size());
+        for (const auto& [key, value] : values) {
+            write(key);
+            write(value);
+        }
+    }
+
+    void write(const Bar& bar) {
+        write(bar.symbol);
+        write(bar.time);
+        write(bar.open);
+        write(bar.high);
+        write(bar.low);
+        write(bar.close);
+        write(bar.volume);
+        write(bar.synthetic);
+    }
+
+    void write(const Signal& signal) {
+        write(signal.time);
+        write(signal.symbol);
+        write(signal.type);
+    }
+
+    void write(const Order& order) {
+        write(order.time);
+        write(order.symbol);
+        write(order.direction);
+        write(order.price);
+        write(order.type);
+        write(order.quantity);
+    }
+
+    void write(const Trade& trade) {
+        write(trade.order);
+        write(trade.quantity);
+        write(trade.pnl);
+        write(trade.commission);
+        write(trade.entryTime);
+        write(trade.mae);
+        write(trade.mfe);
+    }
+
+    void write(const Position& position) {
+        write(position.symbol);
+        write(position.quantity);
+        write(position.averagePrice);
+        write(position.direction);
+        write(position.openTime);
+        write(position.lowPrice);
+        write(position.highPrice);
+    }
+
+    // Writes to `path + ".tmp"` first and renames, so a crash never leaves a torn file
+    void saveToFile(const std::string& path) const {
+        std::string tmpPath = path + ".tmp";
+        {
+            std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+            if (!file) {
+                throw std::runtime_error("Could not open " + tmpPath + " for writing");
+            }
+            file.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+            if (!file) {
+                throw std::runtime_error("Could not write " + tmpPath);
+            }
+        }
+        std::filesystem::rename(tmpPath, path);
+    }
+
+    // Appends to `path`, for journals whose readers stop at a known length
+    void appendToFile(const std::string& path) const {
+        std::ofstream file(path, std::ios::binary | std::ios::app);
+        file.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+        if (!file) {
+            throw std::runtime_error("Could not append to " + path);
+        }
+    }
+
+   private:
+    std::vector<char> buffer_;
+};
+
+class BinaryReader {
+   public:
+    explicit BinaryReader(std::vector<char> data) : data_(std::move(data)) {}
+
+    // The first `length` bytes of `path`, all of it by default
+    static BinaryReader fromFile(const std::string& path, size_t length = SIZE_MAX) {
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file) {
+            throw std::runtime_error("Could not open " + path);
+        }
+        size_t size = static_cast<size_t>(file.tellg());
+        if (length != SIZE_MAX && length > size) {
+            throw std::runtime_error(path + " is shorter than expected");
+        }
+        std::vector<char> data(std::min(size, length));
+        file.seekg(0);
+        file.read(data.data(), static_cast<std::streamsize>(data.size()));
+        return BinaryReader(std::move(data));
+    }
+
+    bool atEnd() const { return offset_ == data_.size(); }
+
+    template <typename T>
+    T read() {
+        T value{};
+        read(value);
+        return value;
+    }
+
+    template <typename T>
+        requires std::is_trivially_copyable_v<T>
+    void read(T& value) {
+        std::memcpy(&value, take(sizeof(T)), sizeof(T));
+    }
+
+    void read(std::string& value) {
+        size_t size = readSize();
+        const char* bytes = take(size);
+        value.assign(bytes, size);
+    }
+
+    template <typename T>
+    void read(std::vector<T>& values) {
+        size_t size = readSize();
+        if constexpr (std::is_trivially_copyable_v<T>) {
+            const char* bytes = take(size * sizeof(T));
+            values.resize(size);
+            if (size > 0) std::memcpy(values.data(), bytes, size * sizeof(T));
+        } else {
+            values.clear();
+            values.reserve(size);
+            for (size_t i = 0; i < size; ++i) values.push_back(read<T>());
+        }
+    }
+
+    // Reads a vector's elements onto the end of `values`
+    template <typename T>
+    void readAppend(std::vector<T>& values) {
+        size_t size = readSize();
+        if constexpr (std::is_trivially_copyable_v<T>) {
+            const char* bytes = take(size * sizeof(T));
+            size_t old = values.size();
+            values.resize(old + size);
+            if (size > 0) std::memcpy(values.data() + old, bytes, size * sizeof(T));
+        } else {
+            for (size_t i = 0; i < size; ++i) values.push_back(read<T>());
+        }
+    }
+
+    template <typename T>
+    void read(std::deque<T>& values) {
+        size_t size = readSize();
+        values.clear();
+        for (size_t i = 0; i < size; ++i) values.push_back(read<T>());
+    }
+
+    template <typename K, typename V>
+    void read(std::map<K, V>& values) {
+        size_t size = readSize();
+        values.clear();
+        for (size_t i = 0; i < size; ++i) {
+            K key = read<K>();
+            values.emplace_hint(values.end(), std::move(key), read<V>());
+        }
+    }
+
+    void read(Bar& bar) {
+        read(bar.symbol);
+        read(bar.time);
+        read(bar.open);
+        read(bar.high);
+        read(bar.low);
+        read(bar.close);
+        read(bar.volume);
+        read(bar.synthetic);
+    }
+
+    void read(Signal& signal) {
+        read(signal.time);
+        read(signal.symbol);
+        read(signal.type);
+    }
+
+    void read(Order& order) {
+        read(order.time);
+        read(order.symbol);
+        read(order.direction);
+        read(order.price);
+        read(order.type);
+        read(order.quantity);
+    }
+
+    void read(Trade& trade) {
+        read(trade.order);
+        read(trade.quantity);
+        read(trade.pnl);
+        read(trade.commission);
+        read(trade.entryTime);
+        read(trade.mae);
+        read(trade.mfe);
+    }
+
+    void read(Position& position) {
+        read(position.symbol);
+        read(position.quantity);
+        read(position.averagePrice);
+        read(position.direction);
+        read(position.openTime);
+        read(position.lowPrice);
+        read(position.highPrice);
+    }
+
+    // Reads an element count written as uint64_t, checked against the remaining bytes
+    size_t readSize() {
+        uint64_t size = 0;
+        read(size);
+        // Every element takes at least one byte, so this also rejects corrupt counts
+        if (size > data_.size() - offset_) {
+            throw std::runtime_error("Checkpoint data is truncated");
+        }
+        return static_cast<size_t>(size);
+    }
+
+   private:
+    const char* take(size_t bytes) {
+        if (bytes > data_.size() - offset_) {
+            throw std::runtime_error("Checkpoint data is truncated");
+        }
+        const char* ptr = data_.data() + offset_;
+        offset_ += bytes;
+        return ptr;
+    }
+
+    std::vector<char> data_;
+    size_t offset_ = 0;
+};
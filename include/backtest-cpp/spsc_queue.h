@@ -0,0 +1,77 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <vector>
+
+// Bounded lock-free queue between exactly one producer and one consumer thread. Slots are
+// preallocated and reused in place: the producer fills the slot tryClaim() returns and
+// publishes it, the consumer reads the slot tryPeek() returns and releases it, so slots
+// holding vectors keep their capacity and steady-state traffic never allocates. Each index
+// sits on its own cache line next to its owner's cached copy of the other index, so the
+// threads only touch each other's line when the queue looks full or empty.
+template <typename T>
+class SpscQueue {
+   public:
+    static constexpr size_t kCacheLine = 64;
+
+    explicit SpscQueue(size_t capacity)
+        : slots_(std::bit_ceil(std::max<size_t>(capacity, 2))), mask_(slots_.size() - 1) {}
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    // Producer: free slot to fill, or nullptr when full
+    T* tryClaim() {
+        size_t tail = producer_.tail.load(std::memory_order_relaxed);
+        if (tail - producer_.headCache == slots_.size()) {
+            producer_.headCache = consumer_.head.load(std::memory_order_acquire);
+            if (tail - producer_.headCache == slots_.size()) return nullptr;
+        }
+        return &slots_[tail & mask_];
+    }
+
+    // Producer: hands the claimed slot to the consumer; returns the slots in use right
+    // after. Reads the consumer's index, which also refreshes the cached copy for tryClaim.
+    size_t publish() {
+        size_t tail = producer_.tail.load(std::memory_order_relaxed) + 1;
+        producer_.tail.store(tail, std::memory_order_release);
+        producer_.headCache = consumer_.head.load(std::memory_order_acquire);
+        return tail - producer_.headCache;
+    }
+
+    // Consumer: oldest published slot, or nullptr when empty
+    T* tryPeek() {
+        size_t head = consumer_.head.load(std::memory_order_relaxed);
+        if (head == consumer_.tailCache) {
+            consumer_.tailCache = producer_.tail.load(std::memory_order_acquire);
+            if (head == consumer_.tailCache) return nullptr;
+        }
+        return &slots_[head & mask_];
+    }
+
+    // Consumer: returns the peeked slot to the producer
+    void release() {
+        size_t head = consumer_.head.load(std::memory_order_relaxed);
+        consumer_.head.store(head + 1, std::memory_order_release);
+    }
+
+    size_t capacity() const { return slots_.size(); }
+
+   private:
+    struct alignas(kCacheLine) Producer {
+        std::atomic<size_t> tail{0};
+        size_t headCache = 0;
+    };
+    struct alignas(kCacheLine) Consumer {
+        std::atomic<size_t> head{0};
+        size_t tailCache = 0;
+    };
+
+    Producer producer_;
+    Consumer consumer_;
+    alignas(kCacheLine) std::vector<T> slots_;
+    size_t mask_;
+};
@@ -0,0 +1,252 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <map>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "backtest-cpp/costs.h"
+#include "backtest-cpp/data.h"
+#include "backtest-cpp/engine.h"
+#include "backtest-cpp/indicator_graph.h"
+#include "backtest-cpp/performance.h"
+#include "backtest-cpp/portfolio.h"
+#include "backtest-cpp/strategy.h"
+
+// Output compiled into a Backtest; each level includes the ones before it
+enum class LogLevel { NONE, TRADES, ORDERS };
+
+// MaxSymbols value for a universe only known once the data is loaded
+inline constexpr size_t kDynamicSymbols = 0;
+
+// Per-symbol storage: a std::array when the universe size is a compile-time constant, a
+// std::vector grown to the widest cross-section otherwise
+template <typename T, size_t MaxSymbols>
+using SymbolArray = std::conditional_t<MaxSymbols == kDynamicSymbols, std::vector<T>,
+                                       std::array<T, MaxSymbols>>;
+
+struct BacktestConfig {
+    size_t warmupBars = 30;     // Bars handed to the strategy's onInit before trading starts
+    double maxInvest = 10'000;  // Passed to its generateOrders
+};
+
+// BacktestEngine with every choice made at compile time. The strategy type, commission and
+// slippage policies are template parameters, so their calls are direct and inlinable; the
+// universe size fixes the per-bar order and result buffers as std::arrays; and logging
+// below `Logging` is not compiled in at all. The loop calls the strategy and the Portfolio
+// in the engine's order without the event queue, so results and event counts are
+// identical to BasicBacktestEngine<S> with the same portfolio policies. Checkpoints are
+// not supported. The Backtest owns its Portfolio; the strategy is referenced.
+template <StaticStrategy S, CommissionModel Commission = FlatCommission,
+          SlippageModel Slippage = NoSlippage, size_t MaxSymbols = kDynamicSymbols,
+          LogLevel Logging = LogLevel::NONE>
+class Backtest {
+   public:
+    using PortfolioType = BasicPortfolio<Commission, Slippage, (Logging >= LogLevel::TRADES)>;
+
+    Backtest(const DataHandler& data, S& strategy, const PortfolioConfig& portfolio,
+             const BacktestConfig& config = {})
+        requires std::constructible_from<Commission, double> &&
+                 std::default_initializable<Slippage>
+        : Backtest(data, strategy, portfolio, Commission(portfolio.commission), Slippage{},
+                   config) {}
+
+    Backtest(const DataHandler& data, S& strategy, const PortfolioConfig& portfolio,
+             Commission commission, Slippage slippage, const BacktestConfig& config = {});
+
+    // Runs warm-up, the main loop and the final liquidation. Throws std::length_error at a
+    // bar with more symbols than MaxSymbols.
+    const EngineStats& run();
+
+    const std::vector<EquityPoint>& getEquityCurve() const { return equityCurve_; }
+    const EngineStats& getStats() const { return stats_; }
+    PortfolioType& getPortfolio() { return portfolio_; }
+    const PortfolioType& getPortfolio() const { return portfolio_; }
+
+   private:
+    static PortfolioConfig withLogging(PortfolioConfig config) {
+        config.logTrades = Logging >= LogLevel::TRADES;
+        return config;
+    }
+
+    void step(const std::map<std::string, Bar>& bars);
+    void placeOrders(const std::map<std::string, Bar>& bars);
+    void countFills(const std::map<std::string, Bar>& bars);
+
+    void count(EventType type, size_t n) {
+        stats_.events += n;
+        stats_.eventsByType[static_cast<size_t>(type)] += n;
+    }
+
+    const DataHandler& data_;
+    S& strategy_;
+    PortfolioType portfolio_;
+    BacktestConfig config_;
+
+    IndicatorGraph indicators_;
+    SignalBuffer signals_;
+    std::map<std::string, Signal> signalBatch_;
+    SymbolArray<Order, MaxSymbols> orders_;  // At most one order per symbol and bar
+    SymbolArray<ExecutionResult, MaxSymbols> results_;
+    std::vector<Order> fills_;
+    std::vector<EquityPoint> equityCurve_;
+    EngineStats stats_;
+};
+
+// ============================================================================
+// Implementation
+// ============================================================================
+
+template <StaticStrategy S, CommissionModel C, SlippageModel Sl, size_t N, LogLevel L>
+Backtest<S, C, Sl, N, L>::Backtest(const DataHandler& data, S& strategy,
+                                   const PortfolioConfig& portfolio, C commission, Sl slippage,
+                                   const BacktestConfig& config)
+    : data_(data),
+      strategy_(strategy),
+      portfolio_(withLogging(portfolio), std::move(commission), std::move(slippage)),
+      config_(config) {
+    if constexpr (N != kDynamicSymbols) {
+        signals_ = SignalBuffer(N);
+        fills_.reserve(N);
+    }
+}
+
+template <StaticStrategy S, CommissionModel C, SlippageModel Sl, size_t N, LogLevel L>
+const EngineStats& Backtest<S, C, Sl, N, L>::run() {
+    auto start = std::chrono::steady_clock::now();
+    const size_t numBars = data_.size();
+    const size_t warmup = std::min(config_.warmupBars, numBars);
+
+    std::vector<std::map<std::string, Bar>> history;
+    history.reserve(warmup);
+    for (size_t i = 0; i < warmup; ++i) {
+        history.push_back(data_.getBarsAt(i));
+    }
+    if constexpr (requires { strategy_.onInit(history, indicators_); }) {
+        strategy_.onInit(history, indicators_);
+    } else {
+        strategy_.onInit(history);
+    }
+    if (!indicators_.empty()) {
+        indicators_.warmUp(history);
+    }
+
+    equityCurve_.clear();
+    equityCurve_.reserve(numBars - warmup + 1);
+    stats_ = {};
+
+    const std::map<std::string, Bar>* bars = nullptr;
+    for (size_t i = warmup; i < numBars; ++i) {
+        bars = &data_.getBarsAt(i);
+        step(*bars);
+    }
+
+    // Final liquidation
+    if (bars != nullptr) {
+        portfolio_.closeAllPositions(*bars);
+        equityCurve_.push_back({bars->begin()->second.time, portfolio_.getTotalEquity(*bars)});
+    }
+
+    stats_.elapsedSeconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return stats_;
+}
+
+// One bar in the engine's MARKET -> SIGNAL -> ORDER -> FILL order
+template <StaticStrategy S, CommissionModel C, SlippageModel Sl, size_t N, LogLevel L>
+void Backtest<S, C, Sl, N, L>::step(const std::map<std::string, Bar>& bars) {
+    // Orders are keyed by symbol and priced off this bar, so never more than its symbols
+    if constexpr (N == kDynamicSymbols) {
+        if (bars.size() > orders_.size()) {
+            orders_.resize(bars.size());
+            results_.resize(bars.size());
+        }
+    } else if (bars.size() > N) {
+        throw std::length_error("Backtest compiled for " + std::to_string(N) +
+                                " symbols, got a bar with " + std::to_string(bars.size()));
+    }
+    count(EventType::MARKET, 1);
+    portfolio_.markToMarket(bars);
+
+    // Orders delayed by the latency model fill on the first bar after they arrive
+    fills_.clear();
+    if (portfolio_.hasLatency()) {
+        portfolio_.processPendingOrders(bars, &fills_);
+    }
+
+    if (!indicators_.empty()) {
+        indicators_.update(bars);
+    }
+    signals_.clear();
+    strategy_.onBars(bars, portfolio_.getCurrentPositions(), signals_);
+    countFills(bars);  // The engine hands these to onFill after onBars too
+    count(EventType::SIGNAL, signals_.count());
+    if (!signals_.empty()) {
+        placeOrders(bars);
+    }
+
+    equityCurve_.push_back({bars.begin()->second.time, portfolio_.getTotalEquity(bars)});
+    ++stats_.bars;
+}
+
+template <StaticStrategy S, CommissionModel C, SlippageModel Sl, size_t N, LogLevel L>
+void Backtest<S, C, Sl, N, L>::placeOrders(const std::map<std::string, Bar>& bars) {
+    signalBatch_.clear();
+    signals_.forEach([this](const Signal& signal) {
+        signalBatch_.insert_or_assign(signal.symbol, signal);
+    });
+    std::map<std::string, Order> orders = strategy_.generateOrders(
+        signalBatch_, bars, config_.maxInvest, portfolio_.getCurrentPositions());
+
+    size_t numOrders = 0;
+    for (auto& [symbol, order] : orders) {
+        if (order.quantity == 0) continue;
+        if constexpr (L >= LogLevel::ORDERS) {
+            std::cout << "Order at bar " << stats_.bars << ": "
+                      << (order.direction == SignalType::BUY ? "BUY " : "SELL ") << order.quantity
+                      << " @ " << order.price << std::endl;
+        }
+        orders_[numOrders++] = std::move(order);
+    }
+    count(EventType::ORDER, numOrders);
+
+    if (!portfolio_.hasLatency()) {
+        if (numOrders != 0) {
+            fills_.clear();
+            portfolio_.executeOrders(std::span<const Order>(orders_.data(), numOrders),
+                                     std::span<ExecutionResult>(results_.data(), numOrders),
+                                     &fills_, &bars);
+            countFills(bars);
+        }
+        return;
+    }
+    for (size_t i = 0; i < numOrders; ++i) {
+        fills_.clear();
+        portfolio_.submitOrder(orders_[i], false, &fills_, bars.at(orders_[i].symbol).volume);
+        countFills(bars);
+    }
+}
+
+// FILL events of fills_: counted, passed to the strategy's onFill if it has one, logged
+template <StaticStrategy S, CommissionModel C, SlippageModel Sl, size_t N, LogLevel L>
+void Backtest<S, C, Sl, N, L>::countFills(const std::map<std::string, Bar>& bars) {
+    count(EventType::FILL, fills_.size());
+    for (const Order& fill : fills_) {
+        if constexpr (requires { strategy_.onFill(fill); }) {
+            strategy_.onFill(fill);
+        }
+        if constexpr (L >= LogLevel::ORDERS) {
+            std::cout << "INFO | Filled " << fill.quantity << " " << fill.symbol << " @ "
+                      << fill.price << std::endl;
+            std::cout << "INFO | Total Equity After: " << portfolio_.getTotalEquity(bars)
+                      << std::endl;
+        }
+    }
+}
@@ -1,20 +1,133 @@
 #pragma once
 
+#include <concepts>
+#include <cstdint>
 #include <cstring>
 #include <deque>
 #include <map>
 #include <optional>
+#include <string>
 #include <vector>
 
+#include "backtest-cpp/indicator_graph.h"
+#include "backtest-cpp/serialization.h"
+#include "backtest-cpp/symbol_table.h"
 #include "backtest-cpp/types.h"
 
+// Signals of one bar, written by the strategy into a buffer the caller owns and reuses.
+// Each symbol gets a fixed slot the first time it signals, so once every symbol has been
+// seen set() and clear() never allocate.
+class SignalBuffer {
+   public:
+    SignalBuffer() = default;
+    explicit SignalBuffer(size_t numSymbols) {
+        symbols_.reserve(numSymbols);
+        signals_.reserve(numSymbols);
+        isSet_.reserve(numSymbols);
+        active_.reserve(numSymbols);
+    }
+
+    // Slot of `symbol`, assigned on first use. Strategies may cache it and call set(slot, ...)
+    size_t slotOf(const std::string& symbol) {
+        uint32_t slot = symbols_.intern(symbol);
+        if (slot == signals_.size()) {
+            signals_.push_back(Signal{.time = 0, .symbol = symbol, .type = SignalType::HOLD});
+            isSet_.push_back(0);
+        }
+        return slot;
+    }
+
+    // Overwrites any earlier signal of the same symbol in this bar
+    void set(size_t slot, const Signal& signal) {
+        signals_[slot] = signal;
+        if (!isSet_[slot]) {
+            isSet_[slot] = 1;
+            active_.push_back(static_cast<uint32_t>(slot));
+        }
+    }
+    void set(const Signal& signal) { set(slotOf(signal.symbol), signal); }
+
+    const Signal* get(size_t slot) const { return isSet_[slot] ? &signals_[slot] : nullptr; }
+
+    bool empty() const { return active_.empty(); }
+    size_t count() const { return active_.size(); }
+    size_t numSymbols() const { return signals_.size(); }
+
+    // Signals set since the last clear(), in the order they were first set
+    template <typename F>
+    void forEach(F&& f) const {
+        for (uint32_t slot : active_) f(signals_[slot]);
+    }
+
+    void clear() {
+        for (uint32_t slot : active_) isSet_[slot] = 0;
+        active_.clear();
+    }
+
+   private:
+    SymbolTable symbols_;  // Slot = symbol id
+    std::vector<Signal> signals_;
+    std::vector<uint8_t> isSet_;
+    std::vector<uint32_t> active_;
+};
+
+// Interface the engine is written against. Strategies satisfying it directly are called
+// without virtual dispatch (see BasicBacktestEngine); the Strategy base class satisfies it
+// too, so virtual strategies keep working through a reference to the base.
+template <typename S>
+concept StaticStrategy =
+    requires(S& strategy, const std::vector<std::map<std::string, Bar>>& history,
+             const std::map<std::string, Bar>& bars, std::map<std::string, Position>& positions,
+             const std::map<std::string, Signal>& batch, const double& maxInvest,
+             SignalBuffer& signals, BinaryWriter& writer, BinaryReader& reader) {
+        strategy.onInit(history);
+        strategy.onBars(bars, positions, signals);
+        {
+            strategy.generateOrders(batch, bars, maxInvest, positions)
+        } -> std::same_as<std::map<std::string, Order>>;
+        strategy.saveState(writer);
+        strategy.loadState(reader);
+    };
+
+// Appends the orders of `strategy`'s map-based generateOrders for `signals` to `orders`, in
+// symbol order. Adapts strategies without the buffer-based overload.
+template <typename S>
+void generateOrdersFromMap(S& strategy, const SignalBuffer& signals,
+                           const std::map<std::string, Bar>& currentBars, const double& maxInvest,
+                           std::map<std::string, Position>& positions, std::vector<Order>& orders) {
+    std::map<std::string, Signal> batch;
+    signals.forEach([&](const Signal& signal) { batch.insert_or_assign(signal.symbol, signal); });
+    std::map<std::string, Order> generated =
+        strategy.generateOrders(batch, currentBars, maxInvest, positions);
+    for (auto& [symbol, order] : generated) orders.push_back(std::move(order));
+}
+
 class Strategy {
    public:
     virtual ~Strategy() = default;
     virtual void onInit(const std::vector<std::map<std::string, Bar>>& availableData) = 0;
 
+    // Variant used by the engine: declare shared indicators in `indicators` and read them
+    // in onBars. The engine warms the graph up on the same history after every strategy has
+    // declared its nodes and updates it before each onBars. The default ignores the graph.
+    virtual void onInit(const std::vector<std::map<std::string, Bar>>& availableData,
+                        IndicatorGraph& /*indicators*/) {
+        onInit(availableData);
+    }
+
     virtual std::map<std::string, std::optional<Signal>> onBars(
-        std::map<std::string, Bar>& bars, std::map<std::string, Position>& positions) = 0;
+        const std::map<std::string, Bar>& bars, std::map<std::string, Position>& positions) = 0;
+
+    // Buffer-based variant used by the engine. The default adapts the map-returning onBars,
+    // so existing strategies work unchanged; override it to avoid the per-bar allocation.
+    virtual void onBars(const std::map<std::string, Bar>& bars,
+                        std::map<std::string, Position>& positions, SignalBuffer& signals) {
+        for (const auto& [symbol, signal] : onBars(bars, positions)) {
+            if (signal.has_value()) {
+                signals.set(signal.value());
+            }
+        }
+    }
 
     virtual Order generateOrder(const Signal& signal, const Bar& currentBar,
                                 const double& maxInvest,
@@ -23,4 +136,33 @@ class Strategy {
     virtual std::map<std::string, Order> generateOrders(
         const std::map<std::string, Signal>& signals, const std::map<std::string, Bar>& currentBars,
         const double& maxInvest, std::map<std::string, Position>& positions) = 0;
-};
\ No newline at end of file
+
+    // Buffer-based variant used by the engine: appends the orders for `signals` to `orders`,
+    // which the engine executes in that order. The default adapts the map-returning
+    // generateOrders; override it to avoid the per-bar allocation.
+    virtual void generateOrders(const SignalBuffer& signals,
+                                const std::map<std::string, Bar>& currentBars,
+                                const double& maxInvest, std::map<std::string, Position>& positions,
+                                std::vector<Order>& orders) {
+        generateOrdersFromMap(*this, signals, currentBars, maxInvest, positions, orders);
+    }
+
+    // Called for every fill of the strategy's orders once the portfolio has applied it
+    virtual void onFill(const Order& /*fill*/) {}
+
+    // Whether onBars reads the positions it is handed or state kept by onFill. Engines that
+    // evaluate onBars ahead of the accounting (PipelinedEngine) only take strategies that
+    // return false; the default assumes it does.
+    virtual bool readsPortfolio() const { return true; }
+
+    // Checkpoint hooks: store everything onBars depends on (indicator windows, flags).
+    // Stateless strategies can keep the defaults.
+    virtual void saveState(BinaryWriter& /*writer*/) const {}
+    virtual void loadState(BinaryReader& /*reader*/) {}
+    // Counterpart of the graph onInit on resume, called with the graph already restored
+    virtual void loadState(BinaryReader& reader, IndicatorGraph& /*indicators*/) {
+        loadState(reader);
+    }
+};
+
+static_assert(StaticStrategy<Strategy>);
@@ -0,0 +1,186 @@
+#pragma once
+
+#include <algorithm>
+#include <concepts>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "backtest-cpp/data.h"
+#include "backtest-cpp/engine.h"
+#include "backtest-cpp/performance.h"
+#include "backtest-cpp/portfolio.h"
+#include "backtest-cpp/strategy.h"
+#include "backtest-cpp/thread_pool.h"
+#include "backtest-cpp/vectorized.h"
+
+struct SMAParams {
+    int shortPeriod;
+    int longPeriod;
+};
+
+// Inclusive range of integer parameter values
+struct ParamRange {
+    int from;
+    int to;
+    int step = 1;
+};
+
+// Every combination with shortPeriod < longPeriod, short-major
+std::vector<SMAParams> gridSearch(const ParamRange& shortPeriods, const ParamRange& longPeriods);
+
+// `count` distinct combinations drawn uniformly from the grid, reproducible for a seed
+std::vector<SMAParams> randomSearch(const ParamRange& shortPeriods, const ParamRange& longPeriods,
+                                    size_t count, uint64_t seed = 42);
+
+// Warm-up shared by every run of a sweep, at least each long period, so all combinations
+// trade the same bars
+size_t commonWarmup(size_t warmupBars, std::span<const SMAParams> params);
+
+struct SweepResult {
+    SMAParams params;
+    double annualizedReturn = 0.0;
+    double annualizedVolatility = 0.0;
+    double sharpe = 0.0;
+    double realizedPnL = 0.0;
+    double finalEquity = 0.0;
+    size_t trades = 0;
+};
+
+struct SweepConfig {
+    PortfolioConfig portfolio;  // Every run gets a fresh Portfolio from this
+    EngineConfig engine;        // Order logging is turned off for sweeps
+    Frequency frequency = Frequency::MINUTE;
+    size_t threads = 0;  // 0 = one per hardware thread
+};
+
+// Backtests SMACrossover for many parameter sets on a ThreadPool. The data is loaded once
+// and only read; each run owns its strategy, portfolio and engine, so runs share nothing
+// mutable and scale with the number of cores. Every run's portfolio is a P, Portfolio by
+// default, built from the config and the cost models given to the constructor.
+template <AnyPortfolio P = Portfolio>
+class BasicParameterSweep {
+   public:
+    using Commission = typename P::CommissionType;
+    using Slippage = typename P::SlippageType;
+
+    BasicParameterSweep(const DataHandler& data, const SweepConfig& config)
+        requires std::constructible_from<Commission, double> &&
+                 std::default_initializable<Slippage>
+        : BasicParameterSweep(data, config, Commission(config.portfolio.commission),
+                              Slippage{}) {}
+
+    BasicParameterSweep(const DataHandler& data, const SweepConfig& config,
+                        Commission commission, Slippage slippage = {});
+
+    // results[i] belongs to params[i], independent of thread count and scheduling. All runs
+    // warm up over the longest long period in `params`, so they trade the same bars.
+    std::vector<SweepResult> run(std::span<const SMAParams> params) const;
+
+    // A single run on the calling thread, warmed up over at least its long period
+    SweepResult runOne(const SMAParams& params) const;
+
+   private:
+    SweepResult runOne(const SMAParams& params, size_t warmupBars) const;
+
+    const DataHandler& data_;
+    SweepConfig config_;
+    Commission commission_;
+    Slippage slippage_;
+};
+
+using ParameterSweep = BasicParameterSweep<>;
+
+// Instantiated once in sweep.cpp
+extern template class BasicParameterSweep<Portfolio>;
+
+// The same sweep with the work shared across parameter sets: one prefix sum over the
+// closes, from which every window's mean is an O(1) difference, and a single pass over time
+// that advances all combinations together. Each block of bars computes the means of the
+// distinct windows once for every pair using them, and each pair keeps only a
+// SimulatedPosition and running return sums instead of an equity curve. Needs zero latency.
+class SharedSMASweep {
+   public:
+    SharedSMASweep(const BarColumns& bars, const SweepConfig& config);
+
+    // Same contract and, up to rounding in the metrics, same results as ParameterSweep::run
+    std::vector<SweepResult> run(std::span<const SMAParams> params) const;
+
+    // Every combination over bars [begin, end) only, on the calling thread: each starts flat
+    // at `begin` with its means over the full history before it, so `begin` must be at least
+    // every long period, and is closed out at the last close before `end`. With one curve per
+    // combination, curves[i] receives the equity curve BacktestEngine would record.
+    std::vector<SweepResult> runRange(std::span<const SMAParams> params, size_t begin,
+                                      size_t end,
+                                      std::span<std::vector<EquityPoint>> curves = {}) const;
+
+   private:
+    static void checkParams(std::span<const SMAParams> params);
+
+    // Runs params[i] over [begin, end) into results[i] for one chunk of the combinations
+    void runChunk(std::span<const SMAParams> params, size_t begin, size_t end,
+                  std::span<SweepResult> results,
+                  std::span<std::vector<EquityPoint>> curves) const;
+
+    const BarColumns& bars_;
+    SweepConfig config_;
+    std::vector<double> prefix_;  // prefixSum of the closes
+};
+
+// ============================================================================
+// Implementation
+// ============================================================================
+
+namespace detail {
+// The swept strategy, defined with the strategies in sweep.cpp
+std::unique_ptr<Strategy> makeSMACrossover(const SMAParams& params);
+// Metrics of a finished run from its equity curve and trades
+SweepResult sweepResult(const SMAParams& params, const std::vector<EquityPoint>& curve,
+                        double realizedPnL, size_t trades, Frequency frequency);
+}  // namespace detail
+
+template <AnyPortfolio P>
+BasicParameterSweep<P>::BasicParameterSweep(const DataHandler& data, const SweepConfig& config,
+                                            Commission commission, Slippage slippage)
+    : data_(data),
+      config_(config),
+      commission_(std::move(commission)),
+      slippage_(std::move(slippage)) {
+    silenceLogs(config_.engine, config_.portfolio);
+}
+
+template <AnyPortfolio P>
+std::vector<SweepResult> BasicParameterSweep<P>::run(std::span<const SMAParams> params) const {
+    std::vector<SweepResult> results(params.size());
+    const size_t warmup = commonWarmup(config_.engine.warmupBars, params);
+
+    ThreadPool pool(config_.threads);
+    for (size_t i = 0; i < params.size(); ++i) {
+        // Every task writes its own slot, so the table needs no lock
+        pool.submit([this, &params, &results, i, warmup] {
+            results[i] = runOne(params[i], warmup);
+        });
+    }
+    pool.wait();
+    return results;
+}
+
+template <AnyPortfolio P>
+SweepResult BasicParameterSweep<P>::runOne(const SMAParams& params) const {
+    return runOne(params, std::max(config_.engine.warmupBars,
+                                   static_cast<size_t>(std::max(params.longPeriod, 0))));
+}
+
+template <AnyPortfolio P>
+SweepResult BasicParameterSweep<P>::runOne(const SMAParams& params, size_t warmupBars) const {
+    P portfolio(config_.portfolio, commission_, slippage_);
+    std::unique_ptr<Strategy> strategy = detail::makeSMACrossover(params);
+    EngineConfig engineConfig = config_.engine;
+    engineConfig.warmupBars = warmupBars;
+
+    BasicBacktestEngine<Strategy, P> engine(data_, *strategy, portfolio, engineConfig);
+    engine.run();
+    return detail::sweepResult(params, engine.getEquityCurve(), portfolio.getRealizedPnL(),
+                               portfolio.getTradeStats().trades, config_.frequency);
+}
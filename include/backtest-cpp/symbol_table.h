@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "backtest-cpp/serialization.h"
+
+// Interns instrument names into dense ids 0..size()-1, so per-symbol state can live in
+// plain arrays indexed by id instead of maps keyed by string
+class SymbolTable {
+   public:
+    // Id of `symbol`, assigned on first use
+    uint32_t intern(const std::string& symbol) {
+        auto [it, inserted] = ids_.try_emplace(symbol, static_cast<uint32_t>(names_.size()));
+        if (inserted) {
+            names_.push_back(symbol);
+        }
+        return it->second;
+    }
+
+    std::optional<uint32_t> find(const std::string& symbol) const {
+        auto it = ids_.find(symbol);
+        if (it == ids_.end()) return std::nullopt;
+        return it->second;
+    }
+
+    const std::string& name(uint32_t id) const { return names_[id]; }
+    size_t size() const { return names_.size(); }
+
+    void reserve(size_t numSymbols) {
+        ids_.reserve(numSymbols);
+        names_.reserve(numSymbols);
+    }
+
+    void saveState(BinaryWriter& writer) const { writer.write(names_); }
+    void loadState(BinaryReader& reader) {
+        std::vector<std::string> names;
+        reader.read(names);
+        ids_.clear();
+        names_.clear();
+        for (const std::string& name : names) intern(name);
+    }
+
+   private:
+    std::unordered_map<std::string, uint32_t> ids_;
+    std::vector<std::string> names_;
+};
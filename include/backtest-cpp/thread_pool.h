@@ -0,0 +1,52 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads with one task deque each. A worker takes its newest task
+// from the back of its own deque and, once that is empty, steals the oldest task from the
+// front of another's, so long and short tasks balance out without a shared queue every
+// worker contends on. Tasks submitted from inside a task go to the submitting worker.
+class ThreadPool {
+   public:
+    explicit ThreadPool(size_t numThreads = 0);  // 0 = one per hardware thread
+    ~ThreadPool();                               // Finishes queued tasks, then joins
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void submit(std::function<void()> task);
+
+    // Blocks until every submitted task has run; rethrows the first exception a task threw
+    void wait();
+
+    size_t size() const { return threads_.size(); }
+
+   private:
+    struct Worker {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    void workerLoop(size_t index);
+    bool tryTake(size_t index, std::function<void()>& task);
+
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::vector<std::thread> threads_;
+
+    std::mutex mutex_;  // Guards the counters below
+    std::condition_variable wake_;
+    std::condition_variable idle_;
+    size_t queued_ = 0;      // Tasks sitting in a deque
+    size_t unfinished_ = 0;  // Queued or running
+    size_t nextWorker_ = 0;  // Round robin for submits from outside the pool
+    bool stop_ = false;
+    std::exception_ptr error_;
+};
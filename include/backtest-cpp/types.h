@@ -22,6 +22,9 @@ struct Bar {
     double low;
     double close;
     long volume;
+    // Forward-filled by DataHandler::synchronize: marks positions at the last close, but
+    // nothing traded, so strategies do not signal on it and the Portfolio does not fill on it
+    bool synthetic = false;
 };
 
 struct Signal {
@@ -41,9 +44,12 @@ struct Order {
 
 struct Trade {
     Order order;
-    int quantity;
+    int quantity;  // Closed part of the position, with the position's sign
     double pnl;
     double commission;
+    int64_t entryTime = 0;  // Time the closed position was opened
+    double mae = 0.0;       // Maximum adverse excursion of the closed quantity, <= 0
+    double mfe = 0.0;       // Maximum favorable excursion of the closed quantity, >= 0
 };
 
 struct Position {
@@ -51,4 +57,7 @@ struct Position {
     int quantity;
     double averagePrice;
     SignalType direction;
+    int64_t openTime = 0;
+    double lowPrice = 0.0;  // Price range seen while open, for MAE/MFE
+    double highPrice = 0.0;
 };
@@ -0,0 +1,153 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "backtest-cpp/data.h"
+#include "backtest-cpp/performance.h"
+#include "backtest-cpp/portfolio.h"
+#include "backtest-cpp/types.h"
+
+// Bars of one symbol as structure-of-arrays columns
+struct BarColumns {
+    std::string symbol = {};
+    std::vector<int64_t> time = {};
+    std::vector<double> open = {};
+    std::vector<double> high = {};
+    std::vector<double> low = {};
+    std::vector<double> close = {};
+    std::vector<long> volume = {};
+
+    size_t size() const { return time.size(); }
+
+    // Every bar of `symbol` in data order; bars without it, or with a synthetic one, are skipped
+    static BarColumns fromData(const DataHandler& data, const std::string& symbol);
+};
+
+// ============================================================================
+// Column kernels: one branch-free pass over contiguous arrays each, so they vectorize
+// ============================================================================
+
+// prefix[0] = 0, prefix[i + 1] = values[0] + ... + values[i]; prefix.size() == values.size() + 1
+void prefixSum(std::span<const double> values, std::span<double> prefix);
+
+// out[i] = mean of the last `period` values up to i, taken from prefixSum's output. Before
+// the window is full it is the mean of what has been seen so far, like SMA::value().
+void rollingMean(std::span<const double> prefix, size_t period, std::span<double> out);
+
+// +1 at i where fast moves above slow, -1 where it moves back to or below it, else 0
+void crossoverSignals(std::span<const double> fast, std::span<const double> slow,
+                      std::span<int8_t> out);
+
+// ============================================================================
+// Vectorized SMA crossover backtest
+// ============================================================================
+
+// One symbol's position with Portfolio's cash accounting under a flat commission and no
+// slippage: the bookkeeping of the engine's batch path, without the maps and strings.
+class SimulatedPosition {
+   public:
+    struct Closed {
+        int quantity;  // Part of the old position that was closed, as Trade::quantity
+        double pnl;
+        int64_t entryTime;  // Trade::entryTime, mae and mfe
+        double mae;
+        double mfe;
+    };
+
+    explicit SimulatedPosition(const PortfolioConfig& config = {});
+
+    // Pre-trade checks of Portfolio::executeOrders for a single order
+    bool accepts(int quantity, double price) const;
+
+    // Portfolio::executeOrder through the same bookFill; returns the closed part when the
+    // fill reduces, closes or reverses the position
+    std::optional<Closed> fill(int quantity, double price, int64_t time);
+
+    // Portfolio::markToMarket: widens the price range seen while open, for MAE/MFE
+    void mark(double low, double high) {
+        low_ = std::min(low_, low);
+        high_ = std::max(high_, high);
+    }
+
+    // Portfolio::getTotalEquity: |position value| + cash
+    double equity(double close) const { return std::fabs(quantity_ * close) + cash_; }
+
+    int quantity() const { return quantity_; }
+    double cash() const { return cash_; }
+
+   private:
+    int quantity_ = 0;
+    double averagePrice_ = 0.0;
+    double cash_ = 0.0;
+    double commission_ = 0.0;
+    double leverage_ = 1.0;
+    int maxPositionSize_ = 0;
+    int64_t openTime_ = 0;
+    double low_ = 0.0;
+    double high_ = 0.0;
+};
+
+// SMACrossover::generateOrders: order that takes `position` to +-floor(maxInvest / open)
+inline int crossoverOrderQuantity(int8_t signal, double open, double maxInvest, int position) {
+    int target = static_cast<int>(std::floor(maxInvest / open));
+    return (signal > 0 ? target : -target) - position;
+}
+
+struct VectorizedConfig {
+    int shortPeriod = 10;
+    int longPeriod = 30;
+    size_t warmupBars = 30;     // As EngineConfig: no orders before this bar
+    double maxInvest = 10'000;  // Target notional per position, as SMACrossover
+};
+
+struct VectorizedResult {
+    std::vector<EquityPoint> equityCurve;  // Same points as BacktestEngine::getEquityCurve()
+    std::vector<int> positions;            // Position after each bar
+    std::vector<Trade> trades;
+    size_t fills = 0;  // Including the final liquidation
+
+    double realizedPnL() const;
+};
+
+// SMACrossover run over whole columns instead of bar events: indicators, crossover signals
+// and marks are array passes, only the (sparse) fills are simulated one by one. Fills
+// follow BacktestEngine + Portfolio without latency or slippage and with a flat commission,
+// including their risk checks and cash accounting, so both produce the same result.
+// Prefix-sum means are bit-identical to SMABank for tick-sized prices, whose sums are exact
+// in a double; arbitrary prices can differ in the last bits, which only matters for exact
+// ties between the two averages.
+class VectorizedBacktest {
+   public:
+    explicit VectorizedBacktest(const PortfolioConfig& portfolio,
+                                const VectorizedConfig& config = {});
+
+    // Scratch columns are kept between runs, so repeated runs don't allocate
+    const VectorizedResult& run(const BarColumns& bars);
+
+    // Indicator columns of the last run
+    std::span<const double> shortMA() const { return shortMA_; }
+    std::span<const double> longMA() const { return longMA_; }
+
+   private:
+    void simulateFills(const BarColumns& bars);  // Also writes positions and the curve
+    void applyFill(const BarColumns& bars, size_t index, int quantity, double price);
+
+    PortfolioConfig portfolio_;
+    VectorizedConfig config_;
+
+    std::vector<double> prefix_;
+    std::vector<double> shortMA_;
+    std::vector<double> longMA_;
+    std::vector<int8_t> signals_;
+
+    SimulatedPosition position_;
+    size_t nextMark_ = 0;  // First bar not yet marked into position_
+
+    VectorizedResult result_;
+};
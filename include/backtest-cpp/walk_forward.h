@@ -0,0 +1,58 @@
+#pragma once
+
+#include <span>
+#include <vector>
+
+#include "backtest-cpp/performance.h"
+#include "backtest-cpp/sweep.h"
+#include "backtest-cpp/vectorized.h"
+
+enum class WindowMode { ROLLING, ANCHORED };
+
+struct WalkForwardConfig {
+    size_t inSampleBars = 2'000;
+    size_t outOfSampleBars = 500;
+    WindowMode mode = WindowMode::ROLLING;  // ANCHORED grows every in-sample window from bar 0
+};
+
+// One fold: optimize on [inSampleBegin, inSampleEnd), then trade [inSampleEnd, outOfSampleEnd)
+struct WalkForwardWindow {
+    size_t inSampleBegin;
+    size_t inSampleEnd;
+    size_t outOfSampleEnd;
+};
+
+// Folds stepping by outOfSampleBars from `firstBar`, so the out-of-sample windows tile the
+// rest of the data without overlap; the last one is cut at `numBars`
+std::vector<WalkForwardWindow> walkForwardWindows(size_t numBars, size_t firstBar,
+                                                  const WalkForwardConfig& config);
+
+struct WalkForwardFold {
+    WalkForwardWindow window = {};
+    SweepResult inSample = {};     // Best in-sample combination by Sharpe
+    SweepResult outOfSample = {};  // The same combination on the out-of-sample window
+};
+
+struct WalkForwardResult {
+    std::vector<WalkForwardFold> folds;
+    std::vector<EquityPoint> equityCurve;  // Out-of-sample curves compounded end to end
+};
+
+// Walk-forward optimization of SMACrossover. Every fold's in-sample sweep is a
+// SharedSMASweep range over the one loaded BarColumns, and the folds run in parallel on a
+// ThreadPool. Means come from the shared prefix sum over the full history, so a window
+// starts with warm indicators and no fold replays another's warm-up.
+class WalkForward {
+   public:
+    WalkForward(const BarColumns& bars, const SweepConfig& sweep, const WalkForwardConfig& config);
+
+    // The winner of each in-sample window trades the next window from flat with the sweep's
+    // initial cash; the stitched curve chains those runs' returns for Performance
+    WalkForwardResult run(std::span<const SMAParams> params) const;
+
+   private:
+    const BarColumns& bars_;
+    SweepConfig sweepConfig_;
+    WalkForwardConfig config_;
+    SharedSMASweep sweep_;
+};
@@ -0,0 +1,144 @@
+#include "backtest-cpp/batch_metrics.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+#include "backtest-cpp/thread_pool.h"
+
+namespace {
+
+// Running sums of Performance::riskMetrics for a block of runs, one array per sum. Counts
+// are doubles so every array has the same lane width.
+struct BlockSums {
+    explicit BlockSums(size_t n)
+        : returns(n), shift(n), s1(n), s2(n), s3(n), s4(n), downside2(n), gains(n), peak(n),
+          maxDrawdown(n), drawdown2(n), underwater(n), maxUnderwater(n) {}
+
+    std::vector<double> returns;  // Of the current point, shared by every sum below
+    std::vector<double> shift, s1, s2, s3, s4, downside2, gains;
+    std::vector<double> peak, maxDrawdown, drawdown2, underwater, maxUnderwater;
+};
+
+// The loop body of Performance::riskMetrics, one lane per run. __restrict lets the
+// compiler vectorize without runtime overlap checks.
+void accumulateKernel(const double* __restrict equity, const double* __restrict r,
+                      const double* __restrict shift, double* __restrict s1,
+                      double* __restrict s2, double* __restrict s3, double* __restrict s4,
+                      double* __restrict downside2, double* __restrict gains,
+                      double* __restrict peak, double* __restrict maxDrawdown,
+                      double* __restrict drawdown2, double* __restrict underwater,
+                      double* __restrict maxUnderwater, size_t n) {
+    // Ternaries in place of std::min/max, which return references that GCC loads through a
+    // selected address and then won't vectorize; the comparisons are the same, so are the
+    // results
+    for (size_t j = 0; j < n; ++j) {
+        double e = equity[j];
+        double d = r[j] - shift[j];
+        double d2 = d * d;
+        s1[j] += d;
+        s2[j] += d2;
+        s3[j] += d2 * d;
+        s4[j] += d2 * d2;
+        double loss = 0.0 < r[j] ? 0.0 : r[j];
+        downside2[j] = std::fma(loss, loss, downside2[j]);
+        gains[j] += r[j] > 0.0 ? 1.0 : 0.0;
+
+        double below = e >= peak[j] ? 0.0 : underwater[j] + 1.0;
+        underwater[j] = below;
+        maxUnderwater[j] = maxUnderwater[j] < below ? below : maxUnderwater[j];
+        double high = peak[j] < e ? e : peak[j];
+        peak[j] = high;
+        double drawdown = high > 0.0 ? (high - e) / high : 0.0;
+        maxDrawdown[j] = maxDrawdown[j] < drawdown ? drawdown : maxDrawdown[j];
+        drawdown2[j] += drawdown * drawdown;
+    }
+}
+
+void runBlock(const EquityMatrix& curves, size_t begin, size_t end,
+              const BatchMetricsConfig& config, std::vector<RiskMetrics>& results) {
+    const size_t n = end - begin;
+    const size_t stride = curves.runs;
+    const double* equity = curves.equity.data() + begin;
+    BlockSums sums(n);
+
+    // Point 0 starts the peaks; the first returns are the shifts
+    std::copy(equity, equity + n, sums.peak.begin());
+    for (size_t j = 0; j < n; ++j) {
+        sums.shift[j] = std::log(equity[stride + j] / equity[j]);
+    }
+
+    for (size_t t = 1; t < curves.points(); ++t) {
+        const double* row = equity + t * stride;
+        const double* previous = row - stride;
+        // std::log does not vectorize without -ffast-math, so it is its own scalar loop
+        for (size_t j = 0; j < n; ++j) sums.returns[j] = std::log(row[j] / previous[j]);
+
+        accumulateKernel(row, sums.returns.data(), sums.shift.data(), sums.s1.data(),
+                         sums.s2.data(), sums.s3.data(), sums.s4.data(), sums.downside2.data(),
+                         sums.gains.data(), sums.peak.data(), sums.maxDrawdown.data(),
+                         sums.drawdown2.data(), sums.underwater.data(), sums.maxUnderwater.data(),
+                         n);
+    }
+
+    const size_t last = (curves.points() - 1) * stride;
+    for (size_t j = 0; j < n; ++j) {
+        double s1 = sums.s1[j], s2 = sums.s2[j], s3 = sums.s3[j], s4 = sums.s4[j];
+        double mean = s1 / static_cast<double>(curves.points() - 1);
+        RiskSums run{
+            .points = curves.points(),
+            .first = equity[j],
+            .last = equity[last + j],
+            .m2 = std::max(0.0, s2 - mean * s1),
+            .m3 = s3 - 3.0 * mean * s2 + 2.0 * mean * mean * s1,
+            .m4 = s4 - 4.0 * mean * s3 + 6.0 * mean * mean * s2 - 3.0 * mean * mean * mean * s1,
+            .downside2 = sums.downside2[j],
+            .gains = static_cast<size_t>(sums.gains[j]),
+            .maxDrawdown = sums.maxDrawdown[j],
+            .drawdown2 = sums.drawdown2[j],
+            .maxUnderwater = static_cast<size_t>(sums.maxUnderwater[j])};
+        results[begin + j] = Performance::riskMetrics(run, config.frequency, config.riskFreeRate);
+    }
+}
+
+}  // namespace
+
+EquityMatrix EquityMatrix::fromCurves(const std::vector<std::vector<EquityPoint>>& curves) {
+    EquityMatrix matrix;
+    if (curves.empty()) return matrix;
+
+    const size_t points = curves.front().size();
+    matrix.runs = curves.size();
+    matrix.time.resize(points);
+    matrix.equity.resize(points * curves.size());
+    for (size_t t = 0; t < points; ++t) matrix.time[t] = curves.front()[t].time;
+    for (size_t run = 0; run < curves.size(); ++run) {
+        if (curves[run].size() != points) {
+            throw std::invalid_argument("EquityMatrix needs curves of equal length");
+        }
+        for (size_t t = 0; t < points; ++t) matrix.at(t, run) = curves[run][t].equity;
+    }
+    return matrix;
+}
+
+std::vector<RiskMetrics> batchRiskMetrics(const EquityMatrix& curves,
+                                          const BatchMetricsConfig& config) {
+    if (curves.points() < 3) throw std::runtime_error("Equity curve too short");
+    if (curves.equity.size() != curves.points() * curves.runs) {
+        throw std::invalid_argument("EquityMatrix holds " + std::to_string(curves.equity.size()) +
+                                    " equities for " + std::to_string(curves.points()) +
+                                    " points of " + std::to_string(curves.runs) + " runs");
+    }
+
+    std::vector<RiskMetrics> results(curves.runs);
+    const size_t block = std::max<size_t>(config.blockRuns, 1);
+    ThreadPool pool(config.threads);
+    for (size_t begin = 0; begin < curves.runs; begin += block) {
+        size_t end = std::min(begin + block, curves.runs);
+        // Every task writes its own slice of results
+        pool.submit([&, begin, end] { runBlock(curves, begin, end, config, results); });
+    }
+    pool.wait();
+    return results;
+}
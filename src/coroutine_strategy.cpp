@@ -0,0 +1,286 @@
+#include "backtest-cpp/coroutine_strategy.h"
+
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+
+// -------------------------------------------------
+// FramePool
+// -------------------------------------------------
+
+namespace {
+// Keeps the frame behind the header aligned like ::operator new would
+constexpr size_t kFrameHeader = alignof(std::max_align_t);
+
+// Makes the frames created in its scope come from `pool`
+class ActivePool {
+   public:
+    explicit ActivePool(FramePool& pool) : outer_(FramePool::activate(&pool)) {}
+    ~ActivePool() { FramePool::activate(outer_); }
+    ActivePool(const ActivePool&) = delete;
+    ActivePool& operator=(const ActivePool&) = delete;
+
+   private:
+    FramePool* outer_;
+};
+}  // namespace
+
+void* FramePool::allocate(FramePool* pool, size_t size) {
+    size_t sizeClass = (size + kFrameHeader + kClassSize - 1) / kClassSize;
+    if (sizeClass >= kClasses) pool = nullptr;
+
+    std::byte* block = pool != nullptr
+                           ? pool->take(sizeClass)
+                           : static_cast<std::byte*>(::operator new(size + kFrameHeader));
+    *reinterpret_cast<FramePool**>(block) = pool;
+    return block + kFrameHeader;
+}
+
+void FramePool::deallocate(void* frame, size_t size) {
+    std::byte* block = static_cast<std::byte*>(frame) - kFrameHeader;
+    FramePool* pool = *reinterpret_cast<FramePool**>(block);
+    if (pool == nullptr) {
+        ::operator delete(block);
+        return;
+    }
+    pool->give(block, (size + kFrameHeader + kClassSize - 1) / kClassSize);
+}
+
+std::byte* FramePool::take(size_t sizeClass) {
+    ++live_;
+    if (std::byte* block = free_[sizeClass]) {
+        free_[sizeClass] = *reinterpret_cast<std::byte**>(block);
+        return block;
+    }
+
+    size_t bytes = sizeClass * kClassSize;
+    if (chunkUsed_ + bytes > kChunkSize) {
+        chunks_.push_back(std::make_unique<std::byte[]>(kChunkSize));
+        chunkUsed_ = 0;
+    }
+    std::byte* block = chunks_.back().get() + chunkUsed_;
+    chunkUsed_ += bytes;
+    return block;
+}
+
+void FramePool::give(std::byte* block, size_t sizeClass) {
+    --live_;
+    *reinterpret_cast<std::byte**>(block) = free_[sizeClass];
+    free_[sizeClass] = block;
+}
+
+// -------------------------------------------------
+// CoroutineStrategy
+// -------------------------------------------------
+
+CoroutineStrategy::~CoroutineStrategy() = default;
+
+void CoroutineStrategy::onInit(const std::vector<std::map<std::string, Bar>>& availableData) {
+    ownsIndicators_ = true;
+    start(availableData);
+    ownIndicators_.warmUp(availableData);
+}
+
+void CoroutineStrategy::onInit(const std::vector<std::map<std::string, Bar>>& availableData,
+                               IndicatorGraph& indicators) {
+    ownsIndicators_ = false;
+    sharedIndicators_ = &indicators;
+    start(availableData);
+}
+
+void CoroutineStrategy::start(const std::vector<std::map<std::string, Bar>>& history) {
+    roots_.clear();
+    barCount_ = 0;
+    history_ = &history;
+    bars_ = history.empty() ? nullptr : &history.back();
+    ActivePool active(framePool_);
+    spawn(run());
+    history_ = nullptr;
+}
+
+void CoroutineStrategy::spawn(Task task) {
+    uint32_t slot = 0;
+    while (slot < roots_.size() && !roots_[slot].task.done()) ++slot;
+    if (slot == roots_.size()) roots_.emplace_back(Root{.task = std::move(task)});
+    else roots_[slot] = Root{.task = std::move(task)};
+
+    Root& root = roots_[slot];
+    root.startedAt = barCount_;
+    Task::Handle handle = root.task.handle_;
+    handle.promise().root = slot;
+    handle.resume();  // May spawn in turn and move roots_
+    if (handle.done() && handle.promise().error) {
+        std::rethrow_exception(handle.promise().error);
+    }
+}
+
+size_t CoroutineStrategy::numTasks() const {
+    size_t running = 0;
+    for (const Root& root : roots_) running += !root.task.done();
+    return running;
+}
+
+std::map<std::string, std::optional<Signal>> CoroutineStrategy::onBars(
+    const std::map<std::string, Bar>& bars, std::map<std::string, Position>& positions) {
+    scratch_.clear();
+    onBars(bars, positions, scratch_);
+
+    std::map<std::string, std::optional<Signal>> signalMap;
+    scratch_.forEach([&](const Signal& signal) { signalMap[signal.symbol] = signal; });
+    return signalMap;
+}
+
+void CoroutineStrategy::onBars(const std::map<std::string, Bar>& bars,
+                               std::map<std::string, Position>& positions,
+                               SignalBuffer& signals) {
+    if (ownsIndicators_ && !ownIndicators_.empty()) {
+        ownIndicators_.update(bars);
+    }
+
+    ++barCount_;
+    bars_ = &bars;
+    positions_ = &positions;
+    signals_ = &signals;
+    ActivePool active(framePool_);
+
+    // By index: a resumed task may spawn and grow roots_
+    for (size_t i = 0; i < roots_.size(); ++i) {
+        Root& root = roots_[i];
+        if (root.task.done() || root.startedAt == barCount_) continue;
+
+        bool resume = false;
+        switch (root.wait.kind) {
+            case WaitKind::BARS:
+                resume = --root.wait.bars == 0;
+                break;
+            case WaitKind::TIME:
+                resume = bars.begin()->second.time >= root.wait.time;
+                break;
+            case WaitKind::FILL:
+                resume = root.filled;
+                break;
+        }
+        if (!resume) continue;
+
+        Task::Handle top = root.task.handle_;
+        root.wait.handle.resume();
+        if (top.done() && top.promise().error) {
+            signals_ = nullptr;
+            std::rethrow_exception(top.promise().error);
+        }
+    }
+
+    signals_ = nullptr;
+}
+
+void CoroutineStrategy::onFill(const Order& fill) {
+    std::optional<uint32_t> id = symbols_.find(fill.symbol);
+    if (!id) return;
+
+    for (Root& root : roots_) {
+        if (!root.task.done() && root.wait.kind == WaitKind::FILL && root.wait.symbol == *id &&
+            !root.filled) {
+            root.fill = fill;
+            root.filled = true;
+        }
+    }
+}
+
+CoroutineStrategy::BarAwaiter CoroutineStrategy::nextBar() { return skipBars(1); }
+
+CoroutineStrategy::BarAwaiter CoroutineStrategy::skipBars(size_t count) {
+    return {this, Wait{.kind = WaitKind::BARS, .bars = count}};
+}
+
+CoroutineStrategy::BarAwaiter CoroutineStrategy::waitUntil(int64_t time) {
+    return {this, Wait{.kind = WaitKind::TIME, .time = time}};
+}
+
+CoroutineStrategy::FillAwaiter CoroutineStrategy::nextFill(const std::string& symbol) {
+    uint32_t id = symbols_.intern(symbol);
+    if (id >= intents_.size()) intents_.resize(symbols_.size());
+    return {this, id};
+}
+
+// -------------------------------------------------
+// Orders
+// -------------------------------------------------
+
+void CoroutineStrategy::trade(const std::string& symbol, int quantity) {
+    if (quantity == 0) return;
+    setIntent(symbol, Intent{.quantity = quantity},
+              quantity > 0 ? SignalType::BUY : SignalType::SELL);
+}
+
+void CoroutineStrategy::target(const std::string& symbol, double fraction) {
+    SignalType direction = fraction > 0.0   ? SignalType::BUY
+                           : fraction < 0.0 ? SignalType::SELL
+                           : position(symbol) > 0 ? SignalType::SELL
+                                                  : SignalType::BUY;
+    setIntent(symbol, Intent{.isTarget = true, .fraction = fraction}, direction);
+}
+
+void CoroutineStrategy::setIntent(const std::string& symbol, const Intent& intent,
+                                  SignalType direction) {
+    if (signals_ == nullptr) {
+        throw std::logic_error("Orders can only be placed while a bar is handled");
+    }
+    uint32_t id = symbols_.intern(symbol);
+    if (id >= intents_.size()) intents_.resize(symbols_.size());
+    intents_[id] = intent;
+    signals_->set(Signal{bars_->at(symbol).time, symbol, direction});
+}
+
+int CoroutineStrategy::position(const std::string& symbol) const {
+    if (positions_ == nullptr) return 0;
+    auto it = positions_->find(symbol);
+    return it != positions_->end() ? it->second.quantity : 0;
+}
+
+int CoroutineStrategy::orderQuantity(const Intent& intent, const Bar& bar, double maxInvest,
+                                     int currentPosition) const {
+    if (!intent.isTarget) return intent.quantity;
+
+    int size = static_cast<int>(std::floor(std::abs(intent.fraction) * maxInvest / bar.open));
+    return (intent.fraction < 0.0 ? -size : size) - currentPosition;
+}
+
+Order CoroutineStrategy::generateOrder(const Signal& signal, const Bar& currentBar,
+                                       const double& maxInvest,
+                                       std::map<std::string, Position>& positions) {
+    std::optional<uint32_t> id = symbols_.find(signal.symbol);
+    auto it = positions.find(signal.symbol);
+    int currentPosition = it != positions.end() ? it->second.quantity : 0;
+    int quantity = id ? orderQuantity(intents_[*id], currentBar, maxInvest, currentPosition) : 0;
+    return Order{signal.time,      signal.symbol,     signal.type,
+                 currentBar.close, OrderType::MARKET, quantity};
+}
+
+std::map<std::string, Order> CoroutineStrategy::generateOrders(
+    const std::map<std::string, Signal>& signals, const std::map<std::string, Bar>& currentBars,
+    const double& maxInvest, std::map<std::string, Position>& positions) {
+    std::map<std::string, Order> orderMap;
+    for (const auto& [symbol, signal] : signals) {
+        orderMap[symbol] = generateOrder(signal, currentBars.at(symbol), maxInvest, positions);
+    }
+    return orderMap;
+}
+
+void CoroutineStrategy::generateOrders(const SignalBuffer& signals,
+                                       const std::map<std::string, Bar>& currentBars,
+                                       const double& maxInvest,
+                                       std::map<std::string, Position>& positions,
+                                       std::vector<Order>& orders) {
+    signals.forEach([&](const Signal& signal) {
+        orders.push_back(
+            generateOrder(signal, currentBars.at(signal.symbol), maxInvest, positions));
+    });
+}
+
+void CoroutineStrategy::saveState(BinaryWriter& /*writer*/) const {
+    throw std::runtime_error("Coroutine strategies cannot be checkpointed");
+}
+
+void CoroutineStrategy::loadState(BinaryReader& /*reader*/) {
+    throw std::runtime_error("Coroutine strategies cannot be checkpointed");
+}
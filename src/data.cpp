@@ -1,10 +1,13 @@
 #include "backtest-cpp/data.h"
 
+#include <algorithm>
 #include <filesystem>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <set>
 #include <sstream>
+#include <unordered_map>
 #include <vector>
 
 #include "backtest-cpp/utils.h"
@@ -65,18 +68,51 @@ void DataHandler::loadAllCSVs(const std::string& directory) {
             counter++;
         }
     }
-    std::cout << "Loaded " << counter << " csv files";
+    std::cout << "Loaded " << counter << " csv files" << std::endl;
+    synchronize();
+}
+
+void DataHandler::synchronize() {
+    synchronize(instrumentData_);
 }
 
 void DataHandler::synchronize(std::vector<std::map<std::string, Bar>>& rawData) {
-    // Collects all unique timestamps from all loaded instruments
-    // Sorts them chronologically
-    // For each timestamp:
-
-    // Check which instruments have bars at that timestamp
-    // For instruments without data at that timestamp, use their most recent bar (forward-fill)
-    // Store the complete map in synchronizedBars_
-    return;
+    // Collects all bars from all loaded instruments, sorted chronologically
+    std::vector<const Bar*> bars;
+    for (const auto& symbolBars : rawData) {
+        for (const auto& [symbol, bar] : symbolBars) bars.push_back(&bar);
+    }
+    std::stable_sort(bars.begin(), bars.end(),
+                     [](const Bar* a, const Bar* b) { return a->time < b->time; });
+
+    // One map per timestamp. Instruments without data at that timestamp are forward-filled
+    // from their most recent bar as a flat, zero-volume Bar::synthetic bar, so positions in
+    // them keep a price while strategies and the Portfolio skip them.
+    std::vector<std::map<std::string, Bar>> synchronized;
+    std::map<std::string, Bar> latest;
+    for (size_t i = 0; i < bars.size();) {
+        int64_t time = bars[i]->time;
+        for (; i < bars.size() && bars[i]->time == time; ++i) {
+            latest[bars[i]->symbol] = *bars[i];
+        }
+
+        std::map<std::string, Bar>& snapshot = synchronized.emplace_back(latest);
+        for (auto& [symbol, bar] : snapshot) {
+            if (bar.time != time) {
+                bar = Bar{.symbol = symbol,
+                          .time = time,
+                          .open = bar.close,
+                          .high = bar.close,
+                          .low = bar.close,
+                          .close = bar.close,
+                          .volume = 0,
+                          .synthetic = true};
+            }
+        }
+    }
+
+    instrumentData_ = std::move(synchronized);
+    currentIndex_ = 0;
 }
 
 std::map<std::string, Bar> DataHandler::getCurrentBars() const {
@@ -98,6 +134,13 @@ std::map<std::string, Bar> DataHandler::getNextBars() {
     return instrumentData_[currentIndex_++];
 }
 
+const std::map<std::string, Bar>& DataHandler::getBarsAt(size_t index) const {
+    if (index >= instrumentData_.size()) {
+        throw std::out_of_range("Bar index out of bounds");
+    }
+    return instrumentData_[index];
+}
+
 bool DataHandler::hasMoreData() const {
     return currentIndex_ < instrumentData_.size();
 }
@@ -108,4 +151,54 @@ void DataHandler::reset() {
 
 size_t DataHandler::size() const {
     return instrumentData_.size();
-}
\ No newline at end of file
+}
+
+std::vector<std::string> DataHandler::symbols() const {
+    std::set<std::string> all;
+    for (const auto& bars : instrumentData_) {
+        for (const auto& [symbol, bar] : bars) all.insert(symbol);
+    }
+    return {all.begin(), all.end()};
+}
+
+std::vector<DataHandler> DataHandler::split(
+    const std::vector<std::vector<std::string>>& groups) const {
+    std::unordered_map<std::string, size_t> groupOf;
+    for (size_t g = 0; g < groups.size(); ++g) {
+        for (const std::string& symbol : groups[g]) groupOf.emplace(symbol, g);
+    }
+
+    std::vector<DataHandler> parts(groups.size());
+
+    // Each bar is read once, so the cost does not grow with the number of groups
+    std::vector<std::map<std::string, Bar>> current(groups.size());
+    for (const auto& bars : instrumentData_) {
+        for (const auto& [symbol, bar] : bars) {
+            if (auto it = groupOf.find(symbol); it != groupOf.end()) {
+                current[it->second].emplace_hint(current[it->second].end(), symbol, bar);
+            }
+        }
+        for (size_t g = 0; g < groups.size(); ++g) {
+            if (current[g].empty()) continue;
+            parts[g].instrumentData_.push_back(std::move(current[g]));
+            current[g].clear();
+        }
+    }
+    return parts;
+}
+
+void DataHandler::saveState(BinaryWriter& writer) const {
+    writer.write<uint64_t>(instrumentData_.size());
+    writer.write<uint64_t>(currentIndex_);
+}
+
+void DataHandler::loadState(BinaryReader& reader) {
+    if (reader.read<uint64_t>() != instrumentData_.size()) {
+        throw std::runtime_error("Checkpoint was written for a different data set");
+    }
+    size_t index = reader.read<uint64_t>();
+    if (index > instrumentData_.size()) {
+        throw std::out_of_range("Checkpoint cursor is past the end of the data");
+    }
+    currentIndex_ = index;
+}
@@ -0,0 +1,9 @@
+#include "backtest-cpp/engine.h"
+
+double EngineStats::eventsPerSecond() const {
+    return elapsedSeconds > 0.0 ? static_cast<double>(events) / elapsedSeconds : 0.0;
+}
+
+// The member definitions live in engine.h so the engine can be instantiated on a concrete
+// strategy type. The virtual-dispatch configuration is compiled once here.
+template class BasicBacktestEngine<Strategy>;
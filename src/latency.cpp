@@ -0,0 +1,63 @@
+#include "backtest-cpp/latency.h"
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <stdexcept>
+
+LatencyModel::LatencyModel(const LatencyConfig& config) : config_(config), rng_(config.seed) {}
+
+int64_t LatencyModel::sample(const std::string& symbol) {
+    int64_t delay = config_.delayNs;
+    if (!config_.perSymbolNs.empty()) {
+        auto it = config_.perSymbolNs.find(symbol);
+        if (it != config_.perSymbolNs.end()) {
+            delay = it->second;
+        }
+    }
+
+    if (config_.jitterNs <= 0) {
+        return delay;
+    }
+
+    switch (config_.type) {
+        case LatencyType::UNIFORM: {
+            std::uniform_int_distribution<int64_t> dist(0, config_.jitterNs);
+            delay += dist(rng_);
+            break;
+        }
+        case LatencyType::NORMAL: {
+            std::normal_distribution<double> dist(0.0, static_cast<double>(config_.jitterNs));
+            delay += static_cast<int64_t>(std::llround(dist(rng_)));
+            break;
+        }
+        case LatencyType::FIXED:
+            break;
+    }
+
+    return std::max<int64_t>(delay, 0);
+}
+
+bool LatencyModel::isZero() const {
+    if (config_.delayNs != 0) return false;
+    if (config_.jitterNs != 0 && config_.type != LatencyType::FIXED) return false;
+    for (const auto& [symbol, delay] : config_.perSymbolNs) {
+        if (delay != 0) return false;
+    }
+    return true;
+}
+
+void LatencyModel::saveState(BinaryWriter& writer) const {
+    // The standard only defines the engine state through its stream operators
+    std::ostringstream state;
+    state << rng_;
+    writer.write(state.str());
+}
+
+void LatencyModel::loadState(BinaryReader& reader) {
+    std::istringstream state(reader.read<std::string>());
+    state >> rng_;
+    if (!state) {
+        throw std::runtime_error("Invalid latency model state");
+    }
+}
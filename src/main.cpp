@@ -1,10 +1,9 @@
 #include <iomanip>
 #include <iostream>
-#include <optional>
-#include <vector>
 
 #include "../strategies/smacrossover.h"
 #include "backtest-cpp/data.h"
+#include "backtest-cpp/engine.h"
 #include "backtest-cpp/performance.h"
 #include "backtest-cpp/portfolio.h"
 
@@ -19,113 +18,49 @@ int main() {
 
     SMACrossover strategy(10, 30);
 
-    // dataHandler.loadCSV("../data/Mini.csv", "NQ");
-    dataHandler.loadCSV("../data/NQ_sample.csv", "NQ");
+    dataHandler.loadCSV("../data/Mini.csv", "NQ");
     // dataHandler.loadAllCSVs("../data");
 
-    // -------------------------------------------------
-    // Strategy warm-up (SMA lookback)
-    // -------------------------------------------------
-    std::vector<std::map<std::string, Bar>> historicalData;
-
-    for (int i = 0; i < 30 && dataHandler.hasMoreData(); ++i) {
-        std::cout << "Added Bar" << std::endl;
-        historicalData.push_back(dataHandler.getNextBars());
-    }
-    strategy.onInit(historicalData);
+    BacktestEngine engine(dataHandler, strategy, portfolio,
+                          {.warmupBars = 30,
+                           .maxInvest = 10'000,
+                           .logOrders = true,
+                           .keepEquityCurve = false});
 
     std::cout << "Starting backtest..." << std::endl;
 
-    // -------------------------------------------------
-    // Equity curve storage
-    // -------------------------------------------------
-    std::vector<EquityPoint> equityCurve;
-    equityCurve.reserve(100000);  // avoid reallocations
-
-    int barCount = 0;
-
     // -------------------------------------------------
     // Main backtest loop
     // -------------------------------------------------
-    while (dataHandler.hasMoreData()) {
-        std::map<std::string, Bar> bars = dataHandler.getNextBars();
-
-        auto posIt = portfolio.getCurrentPositions().find("NQ");
-        if (posIt != portfolio.getCurrentPositions().end() && bars.find("NQ") == bars.end()) {
-            std::cerr << "BUG: Have NQ position but bars doesn't contain NQ at bar " << barCount
-                      << std::endl;
-        }
-
-        std::map<std::string, std::optional<Signal>> signalMap =
-            strategy.onBars(bars, portfolio.getCurrentPositions());
-
-        for (const auto& [symbol, signal] : signalMap) {
-            if (signal.has_value()) {
-                Order order = strategy.generateOrder(signal.value(), bars[symbol], 10'000,
-                                                     portfolio.getCurrentPositions());
-
-                std::cout << "Order at bar " << barCount << ": "
-                          << (signal->type == SignalType::BUY ? "BUY " : "SELL ") << order.quantity
-                          << " @ " << bars[symbol].close << std::endl;
-
-                std::cout << "INFO | Unrealized PnL : " << portfolio.getUnrealizedPnL(bars)
-                          << " | Realized PnL : " << portfolio.getRealizedPnL() << std::endl;
-
-                std::cout << "INFO | Total Equity Before: " << portfolio.getTotalEquity(bars)
-                          << std::endl;
-
-                portfolio.executeOrder(order, true);
-
-                std::cout << "INFO | Total Equity After: " << std::setprecision(7)
-                          << portfolio.getTotalEquity(bars) << std::endl;
-
-                std::cout << "DEBUG: equity: " << portfolio.getTotalEquity(bars) << std::endl;
-
-                auto it = portfolio.getCurrentPositions().find("NQ");
-                std::cout << "INFO | Total Positions After: "
-                          << (it != portfolio.getCurrentPositions().end() ? it->second.quantity : 0)
-                          << std::endl;
-
-                std::cout << "----------------------------------------------" << std::endl;
-            }
-        }
-        // std::cout << "DEBUG: Logged time: " << bars.begin()->second.time << std::endl;
-        // std::cout << "DEBUG: Logged Equity: " << portfolio.getTotalEquity(bars) << std::endl;
-
-        // Record equity every bar (CRITICAL)
-        equityCurve.push_back({bars.begin()->second.time, portfolio.getTotalEquity(bars)});
-
-        ++barCount;
-    }
-    std::cout << "Finished loop" << std::endl;
-    // -------------------------------------------------
-    // Final liquidation
-    // -------------------------------------------------
-    std::map<std::string, Bar> finalBars = dataHandler.getCurrentBars();
-    portfolio.closeAllPositions(finalBars);
-
-    equityCurve.push_back({finalBars.begin()->second.time, portfolio.getTotalEquity(finalBars)});
+    const EngineStats& stats = engine.run();
+    const PerformanceAccumulator& performance = engine.getPerformance();
 
     // -------------------------------------------------
-
     // Backtest summary
     // -------------------------------------------------
     std::cout << "\n=== Backtest Complete ===" << std::endl;
-    std::cout << "Bars processed : " << barCount << std::endl;
-    std::cout << "Trades         : " << portfolio.getAllTrades().size() << std::endl;
+    std::cout << "Bars processed : " << stats.bars << std::endl;
+    std::cout << "Events         : " << stats.events << " (" << stats.eventsPerSecond()
+              << " events/s)" << std::endl;
+    const TradeStats& trades = portfolio.getTradeStats();
+    std::cout << "Trades         : " << trades.trades << std::endl;
     std::cout << "Realized PnL   : " << portfolio.getRealizedPnL() << std::endl;
-    std::cout << "Final Equity   : " << portfolio.getTotalEquity(finalBars) << std::endl;
+    std::cout << "Final Equity   : " << performance.lastEquity() << std::endl;
+    std::cout << "Win Rate       : " << trades.winRate() * 100 << " %" << std::endl;
+    std::cout << "Profit Factor  : " << trades.profitFactor() << std::endl;
+    std::cout << "Avg MAE / MFE  : " << trades.averageMae() << " / " << trades.averageMfe()
+              << std::endl;
 
     // -------------------------------------------------
     // Performance statistics
     // -------------------------------------------------
     std::cout << "\n=== Performance Statistics ===" << std::endl;
 
-    double annReturn = Performance::annualizedReturn(equityCurve, Frequency::MINUTE);
+    double annReturn = performance.annualizedReturn(Frequency::MINUTE);
 
-    double annVol = Performance::annualizedVolatility(equityCurve, Frequency::MINUTE);
+    double annVol = performance.annualizedVolatility(Frequency::MINUTE);
 
-    double sharpe = Performance::sharpeRatio(equityCurve, Frequency::MINUTE, 0.0);
+    double sharpe = performance.sharpeRatio(Frequency::MINUTE, 0.0);
 
     std::cout << std::fixed << std::setprecision(4);
     std::cout << "Annualized Return : " << annReturn * 100 << " %" << std::endl;
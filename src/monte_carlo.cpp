@@ -0,0 +1,204 @@
+#include "backtest-cpp/monte_carlo.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <stdexcept>
+
+#include "backtest-cpp/thread_pool.h"
+
+namespace {
+
+// Performance's annualized return, volatility and Sharpe for a path of equities, plus max
+// drawdown. `returns` is scratch space reused across samples.
+SampleStats measure(const std::vector<double>& path, double periodsPerYear,
+                    std::vector<double>& returns) {
+    SampleStats stats;
+    if (path.empty()) return stats;
+    stats.finalEquity = path.back();
+
+    double peak = path.front();
+    bool ruined = false;
+    for (double equity : path) {
+        peak = std::max(peak, equity);
+        if (peak > 0.0) stats.maxDrawdown = std::max(stats.maxDrawdown, (peak - equity) / peak);
+        ruined |= equity <= 0.0;
+    }
+    if (ruined) {
+        stats.sharpe = -std::numeric_limits<double>::infinity();
+        return stats;
+    }
+    if (path.size() < 3) return stats;
+
+    const double periods = static_cast<double>(path.size() - 1);
+    double annualizedReturn =
+        std::pow(path.back() / path.front(), periodsPerYear / periods) - 1.0;
+
+    returns.clear();
+    for (size_t i = 1; i < path.size(); ++i) {
+        returns.push_back(std::log(path[i] / path[i - 1]));
+    }
+    double mean = 0.0;
+    for (double r : returns) mean += r;
+    mean /= returns.size();
+    double var = 0.0;
+    for (double r : returns) var += (r - mean) * (r - mean);
+    var /= (returns.size() - 1);
+
+    double annualizedVolatility = std::sqrt(var * periodsPerYear);
+    stats.sharpe = annualizedVolatility == 0.0 ? 0.0 : annualizedReturn / annualizedVolatility;
+    return stats;
+}
+
+// Percentile interval by linear interpolation between order statistics
+Interval interval(std::vector<double> values, double confidence) {
+    Interval result;
+    if (values.empty()) return result;
+    std::sort(values.begin(), values.end());
+
+    auto quantile = [&values](double q) {
+        double position = q * static_cast<double>(values.size() - 1);
+        size_t below = static_cast<size_t>(position);
+        size_t above = std::min(below + 1, values.size() - 1);
+        double weight = position - static_cast<double>(below);
+        if (weight == 0.0) return values[below];
+        return values[below] + weight * (values[above] - values[below]);
+    };
+    result.lower = quantile((1.0 - confidence) / 2.0);
+    result.median = quantile(0.5);
+    result.upper = quantile((1.0 + confidence) / 2.0);
+    return result;
+}
+
+void checkTrades(std::span<const Trade> trades, size_t periods) {
+    if (trades.empty()) throw std::invalid_argument("Monte Carlo needs at least one trade");
+    if (periods == 0) throw std::invalid_argument("Monte Carlo needs the bars the trades span");
+}
+
+}  // namespace
+
+MonteCarlo::MonteCarlo(const MonteCarloConfig& config) : config_(config) {
+    if (config_.confidence <= 0.0 || config_.confidence >= 1.0) {
+        throw std::invalid_argument("Confidence must be in (0, 1)");
+    }
+    if (config_.blockLength == 0) {
+        throw std::invalid_argument("Bootstrap blocks must be at least one return long");
+    }
+}
+
+MonteCarloResult MonteCarlo::shuffleTrades(std::span<const Trade> trades, double initialCash,
+                                           size_t periods) const {
+    checkTrades(trades, periods);
+    auto sample = [&](Philox& rng, std::vector<double>& path) {
+        path.resize(trades.size() + 1);
+        for (size_t k = 0; k < trades.size(); ++k) path[k + 1] = trades[k].pnl;
+        // Fisher-Yates over the PnLs, then accumulate them into equity
+        for (size_t k = trades.size(); k > 1; --k) {
+            std::swap(path[k], path[1 + rng.below(k)]);
+        }
+        path[0] = initialCash;
+        for (size_t k = 1; k < path.size(); ++k) path[k] += path[k - 1];
+    };
+    double periodsPerYear = Performance::getAnnualization(config_.frequency).periodsPerYear;
+    return run(sample, periodsPerYear * trades.size() / periods);
+}
+
+MonteCarloResult MonteCarlo::bootstrapTrades(std::span<const Trade> trades, double initialCash,
+                                             size_t periods) const {
+    checkTrades(trades, periods);
+    auto sample = [&](Philox& rng, std::vector<double>& path) {
+        path.resize(trades.size() + 1);
+        path[0] = initialCash;
+        for (size_t k = 1; k < path.size(); ++k) {
+            path[k] = path[k - 1] + trades[rng.below(trades.size())].pnl;
+        }
+    };
+    double periodsPerYear = Performance::getAnnualization(config_.frequency).periodsPerYear;
+    return run(sample, periodsPerYear * trades.size() / periods);
+}
+
+MonteCarloResult MonteCarlo::jitterFills(std::span<const Trade> trades, double initialCash,
+                                         size_t periods) const {
+    checkTrades(trades, periods);
+    const double maxSlippage = config_.slippageTicks * config_.tickSize;
+    auto sample = [&](Philox& rng, std::vector<double>& path) {
+        path.resize(trades.size() + 1);
+        path[0] = initialCash;
+        for (size_t k = 1; k < path.size(); ++k) {
+            const Trade& trade = trades[k - 1];
+            double slippage = (rng.uniform() + rng.uniform()) * maxSlippage;
+            path[k] = path[k - 1] + trade.pnl - std::abs(trade.quantity) * slippage;
+        }
+    };
+    double periodsPerYear = Performance::getAnnualization(config_.frequency).periodsPerYear;
+    return run(sample, periodsPerYear * trades.size() / periods);
+}
+
+MonteCarloResult MonteCarlo::blockBootstrap(const std::vector<EquityPoint>& curve) const {
+    if (curve.size() < 3) throw std::invalid_argument("Equity curve too short");
+    std::vector<double> returns;
+    for (size_t i = 1; i < curve.size(); ++i) {
+        if (curve[i - 1].equity <= 0.0 || curve[i].equity <= 0.0) {
+            throw std::invalid_argument("Block bootstrap needs a positive equity curve");
+        }
+        returns.push_back(std::log(curve[i].equity / curve[i - 1].equity));
+    }
+
+    const size_t blockLength = config_.blockLength;
+    auto sample = [&](Philox& rng, std::vector<double>& path) {
+        path.resize(curve.size());
+        path[0] = curve.front().equity;
+        size_t k = 0;
+        while (k < returns.size()) {
+            size_t start = rng.below(returns.size());
+            for (size_t j = 0; j < blockLength && k < returns.size(); ++j, ++k) {
+                path[k + 1] = path[k] * std::exp(returns[(start + j) % returns.size()]);
+            }
+        }
+    };
+    return run(sample, Performance::getAnnualization(config_.frequency).periodsPerYear);
+}
+
+MonteCarloResult MonteCarlo::rerun(
+    const std::function<std::vector<EquityPoint>(Philox& rng)>& backtest) const {
+    auto sample = [&](Philox& rng, std::vector<double>& path) {
+        std::vector<EquityPoint> curve = backtest(rng);
+        path.resize(curve.size());
+        for (size_t k = 0; k < curve.size(); ++k) path[k] = curve[k].equity;
+    };
+    return run(sample, Performance::getAnnualization(config_.frequency).periodsPerYear);
+}
+
+MonteCarloResult MonteCarlo::run(const Sampler& sample, double periodsPerYear) const {
+    MonteCarloResult result;
+    result.samples.resize(config_.samples);
+
+    // Chunks only batch the scratch buffers; which thread runs a sample never matters
+    ThreadPool pool(config_.threads);
+    const size_t chunks = std::min(config_.samples, pool.size() * 4);
+    for (size_t c = 0; c < chunks; ++c) {
+        size_t begin = config_.samples * c / chunks;
+        size_t end = config_.samples * (c + 1) / chunks;
+        pool.submit([this, &sample, &result, periodsPerYear, begin, end] {
+            std::vector<double> path;
+            std::vector<double> returns;
+            for (size_t i = begin; i < end; ++i) {
+                Philox rng(config_.seed, i);
+                sample(rng, path);
+                result.samples[i] = measure(path, periodsPerYear, returns);
+            }
+        });
+    }
+    pool.wait();
+
+    std::vector<double> values(result.samples.size());
+    auto summarize = [&](double SampleStats::*field) {
+        for (size_t i = 0; i < values.size(); ++i) values[i] = result.samples[i].*field;
+        return interval(values, config_.confidence);
+    };
+    result.sharpe = summarize(&SampleStats::sharpe);
+    result.maxDrawdown = summarize(&SampleStats::maxDrawdown);
+    result.finalEquity = summarize(&SampleStats::finalEquity);
+    return result;
+}
@@ -0,0 +1,5 @@
+#include "backtest-cpp/multi_engine.h"
+
+// The member definitions live in multi_engine.h so the book can hold any portfolio type. The
+// default Portfolio is compiled once here.
+template class BasicMultiStrategyEngine<Portfolio>;
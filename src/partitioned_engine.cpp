@@ -0,0 +1,5 @@
+#include "backtest-cpp/partitioned_engine.h"
+
+// The member definitions live in partitioned_engine.h so the sub-accounts can be of any
+// portfolio type. The default Portfolio is compiled once here.
+template class BasicPartitionedEngine<Portfolio>;
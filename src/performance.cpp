@@ -1,7 +1,10 @@
 #include "backtest-cpp/performance.h"
 
+#include <algorithm>
 #include <cmath>
+#include <limits>
 #include <stdexcept>
+#include <string>
 
 Annualization Performance::getAnnualization(Frequency freq) {  // TODO: make instrument specific
     switch (freq) {
@@ -59,3 +62,456 @@ double Performance::sharpeRatio(const std::vector<EquityPoint>& curve, Frequency
 
     return (annReturn - riskFreeRate) / annVol;
 }
+
+RiskMetrics Performance::riskMetrics(const RiskSums& sums, Frequency freq, double riskFreeRate) {
+    if (sums.points < 3) throw std::runtime_error("Equity curve too short");
+
+    double returns = static_cast<double>(sums.points - 1);
+    double annualPeriods = Performance::getAnnualization(freq).periodsPerYear;
+
+    RiskMetrics metrics;
+    metrics.annualizedReturn = std::pow(sums.last / sums.first, annualPeriods / returns) - 1.0;
+    metrics.annualizedVolatility = std::sqrt(sums.m2 / (returns - 1.0) * annualPeriods);
+    metrics.maxDrawdown = sums.maxDrawdown;
+    metrics.maxDrawdownDuration = sums.maxUnderwater;
+
+    double excess = metrics.annualizedReturn - riskFreeRate;
+    double downside = std::sqrt(sums.downside2 / returns * annualPeriods);
+    if (metrics.annualizedVolatility != 0.0) metrics.sharpe = excess / metrics.annualizedVolatility;
+    if (downside != 0.0) metrics.sortino = excess / downside;
+    if (sums.maxDrawdown != 0.0) metrics.calmar = metrics.annualizedReturn / sums.maxDrawdown;
+    metrics.ulcerIndex = std::sqrt(sums.drawdown2 / static_cast<double>(sums.points));
+    if (sums.m2 != 0.0) {
+        metrics.skewness = std::sqrt(returns) * sums.m3 / std::pow(sums.m2, 1.5);
+        metrics.excessKurtosis = returns * sums.m4 / (sums.m2 * sums.m2) - 3.0;
+    }
+    metrics.hitRate = static_cast<double>(sums.gains) / returns;
+    return metrics;
+}
+
+RiskMetrics Performance::riskMetrics(const std::vector<EquityPoint>& curve, Frequency freq,
+                                     double riskFreeRate) {
+    if (curve.size() < 3) throw std::runtime_error("Equity curve too short");
+
+    // Raw power sums of the returns shifted by the first one keep every accumulator an
+    // independent chain of adds, where Welford's update divides on each point; the shift
+    // keeps them close to zero so the central moments below do not cancel badly.
+    const double shift = std::log(curve[1].equity / curve[0].equity);
+    double s1 = 0.0, s2 = 0.0, s3 = 0.0, s4 = 0.0;
+    double downside2 = 0.0, drawdown2 = 0.0, maxDrawdown = 0.0;
+    double peak = curve[0].equity;
+    size_t gains = 0, underwater = 0, maxUnderwater = 0;
+    for (size_t i = 1; i < curve.size(); ++i) {
+        double equity = curve[i].equity;
+        double r = std::log(equity / curve[i - 1].equity);
+        double d = r - shift;
+        double d2 = d * d;
+        s1 += d;
+        s2 += d2;
+        s3 += d2 * d;
+        s4 += d2 * d2;
+        // An fma, as GCC turns `+= loss * loss` into a branch taken for about half the returns
+        double loss = std::min(r, 0.0);
+        downside2 = std::fma(loss, loss, downside2);
+        gains += r > 0.0;
+
+        underwater = equity >= peak ? 0 : underwater + 1;
+        maxUnderwater = std::max(maxUnderwater, underwater);
+        peak = std::max(peak, equity);
+        double drawdown = peak > 0.0 ? (peak - equity) / peak : 0.0;
+        maxDrawdown = std::max(maxDrawdown, drawdown);
+        drawdown2 += drawdown * drawdown;
+    }
+
+    double mean = s1 / static_cast<double>(curve.size() - 1);
+    double m2 = std::max(0.0, s2 - mean * s1);
+    double m3 = s3 - 3.0 * mean * s2 + 2.0 * mean * mean * s1;
+    double m4 = s4 - 4.0 * mean * s3 + 6.0 * mean * mean * s2 - 3.0 * mean * mean * mean * s1;
+    return riskMetrics({.points = curve.size(),
+                      .first = curve.front().equity,
+                      .last = curve.back().equity,
+                      .m2 = m2,
+                      .m3 = m3,
+                      .m4 = m4,
+                      .downside2 = downside2,
+                      .gains = gains,
+                      .maxDrawdown = maxDrawdown,
+                      .drawdown2 = drawdown2,
+                      .maxUnderwater = maxUnderwater},
+                     freq, riskFreeRate);
+}
+
+double Performance::maxDrawdown(const std::vector<EquityPoint>& curve) {
+    if (curve.empty()) throw std::runtime_error("Equity curve too short");
+
+    double peak = curve.front().equity;
+    double drawdown = 0.0;
+    for (const EquityPoint& point : curve) {
+        peak = std::max(peak, point.equity);
+        if (peak > 0.0) drawdown = std::max(drawdown, (peak - point.equity) / peak);
+    }
+    return drawdown;
+}
+
+void PerformanceAccumulator::add(double equity) {
+    if (count_ == 0) {
+        first_ = peak_ = equity;
+    } else {
+        double r = std::log(equity / last_);
+        double n = static_cast<double>(count_);  // Returns seen including this one
+        double delta = r - meanReturn_;
+        double deltaN = delta / n;
+        double deltaN2 = deltaN * deltaN;
+        double term = delta * deltaN * (n - 1.0);
+        meanReturn_ += deltaN;
+        m4_ += term * deltaN2 * (n * n - 3.0 * n + 3.0) + 6.0 * deltaN2 * m2_ - 4.0 * deltaN * m3_;
+        m3_ += term * deltaN * (n - 2.0) - 3.0 * deltaN * m2_;
+        m2_ += term;
+
+        double loss = std::min(r, 0.0);
+        downside2_ = std::fma(loss, loss, downside2_);  // Branch-free, see riskMetrics
+        gains_ += r > 0.0;
+    }
+    last_ = equity;
+    ++count_;
+
+    underwater_ = equity >= peak_ ? 0 : underwater_ + 1;
+    maxUnderwater_ = std::max(maxUnderwater_, underwater_);
+    peak_ = std::max(peak_, equity);
+    double drawdown = peak_ > 0.0 ? (peak_ - equity) / peak_ : 0.0;
+    maxDrawdown_ = std::max(maxDrawdown_, drawdown);
+    drawdown2_ += drawdown * drawdown;
+}
+
+double PerformanceAccumulator::annualizedReturn(Frequency freq) const {
+    if (count_ < 2) throw std::runtime_error("Equity curve too short");
+
+    double periods = static_cast<double>(count_ - 1);
+    double annualPeriods = Performance::getAnnualization(freq).periodsPerYear;
+    return std::pow(last_ / first_, annualPeriods / periods) - 1.0;
+}
+
+double PerformanceAccumulator::annualizedVolatility(Frequency freq) const {
+    if (count_ < 3) throw std::runtime_error("Equity curve too short");
+
+    double var = m2_ / static_cast<double>(count_ - 2);  // Sample variance of count_ - 1 returns
+    double annualPeriods = Performance::getAnnualization(freq).periodsPerYear;
+    return std::sqrt(var * annualPeriods);
+}
+
+double PerformanceAccumulator::sharpeRatio(Frequency freq, double riskFreeRate) const {
+    double annReturn = annualizedReturn(freq);
+    double annVol = annualizedVolatility(freq);
+
+    if (annVol == 0.0) return 0.0;
+
+    return (annReturn - riskFreeRate) / annVol;
+}
+
+double PerformanceAccumulator::maxDrawdown() const {
+    if (count_ == 0) throw std::runtime_error("Equity curve too short");
+    return maxDrawdown_;
+}
+
+RiskMetrics PerformanceAccumulator::riskMetrics(Frequency freq, double riskFreeRate) const {
+    return Performance::riskMetrics({.points = count_,
+                                     .first = first_,
+                                     .last = last_,
+                                     .m2 = m2_,
+                                     .m3 = m3_,
+                                     .m4 = m4_,
+                                     .downside2 = downside2_,
+                                     .gains = gains_,
+                                     .maxDrawdown = maxDrawdown_,
+                                     .drawdown2 = drawdown2_,
+                                     .maxUnderwater = maxUnderwater_},
+                                    freq, riskFreeRate);
+}
+
+RollingPerformance::RollingPerformance(const RollingWindow& window)
+    : window_(window),
+      periodsPerYear_(Performance::getAnnualization(window.frequency).periodsPerYear),
+      returns_(window.bars),
+      equities_(window.bars + 1),
+      maxima_(window.bars + 1) {
+    if (window.bars < 2) {
+        throw std::invalid_argument("Rolling window needs at least 2 returns");
+    }
+}
+
+void RollingPerformance::add(double equity) {
+    if (!equities_.empty()) {
+        double r = std::log(equity / equities_.back());
+        if (returns_.empty()) shift_ = r;
+        if (ready()) {
+            double old = returns_.front() - shift_;
+            returns_.pop_front();
+            sum_ -= old;
+            sumSquares_ -= old * old;
+        }
+        returns_.push_back(r);
+        double d = r - shift_;
+        sum_ += d;
+        sumSquares_ += d * d;
+        if (++sinceRenormalize_ == window_.bars) renormalize();
+    }
+    if (equities_.size() == window_.bars + 1) equities_.pop_front();
+    equities_.push_back(equity);
+
+    // Expire first: the window then holds at most bars + 1 peaks, the ring's capacity
+    if (!maxima_.empty() && maxima_.front().index + window_.bars < index_) maxima_.pop_front();
+    while (!maxima_.empty() && maxima_.back().equity <= equity) maxima_.pop_back();
+    maxima_.push_back({index_, equity});
+    ++index_;
+}
+
+// Exact sums around the window's current mean, so the running ones never drift far
+void RollingPerformance::renormalize() {
+    sinceRenormalize_ = 0;
+    double mean = 0.0;
+    for (size_t i = 0; i < returns_.size(); ++i) mean += returns_[i];
+    shift_ = mean / static_cast<double>(returns_.size());
+
+    sum_ = sumSquares_ = 0.0;
+    for (size_t i = 0; i < returns_.size(); ++i) {
+        double d = returns_[i] - shift_;
+        sum_ += d;
+        sumSquares_ += d * d;
+    }
+}
+
+double RollingPerformance::annualizedReturn() const {
+    if (!ready()) return std::numeric_limits<double>::quiet_NaN();
+    double periods = static_cast<double>(window_.bars);
+    return std::pow(equities_.back() / equities_.front(), periodsPerYear_ / periods) - 1.0;
+}
+
+double RollingPerformance::annualizedVolatility() const {
+    if (!ready()) return std::numeric_limits<double>::quiet_NaN();
+    double n = static_cast<double>(window_.bars);
+    double var = std::max(0.0, sumSquares_ - sum_ * sum_ / n) / (n - 1.0);
+    return std::sqrt(var * periodsPerYear_);
+}
+
+double RollingPerformance::sharpeRatio() const {
+    double annVol = annualizedVolatility();
+    if (annVol == 0.0) return 0.0;
+    return (annualizedReturn() - window_.riskFreeRate) / annVol;
+}
+
+double RollingPerformance::drawdown() const {
+    if (!ready()) return std::numeric_limits<double>::quiet_NaN();
+    double peak = maxima_.front().equity;
+    return peak > 0.0 ? (peak - equities_.back()) / peak : 0.0;
+}
+
+namespace {
+
+template <typename T>
+std::vector<T> toVector(const RingBuffer<T>& ring) {
+    std::vector<T> values(ring.size());
+    for (size_t i = 0; i < values.size(); ++i) values[i] = ring[i];
+    return values;
+}
+
+template <typename T>
+void fromVector(const std::vector<T>& values, RingBuffer<T>& ring) {
+    if (values.size() > ring.capacity()) {
+        throw std::runtime_error("Rolling window state does not fit the window");
+    }
+    ring.clear();
+    for (const T& value : values) ring.push_back(value);
+}
+
+}  // namespace
+
+void RollingPerformance::saveState(BinaryWriter& writer) const {
+    writer.write(toVector(returns_));
+    writer.write(toVector(equities_));
+    writer.write(toVector(maxima_));
+    writer.write(index_);
+    writer.write(shift_);
+    writer.write(sum_);
+    writer.write(sumSquares_);
+    writer.write(sinceRenormalize_);
+}
+
+void RollingPerformance::loadState(BinaryReader& reader) {
+    std::vector<double> returns, equities;
+    std::vector<Peak> maxima;
+    reader.read(returns);
+    reader.read(equities);
+    reader.read(maxima);
+    fromVector(returns, returns_);
+    fromVector(equities, equities_);
+    fromVector(maxima, maxima_);
+    reader.read(index_);
+    reader.read(shift_);
+    reader.read(sum_);
+    reader.read(sumSquares_);
+    reader.read(sinceRenormalize_);
+}
+
+QuantileSketch::QuantileSketch(size_t k, uint64_t seed) : k_(k), rng_(seed, 0) {
+    if (k < 8) throw std::invalid_argument("QuantileSketch needs k >= 8");
+    grow();
+}
+
+// The top level holds k values, each one below 2/3 of the one above, at least 2
+size_t QuantileSketch::capacity(size_t level) const {
+    size_t depth = levels_.size() - level - 1;
+    return std::max<size_t>(2, static_cast<size_t>(std::ceil(k_ * std::pow(2.0 / 3.0, depth))));
+}
+
+void QuantileSketch::grow() {
+    levels_.emplace_back();
+    maxRetained_ = 0;
+    for (size_t h = 0; h < levels_.size(); ++h) maxRetained_ += capacity(h);
+}
+
+void QuantileSketch::add(double value) {
+    if (count_ == 0) min_ = max_ = value;
+    min_ = std::min(min_, value);
+    max_ = std::max(max_, value);
+    ++count_;
+
+    levels_[0].push_back(value);
+    if (++retained_ >= maxRetained_) compress();
+}
+
+// Compacts the lowest full level into the one above. An odd value out stays behind, so
+// the total weight is unchanged.
+void QuantileSketch::compress() {
+    for (size_t h = 0; h < levels_.size(); ++h) {
+        if (levels_[h].size() < capacity(h)) continue;
+        if (h + 1 == levels_.size()) grow();  // Before taking references into levels_
+
+        std::vector<double>& level = levels_[h];
+
+        std::sort(level.begin(), level.end());
+        double leftover = level.back();
+        bool odd = level.size() % 2 == 1;
+        size_t end = level.size() - (odd ? 1 : 0);
+        std::vector<double>& above = levels_[h + 1];
+        for (size_t i = rng_.next() & 1; i < end; i += 2) above.push_back(level[i]);
+        level.clear();
+        if (odd) level.push_back(leftover);
+
+        retained_ = 0;
+        for (const std::vector<double>& values : levels_) retained_ += values.size();
+        if (retained_ < maxRetained_) return;
+    }
+}
+
+void QuantileSketch::merge(const QuantileSketch& other) {
+    if (other.k_ != k_) {
+        throw std::invalid_argument("Cannot merge sketches of k " + std::to_string(k_) +
+                                    " and " + std::to_string(other.k_));
+    }
+    if (other.count_ == 0) return;
+    if (count_ == 0) {
+        min_ = other.min_;
+        max_ = other.max_;
+    }
+    min_ = std::min(min_, other.min_);
+    max_ = std::max(max_, other.max_);
+    count_ += other.count_;
+
+    while (levels_.size() < other.levels_.size()) grow();
+    for (size_t h = 0; h < other.levels_.size(); ++h) {
+        levels_[h].insert(levels_[h].end(), other.levels_[h].begin(), other.levels_[h].end());
+        retained_ += other.levels_[h].size();
+    }
+    while (retained_ >= maxRetained_) compress();
+}
+
+std::vector<QuantileSketch::Weighted> QuantileSketch::sorted() const {
+    if (count_ == 0) throw std::runtime_error("QuantileSketch is empty");
+    std::vector<Weighted> items;
+    items.reserve(retained_);
+    for (size_t h = 0; h < levels_.size(); ++h) {
+        for (double value : levels_[h]) items.push_back({value, uint64_t{1} << h});
+    }
+    std::sort(items.begin(), items.end(),
+              [](const Weighted& a, const Weighted& b) { return a.value < b.value; });
+    return items;
+}
+
+double QuantileSketch::min() const {
+    if (count_ == 0) throw std::runtime_error("QuantileSketch is empty");
+    return min_;
+}
+
+double QuantileSketch::max() const {
+    if (count_ == 0) throw std::runtime_error("QuantileSketch is empty");
+    return max_;
+}
+
+double QuantileSketch::quantile(double q) const {
+    std::vector<Weighted> items = sorted();
+    if (q <= 0.0) return min_;
+    if (q >= 1.0) return max_;
+
+    double target = q * static_cast<double>(count_);
+    uint64_t cumulative = 0;
+    for (const Weighted& item : items) {
+        cumulative += item.weight;
+        if (static_cast<double>(cumulative) >= target) return item.value;
+    }
+    return max_;
+}
+
+double QuantileSketch::rank(double value) const {
+    std::vector<Weighted> items = sorted();
+    uint64_t below = 0;
+    for (const Weighted& item : items) {
+        if (item.value > value) break;
+        below += item.weight;
+    }
+    return static_cast<double>(below) / static_cast<double>(count_);
+}
+
+double QuantileSketch::tailMean(double q) const {
+    std::vector<Weighted> items = sorted();
+    if (q <= 0.0) return min_;
+
+    // The item straddling the cut counts with the part of its weight inside the tail
+    double target = std::min(q, 1.0) * static_cast<double>(count_);
+    double weight = 0.0;
+    double sum = 0.0;
+    for (const Weighted& item : items) {
+        double take = std::min(static_cast<double>(item.weight), target - weight);
+        sum += take * item.value;
+        weight += take;
+        if (weight >= target) break;
+    }
+    return sum / weight;
+}
+
+void QuantileSketch::saveState(BinaryWriter& writer) const {
+    writer.write(k_);
+    writer.write<uint64_t>(levels_.size());
+    for (const std::vector<double>& level : levels_) writer.write(level);
+    writer.write(count_);
+    writer.write(min_);
+    writer.write(max_);
+    writer.write(rng_);
+}
+
+void QuantileSketch::loadState(BinaryReader& reader) {
+    if (reader.read<size_t>() != k_) {
+        throw std::runtime_error("QuantileSketch state was written with another k");
+    }
+    size_t numLevels = reader.read<uint64_t>();
+    levels_.clear();
+    retained_ = 0;
+    for (size_t h = 0; h < numLevels; ++h) {
+        grow();
+        reader.read(levels_.back());
+        retained_ += levels_.back().size();
+    }
+    reader.read(count_);
+    reader.read(min_);
+    reader.read(max_);
+    reader.read(rng_);
+}
@@ -0,0 +1,22 @@
+#include "backtest-cpp/pipeline.h"
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+void detail::pinToCpu(int cpu) {
+    if (cpu < 0) return;
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0) {
+        throw std::runtime_error("Cannot pin pipeline stage to CPU " + std::to_string(cpu));
+    }
+#endif
+}
+
+// The member definitions live in pipeline.h so the pipeline can run any portfolio type. The
+// default Portfolio is compiled once here.
+template class BasicPipelinedEngine<Portfolio>;
@@ -0,0 +1,297 @@
+#include "backtest-cpp/sweep.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+
+#include "../strategies/smacrossover.h"
+#include "backtest-cpp/latency.h"
+#include "backtest-cpp/thread_pool.h"
+
+namespace {
+
+std::vector<int> expand(const ParamRange& range) {
+    if (range.step <= 0) {
+        throw std::invalid_argument("Parameter range step must be > 0");
+    }
+    std::vector<int> values;
+    for (int value = range.from; value <= range.to; value += range.step) {
+        values.push_back(value);
+    }
+    return values;
+}
+
+// log(equity / previous). Moves between marks are mostly tiny, and for those a short series
+// is as exact as std::log, which would otherwise dominate the shared sweep's time.
+double logReturn(double equity, double previous) {
+    const double x = (equity - previous) / previous;
+    if (std::fabs(x) > 0x1p-8) return std::log1p(x);
+    // log1p(x) = x - x^2/2 + x^3/3 - ...; the first dropped term is below 2e-13 * |x|
+    return x * (1.0 - x * (0.5 - x * (1.0 / 3.0 - x * (0.25 - x * 0.2))));
+}
+
+// One combination of SharedSMASweep: its position, crossover state and the running sums
+// Performance needs, in place of the equity curve
+struct SharedRun {
+    SimulatedPosition position;
+    bool above = false;  // Fast mean above slow on the previous bar
+    size_t trades = 0;
+    double realizedPnL = 0.0;
+    std::vector<EquityPoint>* curve = nullptr;  // Only filled when the caller asks for it
+
+    size_t points = 0;
+    double firstEquity = 0.0;
+    double lastEquity = 0.0;
+    double sumReturns = 0.0;  // Of the log returns between points
+    double sumSquaredReturns = 0.0;
+
+    void addPoint(int64_t time, double equity) {
+        if (curve) curve->push_back({time, equity});
+        if (points++ == 0) {
+            firstEquity = lastEquity = equity;
+            return;
+        }
+        // Flat, the equity is the unchanged cash and the return exactly 0: no log needed
+        if (equity == lastEquity) return;
+        double r = logReturn(equity, lastEquity);
+        sumReturns += r;
+        sumSquaredReturns += r * r;
+        lastEquity = equity;
+    }
+};
+
+// Bars per block of SharedSMASweep: the means of all windows of a chunk for one block stay
+// in L1/L2 while every pair of the chunk reads them
+constexpr size_t kSharedBlock = 128;
+
+}  // namespace
+
+std::vector<SMAParams> gridSearch(const ParamRange& shortPeriods, const ParamRange& longPeriods) {
+    std::vector<int> shorts = expand(shortPeriods);
+    std::vector<int> longs = expand(longPeriods);
+
+    std::vector<SMAParams> grid;
+    for (int shortPeriod : shorts) {
+        for (int longPeriod : longs) {
+            if (shortPeriod >= 1 && shortPeriod < longPeriod) {
+                grid.push_back({shortPeriod, longPeriod});
+            }
+        }
+    }
+    return grid;
+}
+
+size_t commonWarmup(size_t warmupBars, std::span<const SMAParams> params) {
+    for (const SMAParams& p : params) {
+        warmupBars = std::max(warmupBars, static_cast<size_t>(std::max(p.longPeriod, 0)));
+    }
+    return warmupBars;
+}
+
+std::vector<SMAParams> randomSearch(const ParamRange& shortPeriods, const ParamRange& longPeriods,
+                                    size_t count, uint64_t seed) {
+    // Sampling without replacement from the grid keeps every draw valid and distinct
+    std::vector<SMAParams> grid = gridSearch(shortPeriods, longPeriods);
+    std::mt19937_64 rng(seed);
+    count = std::min(count, grid.size());
+    for (size_t i = 0; i < count; ++i) {
+        std::uniform_int_distribution<size_t> pick(i, grid.size() - 1);
+        std::swap(grid[i], grid[pick(rng)]);
+    }
+    grid.resize(count);
+    return grid;
+}
+
+std::unique_ptr<Strategy> detail::makeSMACrossover(const SMAParams& params) {
+    return std::make_unique<SMACrossover>(params.shortPeriod, params.longPeriod);
+}
+
+SweepResult detail::sweepResult(const SMAParams& params, const std::vector<EquityPoint>& curve,
+                                double realizedPnL, size_t trades, Frequency frequency) {
+    SweepResult result{.params = params, .realizedPnL = realizedPnL, .trades = trades};
+    if (curve.size() >= 3) {
+        result.annualizedReturn = Performance::annualizedReturn(curve, frequency);
+        result.annualizedVolatility = Performance::annualizedVolatility(curve, frequency);
+        result.sharpe = Performance::sharpeRatio(curve, frequency);
+    }
+    if (!curve.empty()) result.finalEquity = curve.back().equity;
+    return result;
+}
+
+// The member definitions live in sweep.h so the runs can use any portfolio type. The default
+// Portfolio is compiled once here.
+template class BasicParameterSweep<Portfolio>;
+
+SharedSMASweep::SharedSMASweep(const BarColumns& bars, const SweepConfig& config)
+    : bars_(bars), config_(config), prefix_(bars.size() + 1) {
+    if (!LatencyModel(config_.portfolio.latency).isZero()) {
+        throw std::invalid_argument("SharedSMASweep fills on the signal bar; latency must be 0");
+    }
+    prefixSum(bars_.close, prefix_);
+}
+
+std::vector<SweepResult> SharedSMASweep::run(std::span<const SMAParams> params) const {
+    checkParams(params);
+    std::vector<SweepResult> results(params.size());
+    const size_t warmup = commonWarmup(config_.engine.warmupBars, params);
+    const size_t n = bars_.size();
+
+    // A few chunks per thread for balance; fewer, larger chunks share more of the means
+    ThreadPool pool(config_.threads);
+    const size_t chunks = std::min(params.size(), pool.size() * 4);
+    for (size_t c = 0; c < chunks; ++c) {
+        size_t begin = params.size() * c / chunks;
+        size_t end = params.size() * (c + 1) / chunks;
+        pool.submit([this, params, &results, warmup, n, begin, end] {
+            runChunk(params.subspan(begin, end - begin), warmup, n,
+                     std::span(results).subspan(begin, end - begin), {});
+        });
+    }
+    pool.wait();
+    return results;
+}
+
+std::vector<SweepResult> SharedSMASweep::runRange(
+    std::span<const SMAParams> params, size_t begin, size_t end,
+    std::span<std::vector<EquityPoint>> curves) const {
+    checkParams(params);
+    if (end > bars_.size() || begin > end) {
+        throw std::out_of_range("SharedSMASweep: bar range outside the data");
+    }
+    if (commonWarmup(1, params) > begin) {
+        throw std::invalid_argument("SharedSMASweep: range must start after the longest period");
+    }
+    if (!curves.empty() && curves.size() != params.size()) {
+        throw std::invalid_argument("SharedSMASweep: need one curve per parameter set");
+    }
+
+    std::vector<SweepResult> results(params.size());
+    runChunk(params, begin, end, results, curves);
+    return results;
+}
+
+void SharedSMASweep::checkParams(std::span<const SMAParams> params) {
+    for (const SMAParams& p : params) {
+        if (p.shortPeriod < 1 || p.shortPeriod >= p.longPeriod) {
+            throw std::invalid_argument("SharedSMASweep needs 1 <= shortPeriod < longPeriod");
+        }
+    }
+}
+
+void SharedSMASweep::runChunk(std::span<const SMAParams> params, size_t begin, size_t end,
+                              std::span<SweepResult> results,
+                              std::span<std::vector<EquityPoint>> curves) const {
+    const double* prefix = prefix_.data();
+
+    // Distinct windows of this chunk, and each pair's rows in the block of means
+    std::vector<int> windows;
+    for (const SMAParams& p : params) {
+        windows.push_back(p.shortPeriod);
+        windows.push_back(p.longPeriod);
+    }
+    std::sort(windows.begin(), windows.end());
+    windows.erase(std::unique(windows.begin(), windows.end()), windows.end());
+    auto row = [&windows](int window) {
+        return static_cast<size_t>(std::lower_bound(windows.begin(), windows.end(), window) -
+                                   windows.begin());
+    };
+    std::vector<size_t> fastRow(params.size());
+    std::vector<size_t> slowRow(params.size());
+    for (size_t p = 0; p < params.size(); ++p) {
+        fastRow[p] = row(params[p].shortPeriod);
+        slowRow[p] = row(params[p].longPeriod);
+    }
+
+    // Mean of the `period` closes up to and including bar i
+    auto mean = [prefix](size_t i, int period) {
+        return (prefix[i + 1] - prefix[i + 1 - period]) / static_cast<double>(period);
+    };
+
+    // The engine trades from its warm-up on, each signal comparing with the bar before;
+    // every window is full there since begin >= the longest long period
+    SharedRun initial{.position = SimulatedPosition(config_.portfolio)};
+    std::vector<SharedRun> runs(params.size(), initial);
+    for (size_t p = 0; p < curves.size(); ++p) {
+        curves[p].clear();
+        runs[p].curve = &curves[p];
+    }
+    if (end > begin) {
+        for (size_t p = 0; p < params.size(); ++p) {
+            runs[p].above = mean(begin - 1, params[p].shortPeriod) >
+                            mean(begin - 1, params[p].longPeriod);
+        }
+    }
+
+    const double maxInvest = config_.engine.maxInvest;
+    std::vector<double> means(windows.size() * kSharedBlock);
+    for (size_t t0 = begin; t0 < end; t0 += kSharedBlock) {
+        const size_t length = std::min(kSharedBlock, end - t0);
+
+        // Each distinct window's means over the block, computed once for all its pairs
+        for (size_t w = 0; w < windows.size(); ++w) {
+            double* out = &means[w * kSharedBlock];
+            for (size_t k = 0; k < length; ++k) {
+                out[k] = mean(t0 + k, windows[w]);
+            }
+        }
+
+        for (size_t p = 0; p < params.size(); ++p) {
+            SharedRun& run = runs[p];
+            const double* fast = &means[fastRow[p] * kSharedBlock];
+            const double* slow = &means[slowRow[p] * kSharedBlock];
+
+            for (size_t k = 0; k < length; ++k) {
+                const size_t t = t0 + k;
+                const bool above = fast[k] > slow[k];
+                if (above != run.above) {
+                    run.above = above;
+                    int quantity = crossoverOrderQuantity(above ? 1 : -1, bars_.open[t],
+                                                          maxInvest, run.position.quantity());
+                    if (quantity != 0 && run.position.accepts(quantity, bars_.close[t])) {
+                        if (auto closed =
+                                run.position.fill(quantity, bars_.close[t], bars_.time[t])) {
+                            ++run.trades;
+                            run.realizedPnL += closed->pnl;
+                        }
+                    }
+                }
+                run.addPoint(bars_.time[t], run.position.equity(bars_.close[t]));
+            }
+        }
+    }
+
+    // Final liquidation at the last close of the range and the metrics of ParameterSweep::runOne
+    const double periodsPerYear = Performance::getAnnualization(config_.frequency).periodsPerYear;
+    for (size_t p = 0; p < params.size(); ++p) {
+        SharedRun& run = runs[p];
+        SweepResult& result = results[p];
+        result.params = params[p];
+
+        if (end > begin) {
+            if (run.position.quantity() != 0) {
+                auto closed = run.position.fill(-run.position.quantity(), bars_.close[end - 1],
+                                                 bars_.time[end - 1]);
+                ++run.trades;
+                run.realizedPnL += closed->pnl;
+            }
+            run.addPoint(bars_.time[end - 1], run.position.cash());
+            result.finalEquity = run.lastEquity;
+        }
+        result.realizedPnL = run.realizedPnL;
+        result.trades = run.trades;
+
+        if (run.points >= 3) {
+            const double periods = static_cast<double>(run.points - 1);
+            result.annualizedReturn =
+                std::pow(run.lastEquity / run.firstEquity, periodsPerYear / periods) - 1.0;
+            const double mean = run.sumReturns / periods;
+            const double variance =
+                std::max(0.0, (run.sumSquaredReturns - periods * mean * mean) / (periods - 1.0));
+            result.annualizedVolatility = std::sqrt(variance * periodsPerYear);
+            result.sharpe = result.annualizedVolatility == 0.0
+                                ? 0.0
+                                : result.annualizedReturn / result.annualizedVolatility;
+        }
+    }
+}
@@ -0,0 +1,164 @@
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "backtest-cpp/data.h"
+#include "backtest-cpp/sweep.h"
+#include "backtest-cpp/walk_forward.h"
+
+// Usage: ./sweep [--data FILE] [--symbol NAME] [--short FROM:TO:STEP] [--long FROM:TO:STEP]
+//                [--random N] [--seed S] [--threads N] [--top K] [--mode engine|shared]
+//                [--walk-forward IN:OUT[:anchored]]
+
+namespace {
+
+ParamRange parseRange(const std::string& text) {
+    ParamRange range{};
+    size_t first = text.find(':');
+    size_t second = text.find(':', first + 1);
+    if (first == std::string::npos) {
+        throw std::invalid_argument("Expected FROM:TO[:STEP], got " + text);
+    }
+    range.from = std::stoi(text.substr(0, first));
+    range.to = std::stoi(text.substr(first + 1, second - first - 1));
+    if (second != std::string::npos) range.step = std::stoi(text.substr(second + 1));
+    return range;
+}
+
+WalkForwardConfig parseWalkForward(const std::string& text) {
+    WalkForwardConfig config;
+    size_t first = text.find(':');
+    size_t second = text.find(':', first + 1);
+    if (first == std::string::npos) {
+        throw std::invalid_argument("Expected IN:OUT[:anchored], got " + text);
+    }
+    config.inSampleBars = std::stoul(text.substr(0, first));
+    config.outOfSampleBars = std::stoul(text.substr(first + 1, second - first - 1));
+    if (second != std::string::npos) {
+        if (text.substr(second + 1) != "anchored") {
+            throw std::invalid_argument("Unknown window mode in " + text);
+        }
+        config.mode = WindowMode::ANCHORED;
+    }
+    return config;
+}
+
+void printWalkForward(const WalkForwardResult& result, Frequency frequency) {
+    std::cout << "\n=== Walk-forward: " << result.folds.size() << " folds ===" << std::endl;
+    std::cout << std::fixed << std::setprecision(4);
+    std::cout << std::setw(16) << "In-sample" << std::setw(8) << "Out" << std::setw(6) << "Short"
+              << std::setw(6) << "Long" << std::setw(10) << "IS Sharpe" << std::setw(10)
+              << "OOS Sharpe" << std::setw(12) << "OOS PnL" << std::endl;
+    for (const WalkForwardFold& fold : result.folds) {
+        std::string inSample = std::to_string(fold.window.inSampleBegin) + "-" +
+                               std::to_string(fold.window.inSampleEnd);
+        std::cout << std::setw(16) << inSample << std::setw(8) << fold.window.outOfSampleEnd
+                  << std::setw(6) << fold.inSample.params.shortPeriod << std::setw(6)
+                  << fold.inSample.params.longPeriod << std::setw(10) << fold.inSample.sharpe
+                  << std::setw(10) << fold.outOfSample.sharpe << std::setw(12)
+                  << fold.outOfSample.realizedPnL << std::endl;
+    }
+
+    if (result.equityCurve.size() >= 3) {
+        std::cout << "Out-of-sample: AnnRet "
+                  << Performance::annualizedReturn(result.equityCurve, frequency) * 100
+                  << " %, AnnVol "
+                  << Performance::annualizedVolatility(result.equityCurve, frequency) * 100
+                  << " %, Sharpe " << Performance::sharpeRatio(result.equityCurve, frequency)
+                  << std::endl;
+    }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    std::string dataPath = "../data/Mini.csv";
+    std::string symbol = "NQ";
+    ParamRange shortPeriods{5, 30, 5};
+    ParamRange longPeriods{20, 120, 10};
+    size_t randomCount = 0;
+    uint64_t seed = 42;
+    size_t threads = 0;
+    size_t top = 10;
+    std::string mode = "engine";
+    std::optional<WalkForwardConfig> walkForward;
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string flag = argv[i];
+        std::string value = argv[i + 1];
+        if (flag == "--data") {
+            dataPath = value;
+        } else if (flag == "--symbol") {
+            symbol = value;
+        } else if (flag == "--short") {
+            shortPeriods = parseRange(value);
+        } else if (flag == "--long") {
+            longPeriods = parseRange(value);
+        } else if (flag == "--random") {
+            randomCount = std::stoul(value);
+        } else if (flag == "--seed") {
+            seed = std::stoull(value);
+        } else if (flag == "--threads") {
+            threads = std::stoul(value);
+        } else if (flag == "--top") {
+            top = std::stoul(value);
+        } else if (flag == "--mode") {
+            mode = value;
+        } else if (flag == "--walk-forward") {
+            walkForward = parseWalkForward(value);
+        } else {
+            std::cerr << "Unknown option " << flag << std::endl;
+            return 1;
+        }
+    }
+
+    DataHandler data;
+    data.loadCSV(dataPath, symbol);
+
+    std::vector<SMAParams> params = randomCount > 0
+                                        ? randomSearch(shortPeriods, longPeriods, randomCount, seed)
+                                        : gridSearch(shortPeriods, longPeriods);
+
+    SweepConfig config{.portfolio = {.initialCash = 100'000.0, .commission = 2.7},
+                       .engine = {.warmupBars = 30, .maxInvest = 10'000},
+                       .frequency = Frequency::MINUTE,
+                       .threads = threads};
+    if (walkForward) {
+        BarColumns columns = BarColumns::fromData(data, symbol);
+        printWalkForward(WalkForward(columns, config, *walkForward).run(params), config.frequency);
+        return 0;
+    }
+
+    std::vector<SweepResult> results;
+    if (mode == "shared") {
+        BarColumns columns = BarColumns::fromData(data, symbol);
+        results = SharedSMASweep(columns, config).run(params);
+    } else if (mode == "engine") {
+        results = ParameterSweep(data, config).run(params);
+    } else {
+        std::cerr << "Unknown mode " << mode << std::endl;
+        return 1;
+    }
+
+    std::sort(results.begin(), results.end(),
+              [](const SweepResult& a, const SweepResult& b) { return a.sharpe > b.sharpe; });
+
+    std::cout << "\n=== Sweep: " << params.size() << " runs ===" << std::endl;
+    std::cout << std::fixed << std::setprecision(4);
+    std::cout << std::setw(6) << "Short" << std::setw(6) << "Long" << std::setw(8) << "Trades"
+              << std::setw(12) << "PnL" << std::setw(12) << "AnnRet %" << std::setw(12)
+              << "AnnVol %" << std::setw(10) << "Sharpe" << std::endl;
+    for (size_t i = 0; i < std::min(top, results.size()); ++i) {
+        const SweepResult& r = results[i];
+        std::cout << std::setw(6) << r.params.shortPeriod << std::setw(6) << r.params.longPeriod
+                  << std::setw(8) << r.trades << std::setw(12) << r.realizedPnL << std::setw(12)
+                  << r.annualizedReturn * 100 << std::setw(12) << r.annualizedVolatility * 100
+                  << std::setw(10) << r.sharpe << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,269 @@
+#include "backtest-cpp/vectorized.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <stdexcept>
+
+#include "backtest-cpp/latency.h"
+
+BarColumns BarColumns::fromData(const DataHandler& data, const std::string& symbol) {
+    BarColumns columns{.symbol = symbol};
+    for (size_t i = 0; i < data.size(); ++i) {
+        const std::map<std::string, Bar>& bars = data.getBarsAt(i);
+        auto it = bars.find(symbol);
+        if (it == bars.end() || it->second.synthetic) continue;
+
+        const Bar& bar = it->second;
+        columns.time.push_back(bar.time);
+        columns.open.push_back(bar.open);
+        columns.high.push_back(bar.high);
+        columns.low.push_back(bar.low);
+        columns.close.push_back(bar.close);
+        columns.volume.push_back(bar.volume);
+    }
+    return columns;
+}
+
+// ============================================================================
+// Column kernels
+// ============================================================================
+
+namespace {
+
+// __restrict lets the compiler vectorize without runtime overlap checks
+void rollingMeanKernel(const double* __restrict prefix, double* __restrict out, size_t period,
+                       size_t begin, size_t n) {
+    const double divisor = static_cast<double>(period);
+    for (size_t i = begin; i < n; ++i) {
+        out[i] = (prefix[i + 1] - prefix[i + 1 - period]) / divisor;
+    }
+}
+
+void crossoverKernel(const double* __restrict fast, const double* __restrict slow,
+                     int8_t* __restrict out, size_t n) {
+    for (size_t i = 1; i < n; ++i) {
+        out[i] = static_cast<int8_t>((fast[i] > slow[i]) - (fast[i - 1] > slow[i - 1]));
+    }
+}
+
+}  // namespace
+
+void prefixSum(std::span<const double> values, std::span<double> prefix) {
+    const size_t n = values.size();
+    if (prefix.size() != n + 1) {
+        throw std::invalid_argument("prefixSum: prefix must have values.size() + 1 entries");
+    }
+
+    // Blocks of four are scanned independently of the running total, so the loop-carried
+    // dependency is one add per block instead of one per value
+    double carry = 0.0;
+    prefix[0] = 0.0;
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        double a = values[i];
+        double b = a + values[i + 1];
+        double c = b + values[i + 2];
+        double d = c + values[i + 3];
+        prefix[i + 1] = carry + a;
+        prefix[i + 2] = carry + b;
+        prefix[i + 3] = carry + c;
+        prefix[i + 4] = carry + d;
+        carry += d;
+    }
+    for (; i < n; ++i) {
+        carry += values[i];
+        prefix[i + 1] = carry;
+    }
+}
+
+void rollingMean(std::span<const double> prefix, size_t period, std::span<double> out) {
+    if (period == 0) {
+        throw std::invalid_argument("Indicator period must be > 0");
+    }
+    if (prefix.size() != out.size() + 1) {
+        throw std::invalid_argument("rollingMean: prefix must have out.size() + 1 entries");
+    }
+
+    const size_t n = out.size();
+    const size_t full = std::min(period - 1, n);  // First index with a full window
+    for (size_t i = 0; i < full; ++i) {
+        out[i] = prefix[i + 1] / static_cast<double>(i + 1);
+    }
+    rollingMeanKernel(prefix.data(), out.data(), period, full, n);
+}
+
+void crossoverSignals(std::span<const double> fast, std::span<const double> slow,
+                      std::span<int8_t> out) {
+    if (fast.size() != out.size() || slow.size() != out.size()) {
+        throw std::invalid_argument("crossoverSignals: columns differ in length");
+    }
+    if (out.empty()) return;
+
+    out[0] = 0;
+    crossoverKernel(fast.data(), slow.data(), out.data(), out.size());
+}
+
+// ============================================================================
+// SimulatedPosition
+// ============================================================================
+
+SimulatedPosition::SimulatedPosition(const PortfolioConfig& config)
+    : cash_(config.initialCash),
+      commission_(config.commission),
+      leverage_(config.leverage),
+      maxPositionSize_(config.maxPositionSize) {}
+
+bool SimulatedPosition::accepts(int quantity, double price) const {
+    int newQuantity = quantity_ + quantity;
+    if (abs(newQuantity) > maxPositionSize_) return false;
+
+    double marginDelta = abs(newQuantity) * price - abs(quantity_) * averagePrice_ + commission_;
+    return marginDelta <= cash_ * leverage_;
+}
+
+std::optional<SimulatedPosition::Closed> SimulatedPosition::fill(int quantity, double price,
+                                                                 int64_t time) {
+    const BookedFill booked = bookFill(quantity_, averagePrice_, quantity, price, commission_);
+    const bool opens = quantity_ == 0 || booked.reversed;
+    std::optional<Closed> closed;
+    if (quantity_ != 0) mark(price, price);
+    if (booked.closedQuantity != 0) {
+        double atLow = booked.closedQuantity * (low_ - averagePrice_);
+        double atHigh = booked.closedQuantity * (high_ - averagePrice_);
+        closed = Closed{booked.closedQuantity, booked.pnl, openTime_, std::min(atLow, atHigh),
+                        std::max(atLow, atHigh)};
+    }
+
+    cash_ += booked.cashIn;
+    cash_ -= booked.cashOut;
+    quantity_ = booked.quantity;
+    averagePrice_ = booked.averagePrice;
+    if (opens) {
+        openTime_ = time;
+        low_ = high_ = price;
+    }
+    return closed;
+}
+
+// ============================================================================
+// VectorizedBacktest
+// ============================================================================
+
+double VectorizedResult::realizedPnL() const {
+    double totalPnl = 0;
+    for (const Trade& trade : trades) {
+        totalPnl += trade.pnl;
+    }
+    return totalPnl;
+}
+
+VectorizedBacktest::VectorizedBacktest(const PortfolioConfig& portfolio,
+                                       const VectorizedConfig& config)
+    : portfolio_(portfolio), config_(config) {
+    if (config.shortPeriod < 1 || config.shortPeriod >= config.longPeriod) {
+        throw std::invalid_argument("Short period must be >= 1 and < long period");
+    }
+    if (config.warmupBars < static_cast<size_t>(config.longPeriod)) {
+        throw std::invalid_argument("Warm-up must cover the long period");
+    }
+    if (!LatencyModel(portfolio.latency).isZero()) {
+        throw std::invalid_argument("VectorizedBacktest fills on the signal bar, without latency");
+    }
+}
+
+const VectorizedResult& VectorizedBacktest::run(const BarColumns& bars) {
+    const size_t n = bars.size();
+    if (n < config_.warmupBars) {
+        throw std::runtime_error("Not enough historical data");
+    }
+
+    prefix_.resize(n + 1);
+    shortMA_.resize(n);
+    longMA_.resize(n);
+    signals_.resize(n);
+
+    // Indicators and signals for every bar at once, then fills and marks
+    prefixSum(bars.close, prefix_);
+    rollingMean(prefix_, config_.shortPeriod, shortMA_);
+    rollingMean(prefix_, config_.longPeriod, longMA_);
+    crossoverSignals(shortMA_, longMA_, signals_);
+
+    simulateFills(bars);
+    return result_;
+}
+
+void VectorizedBacktest::simulateFills(const BarColumns& bars) {
+    const size_t n = bars.size();
+    const size_t warmup = config_.warmupBars;
+
+    position_ = SimulatedPosition(portfolio_);
+    nextMark_ = 0;
+    result_.trades.clear();
+    result_.fills = 0;
+    result_.positions.resize(n);
+    // The engine never leaves the warm-up without a bar after it, and then has no curve
+    result_.equityCurve.resize(n > warmup ? n - warmup + 1 : 0);
+
+    // Bars [recorded, i) share the position and cash set by the last fill; they are written
+    // in one pass each, with marks as Portfolio::getTotalEquity: |position value| + cash
+    size_t recorded = 0;
+    auto record = [&](size_t end) {
+        const int quantity = position_.quantity();
+        const double cash = position_.cash();
+        std::fill(result_.positions.begin() + recorded, result_.positions.begin() + end, quantity);
+        EquityPoint* curve = result_.equityCurve.data();
+        for (size_t i = std::max(recorded, warmup); i < end; ++i) {
+            curve[i - warmup] = {bars.time[i], std::fabs(quantity * bars.close[i]) + cash};
+        }
+        recorded = end;
+    };
+
+    for (size_t i = warmup; i < n; ++i) {
+        if (signals_[i] == 0) continue;
+
+        record(i);
+
+        int quantity = crossoverOrderQuantity(signals_[i], bars.open[i], config_.maxInvest,
+                                              position_.quantity());
+        if (quantity != 0 && position_.accepts(quantity, bars.close[i])) {
+            applyFill(bars, i, quantity, bars.close[i]);
+        }
+    }
+    record(n);
+
+    // Final liquidation at the last close, as BacktestEngine::run
+    if (n > warmup) {
+        if (position_.quantity() != 0) {
+            applyFill(bars, n - 1, -position_.quantity(), bars.close[n - 1]);
+        }
+        result_.equityCurve.back() = {bars.time[n - 1], position_.cash()};
+    }
+}
+
+void VectorizedBacktest::applyFill(const BarColumns& bars, size_t index, int quantity,
+                                   double price) {
+    ++result_.fills;
+    // The engine marks every bar between two fills, this one's before it fills
+    if (position_.quantity() != 0) {
+        for (size_t i = nextMark_; i <= index; ++i) position_.mark(bars.low[i], bars.high[i]);
+    }
+    nextMark_ = index + 1;
+    std::optional<SimulatedPosition::Closed> closed =
+        position_.fill(quantity, price, bars.time[index]);
+    if (!closed) return;
+
+    Order fill{.time = bars.time[index],
+               .symbol = bars.symbol,
+               .direction = quantity > 0 ? SignalType::BUY : SignalType::SELL,
+               .price = price,
+               .type = OrderType::MARKET,
+               .quantity = quantity};
+    result_.trades.push_back(Trade{.order = fill,
+                                   .quantity = closed->quantity,
+                                   .pnl = closed->pnl,
+                                   .commission = portfolio_.commission,
+                                   .entryTime = closed->entryTime,
+                                   .mae = closed->mae,
+                                   .mfe = closed->mfe});
+}
@@ -0,0 +1,79 @@
+#include "backtest-cpp/walk_forward.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "backtest-cpp/thread_pool.h"
+
+std::vector<WalkForwardWindow> walkForwardWindows(size_t numBars, size_t firstBar,
+                                                  const WalkForwardConfig& config) {
+    if (config.inSampleBars == 0 || config.outOfSampleBars == 0) {
+        throw std::invalid_argument("Walk-forward windows must be at least one bar long");
+    }
+
+    std::vector<WalkForwardWindow> windows;
+    for (size_t start = firstBar; start + config.inSampleBars < numBars;
+         start += config.outOfSampleBars) {
+        size_t inSampleEnd = start + config.inSampleBars;
+        windows.push_back(
+            {.inSampleBegin = config.mode == WindowMode::ANCHORED ? firstBar : start,
+             .inSampleEnd = inSampleEnd,
+             .outOfSampleEnd = std::min(inSampleEnd + config.outOfSampleBars, numBars)});
+    }
+    return windows;
+}
+
+WalkForward::WalkForward(const BarColumns& bars, const SweepConfig& sweep,
+                         const WalkForwardConfig& config)
+    : bars_(bars), sweepConfig_(sweep), config_(config), sweep_(bars, sweep) {}
+
+WalkForwardResult WalkForward::run(std::span<const SMAParams> params) const {
+    if (params.empty()) {
+        throw std::invalid_argument("Walk-forward needs at least one parameter set");
+    }
+
+    // The first fold starts after the sweep's common warm-up
+    size_t firstBar = commonWarmup(sweepConfig_.engine.warmupBars, params);
+
+    WalkForwardResult result;
+    for (const WalkForwardWindow& window : walkForwardWindows(bars_.size(), firstBar, config_)) {
+        result.folds.push_back({.window = window});
+    }
+    std::vector<std::vector<EquityPoint>> curves(result.folds.size());
+
+    // Folds share nothing mutable: each writes its own fold and curve
+    ThreadPool pool(sweepConfig_.threads);
+    for (size_t f = 0; f < result.folds.size(); ++f) {
+        pool.submit([this, params, &result, &curves, f] {
+            WalkForwardFold& fold = result.folds[f];
+            std::vector<SweepResult> inSample = sweep_.runRange(
+                params, fold.window.inSampleBegin, fold.window.inSampleEnd);
+
+            // Ties go to the earlier combination, so the choice is reproducible
+            fold.inSample = inSample.front();
+            for (const SweepResult& candidate : inSample) {
+                if (candidate.sharpe > fold.inSample.sharpe) fold.inSample = candidate;
+            }
+
+            SMAParams best[] = {fold.inSample.params};
+            fold.outOfSample = sweep_.runRange(best, fold.window.inSampleEnd,
+                                               fold.window.outOfSampleEnd,
+                                               std::span(&curves[f], 1))
+                                   .front();
+        });
+    }
+    pool.wait();
+
+    // Each fold's run starts from the initial cash; scaling by the equity reached so far
+    // compounds the folds, keeping every return including the entry bar's commission
+    const double initialCash = sweepConfig_.portfolio.initialCash;
+    for (const std::vector<EquityPoint>& curve : curves) {
+        double scale = result.equityCurve.empty()
+                           ? 1.0
+                           : result.equityCurve.back().equity / initialCash;
+        for (const EquityPoint& point : curve) {
+            result.equityCurve.push_back({point.time, point.equity * scale});
+        }
+    }
+    return result;
+}
@@ -0,0 +1,45 @@
+#include "coroutine_smacrossover.h"
+
+#include <span>
+#include <stdexcept>
+
+CoroutineSMACrossover::CoroutineSMACrossover(int shortPeriod, int longPeriod)
+    : shortPeriod_(shortPeriod), longPeriod_(longPeriod) {
+    if (shortPeriod <= 0) {
+        throw std::invalid_argument("Indicator period must be > 0");
+    }
+    if (shortPeriod >= longPeriod) {
+        throw std::invalid_argument("Short period must be < long period");
+    }
+}
+
+CoroutineStrategy::Task CoroutineSMACrossover::run() {
+    if (history().size() < static_cast<size_t>(longPeriod_)) {
+        throw std::runtime_error("Not enough historical data");
+    }
+    IndicatorHandle shortMA = indicators().sma(shortPeriod_);
+    IndicatorHandle longMA = indicators().sma(longPeriod_);
+
+    for (;;) {
+        const std::map<std::string, Bar>& bars = co_await nextBar();
+        const IndicatorGraph& graph = indicators();
+        std::span<const uint32_t> ids = graph.barSymbols();
+
+        size_t i = 0;
+        for (const auto& [symbol, bar] : bars) {
+            uint32_t id = ids[i++];
+            if (!graph.ready(longMA, id)) {
+                continue;
+            }
+
+            bool previouslyAbove = graph.previous(shortMA, id) > graph.previous(longMA, id);
+            bool currentlyAbove = graph.value(shortMA, id) > graph.value(longMA, id);
+
+            if (!previouslyAbove && currentlyAbove) {
+                target(symbol, 1.0);
+            } else if (previouslyAbove && !currentlyAbove) {
+                target(symbol, -1.0);
+            }
+        }
+    }
+}
@@ -1,9 +1,11 @@
 #include "smacrossover.h"
 
+#include <algorithm>
 #include <cmath>
 #include <iostream>
 #include <map>
 #include <optional>
+#include <span>
 #include <stdexcept>
 #include <string>
 
@@ -11,83 +13,83 @@
 
 SMACrossover::SMACrossover(int shortPeriod, int longPeriod)
     : shortPeriod_(shortPeriod), longPeriod_(longPeriod) {
+    if (shortPeriod <= 0) {
+        throw std::invalid_argument("Indicator period must be > 0");
+    }
     if (shortPeriod >= longPeriod) {
         throw std::invalid_argument("Short period must be < long period");
     }
 }
 
-// onInit(const std::map<std::string, std::vector<Bar>>& availableData)
 void SMACrossover::onInit(const std::vector<std::map<std::string, Bar>>& availableData) {
-    size_t n = availableData.size();
+    checkHistory(availableData.size());
+    ownsIndicators_ = true;
+    declare(ownIndicators_);
+    ownIndicators_.warmUp(availableData);
+    initialized_ = true;
+}
+
+void SMACrossover::onInit(const std::vector<std::map<std::string, Bar>>& availableData,
+                          IndicatorGraph& indicators) {
+    checkHistory(availableData.size());
+    ownsIndicators_ = false;
+    sharedIndicators_ = &indicators;
+    declare(indicators);
+    initialized_ = true;
+}
 
-    if (n < static_cast<size_t>(longPeriod_)) {
+void SMACrossover::checkHistory(size_t numBars) const {
+    if (numBars < static_cast<size_t>(longPeriod_)) {
         throw std::runtime_error("Not enough historical data");
     }
+}
 
-    double shortSum = 0.0;
-    double longSum = 0.0;
-
-    for (size_t i = n - longPeriod_; i < n; i++) {
-        double closePrice = availableData[i].at("NQ").close;
-
-        longWindow_.push_back(closePrice);
-        longSum += closePrice;
-
-        if (i >= n - shortPeriod_) {
-            shortWindow_.push_back(closePrice);
-            shortSum += closePrice;
-        }
-    }
+void SMACrossover::declare(IndicatorGraph& indicators) {
+    shortMA_ = indicators.sma(shortPeriod_);
+    longMA_ = indicators.sma(longPeriod_);
+}
 
-    shortMA_ = shortSum / shortPeriod_;
-    longMA_ = longSum / longPeriod_;
-    prevShortMA_ = shortMA_;
-    prevLongMA_ = longMA_;
+std::map<std::string, std::optional<Signal>> SMACrossover::onBars(
+    const std::map<std::string, Bar>& bars, std::map<std::string, Position>& positions) {
+    scratch_.clear();
+    onBars(bars, positions, scratch_);
 
-    initialized_ = true;
+    std::map<std::string, std::optional<Signal>> signalMap;
+    scratch_.forEach([&](const Signal& signal) { signalMap[signal.symbol] = signal; });
+    return signalMap;
 }
 
-std::map<std::string, std::optional<Signal>> SMACrossover::onBars(
-    std::map<std::string, Bar>& bars, std::map<std::string, Position>& positions) {
+void SMACrossover::onBars(const std::map<std::string, Bar>& bars,
+                          std::map<std::string, Position>& /*positions*/,
+                          SignalBuffer& signals) {
     if (!initialized_) {
-        return {};  // Not ready yet
+        return;  // Not ready yet
     }
 
-    std::map<std::string, std::optional<Signal>> signalMap;
+    // Indicator update Logic, the engine has already advanced a shared graph
+    if (ownsIndicators_) {
+        ownIndicators_.update(bars);
+    }
+    const IndicatorGraph& graph = indicators();
+    std::span<const uint32_t> ids = graph.barSymbols();
 
+    // Trading Logic
+    size_t i = 0;
     for (const auto& [symbol, bar] : bars) {
-        double newPrice = bars[symbol].close;
-
-        // Indicator update Logic
-        prevShortMA_ = shortMA_;
-        prevLongMA_ = longMA_;
-
-        if (shortWindow_.size() >= static_cast<size_t>(shortPeriod_)) {
-            shortMA_ -= shortWindow_.front() / shortPeriod_;
-            shortWindow_.pop_front();
+        uint32_t id = ids[i++];
+        if (bar.synthetic || !graph.ready(longMA_, id)) {
+            continue;
         }
-        shortWindow_.push_back(newPrice);
-        shortMA_ += newPrice / shortPeriod_;
 
-        if (longWindow_.size() >= static_cast<size_t>(longPeriod_)) {
-            longMA_ -= longWindow_.front() / longPeriod_;
-            longWindow_.pop_front();
-        }
-        longWindow_.push_back(newPrice);
-        longMA_ += newPrice / longPeriod_;
-
-        // Trading Logic
-        bool previouslyAbove = prevShortMA_ > prevLongMA_;
-        bool currentlyAbove = shortMA_ > longMA_;
+        bool previouslyAbove = graph.previous(shortMA_, id) > graph.previous(longMA_, id);
+        bool currentlyAbove = graph.value(shortMA_, id) > graph.value(longMA_, id);
 
         if (!previouslyAbove && currentlyAbove) {
-            signalMap["NQ"] = Signal{bars[symbol].time, symbol, SignalType::BUY};
+            signals.set(Signal{bar.time, symbol, SignalType::BUY});
         } else if (previouslyAbove && !currentlyAbove) {
-            signalMap["NQ"] = Signal{bars[symbol].time, symbol, SignalType::SELL};
+            signals.set(Signal{bar.time, symbol, SignalType::SELL});
         }
     }
-
-    return signalMap;
 }
 
 Order SMACrossover::generateOrder(const Signal& signal, const Bar& currentBar,
@@ -147,4 +149,49 @@ std::map<std::string, Order> SMACrossover::generateOrders(
     }
 
     return orderMap;
-}
\ No newline at end of file
+}
+
+// In signal order, one generateOrder each
+void SMACrossover::generateOrders(const SignalBuffer& signals,
+                                  const std::map<std::string, Bar>& currentBars,
+                                  const double& maxInvest,
+                                  std::map<std::string, Position>& positions,
+                                  std::vector<Order>& orders) {
+    signals.forEach([&](const Signal& signal) {
+        orders.push_back(
+            generateOrder(signal, currentBars.at(signal.symbol), maxInvest, positions));
+    });
+}
+
+void SMACrossover::saveState(BinaryWriter& writer) const {
+    writer.write(shortPeriod_);
+    writer.write(longPeriod_);
+    writer.write(ownsIndicators_);
+    if (ownsIndicators_) {
+        ownIndicators_.saveState(writer);
+    }
+    writer.write(initialized_);
+}
+
+void SMACrossover::loadState(BinaryReader& reader) { readState(reader, nullptr); }
+
+void SMACrossover::loadState(BinaryReader& reader, IndicatorGraph& indicators) {
+    readState(reader, &indicators);
+}
+
+void SMACrossover::readState(BinaryReader& reader, IndicatorGraph* shared) {
+    if (reader.read<int>() != shortPeriod_ || reader.read<int>() != longPeriod_) {
+        throw std::runtime_error("Checkpoint was written with different SMA periods");
+    }
+    ownsIndicators_ = reader.read<bool>();
+    if (ownsIndicators_) {
+        ownIndicators_.loadState(reader);
+        declare(ownIndicators_);  // Finds the restored nodes
+    } else if (shared != nullptr) {
+        sharedIndicators_ = shared;
+        declare(*shared);
+    } else {
+        throw std::runtime_error("Checkpoint needs the indicator graph it was written with");
+    }
+    reader.read(initialized_);
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include "backtest-cpp/coroutine_strategy.h"
+#include "backtest-cpp/indicator_graph.h"
+
+// SMACrossover written as a CoroutineStrategy: the same SMAs from the IndicatorGraph and the
+// same signals and orders, as one loop awaiting the next bar. Kept to measure the coroutine
+// model against the callback one on identical work.
+class CoroutineSMACrossover final : public CoroutineStrategy {
+   public:
+    CoroutineSMACrossover(int shortPeriod = 10, int longPeriod = 30);
+
+   protected:
+    Task run() override;
+
+   private:
+    int shortPeriod_;
+    int longPeriod_;
+};
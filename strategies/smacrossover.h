@@ -1,33 +1,64 @@
 #pragma once
 
+#include "backtest-cpp/indicator_graph.h"
 #include "backtest-cpp/strategy.h"
 
-class SMACrossover : public Strategy {
+// Moving average crossover, tracked independently for every symbol. Both SMAs are nodes of
+// an IndicatorGraph, so all symbols advance together once per bar and a symbol missing from a
+// bar is carried forward at its last close. In an engine the graph is the engine's, shared
+// with every strategy declaring the same SMAs; called directly, the strategy keeps its own.
+// Signals are only emitted for symbols traded in the bar (not Bar::synthetic) whose long
+// window is full.
+// Final, so an engine instantiated on SMACrossover itself calls it without virtual dispatch
+class SMACrossover final : public Strategy {
    public:
     SMACrossover(int shortPeriod = 10, int longPeriod = 30);
 
     void onInit(const std::vector<std::map<std::string, Bar>>& availableData) override;
+    void onInit(const std::vector<std::map<std::string, Bar>>& availableData,
+                IndicatorGraph& indicators) override;
 
     std::map<std::string, std::optional<Signal>> onBars(
-        std::map<std::string, Bar>& bars, std::map<std::string, Position>& positions) override;
+        const std::map<std::string, Bar>& bars,
+        std::map<std::string, Position>& positions) override;
+    void onBars(const std::map<std::string, Bar>& bars, std::map<std::string, Position>& positions,
+                SignalBuffer& signals) override;
+
     Order generateOrder(const Signal& signal, const Bar& currentBar, const double& maxInvest,
                         std::map<std::string, Position>& positions) override;
 
     std::map<std::string, Order> generateOrders(
         const std::map<std::string, Signal>& signals, const std::map<std::string, Bar>& currentBars,
         const double& maxInvest, std::map<std::string, Position>& positions) override;
+    void generateOrders(const SignalBuffer& signals, const std::map<std::string, Bar>& currentBars,
+                        const double& maxInvest, std::map<std::string, Position>& positions,
+                        std::vector<Order>& orders) override;
+
+    bool readsPortfolio() const override { return false; }  // Signals only follow the SMAs
+
+    void saveState(BinaryWriter& writer) const override;
+    void loadState(BinaryReader& reader) override;
+    void loadState(BinaryReader& reader, IndicatorGraph& indicators) override;
 
    private:
+    void checkHistory(size_t numBars) const;
+    void declare(IndicatorGraph& indicators);
+    void readState(BinaryReader& reader, IndicatorGraph* shared);
+
+    const IndicatorGraph& indicators() const {
+        return ownsIndicators_ ? ownIndicators_ : *sharedIndicators_;
+    }
+
     int shortPeriod_;
     int longPeriod_;
 
-    std::deque<double> shortWindow_;
-    std::deque<double> longWindow_;
-
-    double shortMA_ = 0.0;
-    double longMA_ = 0.0;
-    double prevShortMA_ = 0.0;  // Track previous for crossover detection
-    double prevLongMA_ = 0.0;
+    IndicatorGraph ownIndicators_;  // Updated by onBars itself
+    IndicatorGraph* sharedIndicators_ = nullptr;
+    bool ownsIndicators_ = true;
+    IndicatorHandle shortMA_;
+    IndicatorHandle longMA_;
 
     bool initialized_ = false;
+
+    SignalBuffer scratch_;  // Backs the map-returning onBars
 };
\ No newline at end of file
@@ -0,0 +1,78 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "backtest-cpp/batch_metrics.h"
+#include "backtest-cpp/performance.h"
+
+class BatchMetricsTest : public ::testing::Test {
+   protected:
+    std::vector<std::vector<EquityPoint>> curves;
+
+    // Random walks of different drift and volatility, plus a flat one and one that loses
+    void SetUp() override {
+        std::mt19937_64 rng(5);
+        for (size_t run = 0; run < 37; ++run) {
+            std::normal_distribution<double> step(0.0002 * (run % 5) - 0.0004,
+                                                  0.001 * (1 + run % 3));
+            std::vector<EquityPoint> curve;
+            double equity = 100'000.0;
+            for (int64_t t = 0; t < 500; ++t) {
+                curve.push_back({t * 60, equity});
+                if (run != 0) equity *= std::exp(step(rng));
+            }
+            curves.push_back(curve);
+        }
+    }
+};
+
+TEST_F(BatchMetricsTest, SameAsPerCurveRiskMetrics) {
+    EquityMatrix matrix = EquityMatrix::fromCurves(curves);
+    ASSERT_EQ(matrix.runs, curves.size());
+    ASSERT_EQ(matrix.points(), 500);
+    EXPECT_EQ(matrix.at(7, 3), curves[3][7].equity);
+
+    std::vector<RiskMetrics> results =
+        batchRiskMetrics(matrix, {.riskFreeRate = 0.01, .blockRuns = 8, .threads = 2});
+    ASSERT_EQ(results.size(), curves.size());
+    for (size_t run = 0; run < curves.size(); ++run) {
+        RiskMetrics expected = Performance::riskMetrics(curves[run], Frequency::MINUTE, 0.01);
+        const RiskMetrics& actual = results[run];
+        EXPECT_EQ(actual.annualizedReturn, expected.annualizedReturn);
+        EXPECT_EQ(actual.annualizedVolatility, expected.annualizedVolatility);
+        EXPECT_EQ(actual.sharpe, expected.sharpe);
+        EXPECT_EQ(actual.sortino, expected.sortino);
+        EXPECT_EQ(actual.calmar, expected.calmar);
+        EXPECT_EQ(actual.maxDrawdown, expected.maxDrawdown);
+        EXPECT_EQ(actual.maxDrawdownDuration, expected.maxDrawdownDuration);
+        EXPECT_EQ(actual.ulcerIndex, expected.ulcerIndex);
+        EXPECT_EQ(actual.skewness, expected.skewness);
+        EXPECT_EQ(actual.excessKurtosis, expected.excessKurtosis);
+        EXPECT_EQ(actual.hitRate, expected.hitRate);
+    }
+    EXPECT_EQ(results[0].annualizedVolatility, 0.0);
+}
+
+TEST_F(BatchMetricsTest, IndependentOfBlocksAndThreads) {
+    EquityMatrix matrix = EquityMatrix::fromCurves(curves);
+    std::vector<RiskMetrics> serial = batchRiskMetrics(matrix, {.blockRuns = 1000, .threads = 1});
+    std::vector<RiskMetrics> parallel = batchRiskMetrics(matrix, {.blockRuns = 5, .threads = 4});
+    for (size_t run = 0; run < curves.size(); ++run) {
+        EXPECT_EQ(parallel[run].sharpe, serial[run].sharpe);
+        EXPECT_EQ(parallel[run].ulcerIndex, serial[run].ulcerIndex);
+    }
+}
+
+TEST_F(BatchMetricsTest, RejectsBadShapes) {
+    curves[4].pop_back();
+    EXPECT_THROW(EquityMatrix::fromCurves(curves), std::invalid_argument);
+
+    EquityMatrix shortMatrix{.runs = 1, .time = {0, 60}, .equity = {100.0, 101.0}};
+    EXPECT_THROW(batchRiskMetrics(shortMatrix), std::runtime_error);
+    EquityMatrix ragged{.runs = 2, .time = {0, 60, 120}, .equity = {100.0, 101.0, 102.0}};
+    EXPECT_THROW(batchRiskMetrics(ragged), std::invalid_argument);
+}
@@ -0,0 +1,237 @@
+#include <gtest/gtest.h>
+
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../strategies/coroutine_smacrossover.h"
+#include "../strategies/smacrossover.h"
+#include "backtest-cpp/coroutine_strategy.h"
+#include "backtest-cpp/data.h"
+#include "backtest-cpp/engine.h"
+#include "backtest-cpp/portfolio.h"
+#include "test_util.h"
+
+namespace {
+
+std::vector<std::map<std::string, Bar>> makeBars(size_t count) {
+    std::vector<std::map<std::string, Bar>> bars;
+    for (size_t i = 0; i < count; ++i) {
+        double price = 100.0 + static_cast<double>(i);
+        bars.push_back({{"NQ", Bar{"NQ", static_cast<int64_t>(i), price, price + 1, price - 1,
+                                   price, 100}}});
+    }
+    return bars;
+}
+
+// Steps through every awaitable once and records the bar each step resumed on
+class ScriptedStrategy : public CoroutineStrategy {
+   public:
+    std::vector<int64_t> resumedAt;
+    int fillQuantity = 0;
+    int watcherBars = 0;
+
+   protected:
+    Task run() override {
+        resumedAt.push_back(static_cast<int64_t>(history().size()));
+
+        co_await nextBar();
+        resumedAt.push_back(now());
+        trade("NQ", 2);
+        spawn(watch());
+
+        Order fill = co_await nextFill("NQ");
+        resumedAt.push_back(now());
+        fillQuantity = fill.quantity;
+
+        co_await skipBars(2);
+        resumedAt.push_back(now());
+        co_await waitUntil(11);
+        resumedAt.push_back(now());
+        co_await scaleIn(3);
+        resumedAt.push_back(now());
+    }
+
+   private:
+    int64_t now() const { return bars().at("NQ").time; }
+
+    Task scaleIn(int steps) {
+        for (int i = 0; i < steps; ++i) {
+            trade("NQ", 1);
+            co_await nextBar();
+        }
+    }
+
+    Task watch() {
+        for (;;) {
+            co_await nextBar();
+            ++watcherBars;
+        }
+    }
+};
+
+// Awaits a child task on every bar, so a frame is created and destroyed each time
+class ChildPerBarStrategy : public CoroutineStrategy {
+   public:
+    int steps = 0;
+    int throwAfter = -1;
+
+   protected:
+    Task run() override {
+        for (;;) {
+            co_await nextBar();
+            co_await step();
+        }
+    }
+
+   private:
+    Task step() {
+        if (++steps == throwAfter) throw std::runtime_error("step failed");
+        co_return;
+    }
+};
+
+}  // namespace
+
+// ============================================================================
+// Awaitables
+// ============================================================================
+
+TEST(CoroutineStrategyTest, ResumesOnBarsTimesAndFills) {
+    std::vector<std::map<std::string, Bar>> bars = makeBars(20);
+    std::map<std::string, Position> positions;
+    SignalBuffer signals;
+
+    ScriptedStrategy strategy;
+    strategy.onInit({bars.begin(), bars.begin() + 5});
+    ASSERT_EQ(strategy.resumedAt.size(), 1);
+    EXPECT_EQ(strategy.resumedAt[0], 5);  // Ran up to its first await with the history
+
+    std::vector<int> orders;  // Quantity ordered on each bar, 0 for none
+    for (size_t i = 5; i < bars.size(); ++i) {
+        signals.clear();
+        strategy.onBars(bars[i], positions, signals);
+
+        std::map<std::string, Signal> batch;
+        signals.forEach([&](const Signal& signal) { batch[signal.symbol] = signal; });
+        std::map<std::string, Order> generated =
+            strategy.generateOrders(batch, bars[i], 10'000, positions);
+        orders.push_back(generated.empty() ? 0 : generated.at("NQ").quantity);
+        for (const auto& [symbol, order] : generated) {
+            positions[symbol].quantity += order.quantity;
+            strategy.onFill(order);  // Filled within the bar, delivered on the next one
+        }
+    }
+
+    EXPECT_EQ(strategy.resumedAt, (std::vector<int64_t>{5, 5, 6, 8, 11, 14}));
+    EXPECT_EQ(strategy.fillQuantity, 2);
+    EXPECT_EQ(orders, (std::vector<int>{2, 0, 0, 0, 0, 0, 1, 1, 1, 0, 0, 0, 0, 0, 0}));
+    EXPECT_EQ(strategy.watcherBars, 14);  // Every bar after the one it was spawned on
+    EXPECT_EQ(strategy.numTasks(), 1);    // Only the watcher is left
+}
+
+TEST(CoroutineStrategyTest, TargetSizesLikeSMACrossover) {
+    class Flip : public CoroutineStrategy {
+       protected:
+        Task run() override {
+            for (double fraction = 1.0;; fraction = -fraction) {
+                co_await nextBar();
+                target("NQ", fraction);
+            }
+        }
+    } strategy;
+
+    std::vector<std::map<std::string, Bar>> bars = makeBars(3);
+    std::map<std::string, Position> positions;
+    positions["NQ"].quantity = 40;
+    SignalBuffer signals;
+    strategy.onInit({bars[0]});
+    strategy.onBars(bars[1], positions, signals);
+    signals.clear();
+    strategy.onBars(bars[2], positions, signals);
+
+    ASSERT_EQ(signals.count(), 1);
+    const Signal& signal = *signals.get(signals.slotOf("NQ"));
+    EXPECT_EQ(signal.type, SignalType::SELL);
+    Order order = strategy.generateOrder(signal, bars[2].at("NQ"), 10'000, positions);
+    EXPECT_EQ(order.quantity, -static_cast<int>(std::floor(10'000 / 102.0)) - 40);
+    EXPECT_EQ(order.price, 102.0);
+}
+
+// ============================================================================
+// Frames and Errors
+// ============================================================================
+
+TEST(CoroutineStrategyTest, FramesAreReusedFromThePool) {
+    std::vector<std::map<std::string, Bar>> bars = makeBars(2'000);
+    std::map<std::string, Position> positions;
+    SignalBuffer signals;
+
+    ChildPerBarStrategy strategy;
+    strategy.onInit({bars[0]});
+    for (size_t i = 1; i < bars.size(); ++i) strategy.onBars(bars[i], positions, signals);
+
+    EXPECT_EQ(strategy.steps, 1'999);
+    EXPECT_EQ(strategy.framePool().chunks(), 1);
+    EXPECT_EQ(strategy.framePool().live(), 1);  // The root, every child frame was returned
+}
+
+TEST(CoroutineStrategyTest, ExceptionsReachTheCaller) {
+    std::vector<std::map<std::string, Bar>> bars = makeBars(10);
+    std::map<std::string, Position> positions;
+    SignalBuffer signals;
+
+    ChildPerBarStrategy strategy;
+    strategy.throwAfter = 3;
+    strategy.onInit({bars[0]});
+    strategy.onBars(bars[1], positions, signals);
+    strategy.onBars(bars[2], positions, signals);
+    EXPECT_THROW(strategy.onBars(bars[3], positions, signals), std::runtime_error);
+    EXPECT_EQ(strategy.numTasks(), 0);
+
+    BinaryWriter writer;
+    EXPECT_THROW(strategy.saveState(writer), std::runtime_error);
+}
+
+// ============================================================================
+// Engine
+// ============================================================================
+
+class CoroutineEngineTest : public ::testing::Test {
+   protected:
+    DataHandler data;
+    std::string testFilePath = "test_coroutine_temp.csv";
+
+    void SetUp() override {
+        writeSineCsv(testFilePath, 300);
+        data.loadCSV(testFilePath, "NQ");
+    }
+
+    void TearDown() override { std::remove(testFilePath.c_str()); }
+};
+
+TEST_F(CoroutineEngineTest, MatchesCallbackCrossover) {
+    EngineConfig config{.warmupBars = 30, .maxInvest = 10'000, .logOrders = false};
+    PortfolioConfig portfolioConfig{.initialCash = 100'000.0, .commission = 2.7,
+                                    .logTrades = false};
+
+    SMACrossover callback(10, 30);
+    Portfolio callbackPortfolio(portfolioConfig);
+    BacktestEngine callbackEngine(data, callback, callbackPortfolio, config);
+    callbackEngine.run();
+
+    CoroutineSMACrossover coroutine(10, 30);
+    Portfolio coroutinePortfolio(portfolioConfig);
+    BacktestEngine coroutineEngine(data, coroutine, coroutinePortfolio, config);
+    coroutineEngine.run();
+
+    ASSERT_GT(callbackPortfolio.getAllTrades().size(), 0);
+    EXPECT_EQ(coroutinePortfolio.getAllTrades().size(), callbackPortfolio.getAllTrades().size());
+    EXPECT_EQ(coroutineEngine.getStats().events, callbackEngine.getStats().events);
+    const std::vector<EquityPoint>& curve = coroutineEngine.getEquityCurve();
+    ASSERT_EQ(curve.size(), callbackEngine.getEquityCurve().size());
+    for (size_t i = 0; i < curve.size(); ++i) {
+        EXPECT_EQ(curve[i].equity, callbackEngine.getEquityCurve()[i].equity);
+    }
+}
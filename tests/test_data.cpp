@@ -357,6 +357,85 @@ TEST_F(DataHandlerTest, LoadMultipleFiles) {
     std::remove(secondFile.c_str());
 }
 
+TEST_F(DataHandlerTest, SynchronizeAlignsAndForwardFills) {
+    std::ofstream first(testFilePath);
+    first << "DateTime,Open,High,Low,Close,Volume\n";
+    first << "2008-01-02 06:00:00,3090,3092,3090,3091,100\n";
+    first << "2008-01-02 06:01:00,3091,3093,3091,3092,100\n";
+    first << "2008-01-02 06:02:00,3092,3094,3092,3093,100\n";
+    first.close();
+    data->loadCSV(testFilePath, "NQ");
+
+    std::string secondFile = "test_data_temp2.csv";
+    std::ofstream second(secondFile);
+    second << "DateTime,Open,High,Low,Close,Volume\n";
+    second << "2008-01-02 06:01:00,1440,1441,1439,1440,50\n";
+    second << "2008-01-02 06:03:00,1441,1442,1440,1442,50\n";  // After the last NQ bar
+    second.close();
+    data->loadCSV(secondFile, "ES");
+    std::remove(secondFile.c_str());
+
+    data->synchronize();
+    ASSERT_EQ(data->size(), 4);
+
+    std::map<std::string, Bar> bars = data->getNextBars();
+    EXPECT_EQ(bars.size(), 1);  // ES has no data yet
+    EXPECT_EQ(bars.count("NQ"), 1);
+
+    bars = data->getNextBars();
+    ASSERT_EQ(bars.size(), 2);
+    EXPECT_EQ(bars["ES"].time, bars["NQ"].time);
+    EXPECT_DOUBLE_EQ(bars["ES"].close, 1440.0);
+
+    bars = data->getNextBars();
+    ASSERT_EQ(bars.size(), 2);
+    EXPECT_EQ(bars["ES"].time, bars["NQ"].time);  // Forward-filled onto the NQ timestamp
+    EXPECT_DOUBLE_EQ(bars["ES"].open, 1440.0);
+    EXPECT_DOUBLE_EQ(bars["ES"].close, 1440.0);
+    EXPECT_EQ(bars["ES"].volume, 0);
+    EXPECT_TRUE(bars["ES"].synthetic);
+    EXPECT_FALSE(bars["NQ"].synthetic);
+
+    bars = data->getNextBars();
+    EXPECT_EQ(bars["NQ"].time, bars["ES"].time);
+    EXPECT_DOUBLE_EQ(bars["NQ"].close, 3093.0);
+    EXPECT_EQ(bars["NQ"].volume, 0);
+    EXPECT_DOUBLE_EQ(bars["ES"].close, 1442.0);
+    EXPECT_FALSE(data->hasMoreData());
+}
+
+TEST_F(DataHandlerTest, SplitKeepsEachGroupsBars) {
+    std::ofstream first(testFilePath);
+    first << "DateTime,Open,High,Low,Close,Volume\n";
+    first << "2008-01-02 06:00:00,3090,3092,3090,3091,100\n";
+    first << "2008-01-02 06:01:00,3091,3093,3091,3092,100\n";
+    first.close();
+    data->loadCSV(testFilePath, "NQ");
+
+    std::string secondFile = "test_data_temp2.csv";
+    std::ofstream second(secondFile);
+    second << "DateTime,Open,High,Low,Close,Volume\n";
+    second << "2008-01-02 06:01:00,1440,1441,1439,1440,50\n";
+    second.close();
+    data->loadCSV(secondFile, "ES");
+    std::remove(secondFile.c_str());
+    data->synchronize();
+
+    EXPECT_EQ(data->symbols(), (std::vector<std::string>{"ES", "NQ"}));
+    std::vector<DataHandler> parts = data->split({{"ES"}, {"NQ", "YM"}, {"NQ"}});
+    ASSERT_EQ(parts.size(), 3);
+
+    ASSERT_EQ(parts[0].size(), 1);  // No cross-section before ES starts
+    EXPECT_EQ(parts[0].getBarsAt(0).size(), 1);
+    EXPECT_DOUBLE_EQ(parts[0].getBarsAt(0).at("ES").close, 1440.0);
+
+    ASSERT_EQ(parts[1].size(), 2);
+    EXPECT_EQ(parts[1].getBarsAt(1).count("ES"), 0);
+    EXPECT_DOUBLE_EQ(parts[1].getBarsAt(1).at("NQ").close, 3092.0);
+
+    EXPECT_EQ(parts[2].size(), 0);  // NQ already went to the second group
+}
+
 // ============================================================================
 // Edge Cases
 // ============================================================================
@@ -0,0 +1,648 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <new>
+
+#include "../strategies/smacrossover.h"
+#include "backtest-cpp/data.h"
+#include "backtest-cpp/engine.h"
+#include "backtest-cpp/multi_engine.h"
+#include "backtest-cpp/portfolio.h"
+#include "backtest-cpp/ring_buffer.h"
+#include "test_util.h"
+
+// Heap allocations of the whole binary, counted while countAllocations is set
+namespace {
+std::atomic<bool> countAllocations = false;
+std::atomic<size_t> allocations = 0;
+}  // namespace
+
+void* operator new(size_t size) {
+    if (countAllocations.load(std::memory_order_relaxed)) ++allocations;
+    if (void* p = std::malloc(size == 0 ? 1 : size)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t /*size*/) noexcept { std::free(p); }
+
+// ============================================================================
+// RingBuffer Tests
+// ============================================================================
+
+TEST(RingBufferTest, CapacityRoundsUpToPowerOfTwo) {
+    RingBuffer<int> ring(5);
+    EXPECT_EQ(ring.capacity(), 8);
+    EXPECT_TRUE(ring.empty());
+}
+
+TEST(RingBufferTest, FifoOrderAcrossWrapAround) {
+    RingBuffer<int> ring(4);
+    for (int round = 0; round < 3; ++round) {
+        for (int i = 0; i < 4; ++i) ring.push_back(round * 10 + i);
+        EXPECT_TRUE(ring.full());
+        EXPECT_EQ(ring[1], round * 10 + 1);
+        EXPECT_EQ(ring.back(), round * 10 + 3);
+        for (int i = 0; i < 4; ++i) {
+            EXPECT_EQ(ring.front(), round * 10 + i);
+            ring.pop_front();
+        }
+    }
+    EXPECT_TRUE(ring.empty());
+}
+
+TEST(RingBufferTest, PushWhenFullThrows) {
+    RingBuffer<int> ring(2);
+    ring.push_back(1);
+    ring.push_back(2);
+    EXPECT_THROW(ring.push_back(3), std::length_error);
+}
+
+// ============================================================================
+// BacktestEngine Tests
+// ============================================================================
+
+class BacktestEngineTest : public ::testing::Test {
+   protected:
+    DataHandler data;
+    std::string testFilePath = "test_engine_temp.csv";
+
+    void SetUp() override {
+        writeSineCsv(testFilePath, 300);
+        data.loadCSV(testFilePath, "NQ");
+    }
+
+    void TearDown() override {
+        std::remove(testFilePath.c_str());
+    }
+
+    EngineConfig quietConfig() {
+        return {.warmupBars = 30, .maxInvest = 10'000, .logOrders = false};
+    }
+};
+
+TEST_F(BacktestEngineTest, ProcessesEveryBarAfterWarmup) {
+    Portfolio portfolio({.initialCash = 100'000.0, .commission = 2.7});
+    SMACrossover strategy(10, 30);
+    BacktestEngine engine(data, strategy, portfolio, quietConfig());
+
+    const EngineStats& stats = engine.run();
+
+    EXPECT_EQ(stats.bars, 270);
+    EXPECT_EQ(engine.getEquityCurve().size(), 271);  // + final liquidation
+    EXPECT_EQ(stats.eventsByType[static_cast<size_t>(EventType::MARKET)], 270);
+    EXPECT_GT(stats.eventsByType[static_cast<size_t>(EventType::FILL)], 0);
+    EXPECT_GT(stats.eventsPerSecond(), 0.0);
+    EXPECT_TRUE(portfolio.getCurrentPositions().empty());
+}
+
+TEST_F(BacktestEngineTest, EventCountsAreConsistent) {
+    Portfolio portfolio({.initialCash = 100'000.0, .commission = 2.7});
+    SMACrossover strategy(10, 30);
+    BacktestEngine engine(data, strategy, portfolio, quietConfig());
+
+    const EngineStats& stats = engine.run();
+
+    uint64_t total = 0;
+    for (uint64_t count : stats.eventsByType) total += count;
+    EXPECT_EQ(total, stats.events);
+    EXPECT_EQ(stats.eventsByType[static_cast<size_t>(EventType::SIGNAL)],
+              stats.eventsByType[static_cast<size_t>(EventType::ORDER)]);
+}
+
+TEST_F(BacktestEngineTest, RunsAreDeterministic) {
+    Portfolio portfolioA({.initialCash = 100'000.0, .commission = 2.7});
+    Portfolio portfolioB({.initialCash = 100'000.0, .commission = 2.7});
+    SMACrossover strategyA(10, 30);
+    SMACrossover strategyB(10, 30);
+    BacktestEngine engineA(data, strategyA, portfolioA, quietConfig());
+    BacktestEngine engineB(data, strategyB, portfolioB, quietConfig());
+
+    engineA.run();
+    engineB.run();
+
+    const auto& curveA = engineA.getEquityCurve();
+    const auto& curveB = engineB.getEquityCurve();
+    ASSERT_EQ(curveA.size(), curveB.size());
+    for (size_t i = 0; i < curveA.size(); ++i) {
+        EXPECT_EQ(curveA[i].equity, curveB[i].equity);
+    }
+}
+
+TEST_F(BacktestEngineTest, LatencyDelaysFills) {
+    Portfolio portfolio({.initialCash = 100'000.0, .commission = 2.7, .latency = {.delayNs = 1}});
+    SMACrossover strategy(10, 30);
+    BacktestEngine engine(data, strategy, portfolio, quietConfig());
+
+    const EngineStats& stats = engine.run();
+
+    // Every order still fills, one bar later
+    EXPECT_EQ(stats.eventsByType[static_cast<size_t>(EventType::FILL)],
+              stats.eventsByType[static_cast<size_t>(EventType::ORDER)]);
+}
+
+TEST_F(BacktestEngineTest, LatencyKeepsRiskChecks) {
+    // Every order breaks the one-contract limit, whether it executes now or on arrival
+    for (int64_t delayNs : {0, 1}) {
+        Portfolio portfolio({.initialCash = 100'000.0,
+                             .commission = 2.7,
+                             .latency = {.delayNs = delayNs},
+                             .maxPositionSize = 1});
+        SMACrossover strategy(10, 30);
+        BacktestEngine engine(data, strategy, portfolio, quietConfig());
+
+        const EngineStats& stats = engine.run();
+
+        EXPECT_GT(stats.eventsByType[static_cast<size_t>(EventType::ORDER)], 0) << delayNs;
+        EXPECT_EQ(stats.eventsByType[static_cast<size_t>(EventType::FILL)], 0) << delayNs;
+        EXPECT_TRUE(portfolio.getAllTrades().empty()) << delayNs;
+    }
+}
+
+TEST_F(BacktestEngineTest, ForwardFilledBarsNeitherSignalNorFill) {
+    // ES falls, jumps back on its last bar before a gap and is forward-filled at that close
+    // while NQ trades on; its short SMA crosses the long one during the gap
+    std::vector<std::map<std::string, Bar>> raw;
+    for (int64_t i = 0; i < 200; ++i) {
+        double nq = 3700.0 + 50.0 * std::sin(i / 15.0);
+        raw.push_back({{"NQ", Bar{"NQ", i, nq, nq + 1, nq - 1, nq, 1000}}});
+        if (i <= 60 || i >= 100) {
+            double es = i < 60 ? 5000.0 - 4.0 * i : 5000.0;
+            raw.back()["ES"] = Bar{"ES", i, es, es + 1, es - 1, es, 1000};
+        }
+    }
+    DataHandler gapped;
+    gapped.synchronize(raw);
+    auto isGap = [](int64_t time) { return time > 60 && time < 100; };
+    ASSERT_TRUE(gapped.getBarsAt(80).at("ES").synthetic);
+
+    SMACrossover standalone(10, 30);
+    standalone.onInit({raw.begin(), raw.begin() + 30});
+    std::map<std::string, Position> positions;
+    SignalBuffer signals;
+    for (size_t i = 30; i < gapped.size(); ++i) {
+        signals.clear();
+        standalone.onBars(gapped.getBarsAt(i), positions, signals);
+        signals.forEach([&](const Signal& signal) {
+            EXPECT_FALSE(signal.symbol == "ES" && isGap(signal.time)) << signal.time;
+        });
+    }
+
+    Portfolio portfolio({.initialCash = 100'000.0, .commission = 2.7, .logTrades = false});
+    SMACrossover strategy(10, 30);
+    BacktestEngine engine(gapped, strategy, portfolio, quietConfig());
+    engine.run();
+    for (const Order& fill : portfolio.getAllOrders(0)) {
+        EXPECT_FALSE(fill.symbol == "ES" && isGap(fill.time)) << fill.time;
+    }
+}
+
+TEST_F(BacktestEngineTest, SteadyStateBarsDoNotAllocate) {
+    Portfolio portfolio({.initialCash = 100'000.0, .commission = 2.7, .logTrades = false});
+    portfolio.reserveJournals(1'000, 1'000);
+    SMACrossover strategy(10, 30);
+    BacktestEngine engine(data, strategy, portfolio, quietConfig());
+
+    std::vector<std::map<std::string, Bar>> history;
+    for (size_t i = 0; i < 30; ++i) history.push_back(data.getBarsAt(i));
+    engine.warmUp(history);
+    // Once a trade has closed, every buffer has seen the symbol and an order
+    size_t i = 30;
+    for (; i < data.size() && portfolio.getTrades().empty(); ++i) engine.processBar(i);
+    size_t trades = portfolio.getTrades().size();
+
+    allocations = 0;
+    countAllocations = true;
+    for (; i < data.size(); ++i) engine.processBar(i);
+    countAllocations = false;
+
+    EXPECT_GT(portfolio.getTrades().size(), trades);  // Bars with signals and fills included
+    EXPECT_EQ(allocations, 0);
+}
+
+TEST_F(BacktestEngineTest, StaticDispatchMatchesVirtual) {
+    Portfolio portfolioA({.initialCash = 100'000.0, .commission = 2.7});
+    Portfolio portfolioB({.initialCash = 100'000.0, .commission = 2.7});
+    SMACrossover strategyA(10, 30);
+    SMACrossover strategyB(10, 30);
+    BacktestEngine virtualEngine(data, strategyA, portfolioA, quietConfig());
+    BasicBacktestEngine<SMACrossover> staticEngine(data, strategyB, portfolioB, quietConfig());
+
+    virtualEngine.run();
+    staticEngine.run();
+
+    EXPECT_EQ(staticEngine.getStats().events, virtualEngine.getStats().events);
+    EXPECT_EQ(portfolioB.getAllTrades().size(), portfolioA.getAllTrades().size());
+    EXPECT_EQ(staticEngine.getEquityCurve().back().equity,
+              virtualEngine.getEquityCurve().back().equity);
+}
+
+TEST_F(BacktestEngineTest, RunsOnAnyPortfolioType) {
+    PortfolioConfig config{.initialCash = 100'000.0, .logTrades = false};
+    BasicPortfolio<PerContractCommission, FixedTickSlippage> typed(config, {1.5}, {});
+    RuntimePortfolio runtime(config, RuntimeCommission(PerContractCommission{1.5}),
+                             RuntimeSlippage(FixedTickSlippage{}));
+    Portfolio free(config);
+    SMACrossover strategyA(10, 30);
+    SMACrossover strategyB(10, 30);
+    SMACrossover strategyC(10, 30);
+    BasicBacktestEngine<SMACrossover, decltype(typed)> typedEngine(data, strategyA, typed,
+                                                                   quietConfig());
+    BasicBacktestEngine<Strategy, RuntimePortfolio> runtimeEngine(data, strategyB, runtime,
+                                                                  quietConfig());
+    BasicBacktestEngine<SMACrossover> freeEngine(data, strategyC, free, quietConfig());
+    typedEngine.run();
+    runtimeEngine.run();
+    freeEngine.run();
+
+    // The same costs chosen at compile time or at runtime; without them the same trades gain
+    ASSERT_GT(typed.getAllTrades().size(), 0);
+    EXPECT_EQ(runtime.getAllTrades().size(), typed.getAllTrades().size());
+    EXPECT_EQ(free.getAllTrades().size(), typed.getAllTrades().size());
+    EXPECT_EQ(runtimeEngine.getEquityCurve().back().equity,
+              typedEngine.getEquityCurve().back().equity);
+    EXPECT_GT(freeEngine.getEquityCurve().back().equity,
+              typedEngine.getEquityCurve().back().equity);
+}
+
+// ============================================================================
+// MultiStrategyEngine Tests
+// ============================================================================
+
+TEST_F(BacktestEngineTest, MultiStrategyMatchesStandaloneRuns) {
+    std::vector<StrategyAllocation> allocations = {
+        {.name = "fast",
+         .portfolio = {.initialCash = 50'000.0, .commission = 2.7, .logTrades = false},
+         .maxInvest = 10'000},
+        {.name = "slow",
+         .portfolio = {.initialCash = 30'000.0, .commission = 1.0, .logTrades = false},
+         .maxInvest = 20'000},
+        {.name = "delayed",
+         .portfolio = {.initialCash = 20'000.0,
+                       .commission = 2.7,
+                       .latency = {.delayNs = 1},
+                       .logTrades = false},
+         .maxInvest = 5'000}};
+    std::vector<SMACrossover> strategies = {{5, 20}, {10, 30}, {8, 25}};
+
+    MultiStrategyEngine multi(data, quietConfig());
+    for (size_t i = 0; i < allocations.size(); ++i) {
+        EXPECT_EQ(multi.addStrategy(strategies[i], allocations[i]), i);
+    }
+    multi.run();
+
+    ASSERT_EQ(multi.size(), 3);
+    for (size_t i = 0; i < allocations.size(); ++i) {
+        SMACrossover strategy = i == 0 ? SMACrossover(5, 20)
+                                : i == 1 ? SMACrossover(10, 30)
+                                         : SMACrossover(8, 25);
+        Portfolio portfolio(allocations[i].portfolio);
+        EngineConfig config = quietConfig();
+        config.maxInvest = allocations[i].maxInvest;
+        BacktestEngine engine(data, strategy, portfolio, config);
+        engine.run();
+
+        EXPECT_EQ(multi.name(i), allocations[i].name);
+        EXPECT_EQ(multi.getStats(i).events, engine.getStats().events);
+        EXPECT_EQ(multi.getPortfolio(i).getAllTrades().size(), portfolio.getAllTrades().size());
+        const std::vector<EquityPoint>& curve = multi.getEquityCurve(i);
+        ASSERT_EQ(curve.size(), engine.getEquityCurve().size());
+        for (size_t j = 0; j < curve.size(); ++j) {
+            EXPECT_EQ(curve[j].equity, engine.getEquityCurve()[j].equity);
+        }
+    }
+}
+
+TEST_F(BacktestEngineTest, MultiStrategyAggregatesEquity) {
+    SMACrossover fast(5, 20);
+    SMACrossover slow(10, 30);
+    MultiStrategyEngine multi(data, quietConfig());
+    multi.addStrategy(fast, {.name = "fast",
+                             .portfolio = {.initialCash = 60'000.0,
+                                           .commission = 0.0,
+                                           .logTrades = false}});
+    multi.addStrategy(slow, {.name = "slow",
+                             .portfolio = {.initialCash = 40'000.0,
+                                           .commission = 0.0,
+                                           .logTrades = false}});
+    multi.run();
+
+    const std::vector<EquityPoint>& aggregate = multi.getAggregateEquityCurve();
+    ASSERT_EQ(aggregate.size(), 271);
+    for (size_t i = 0; i < aggregate.size(); ++i) {
+        EXPECT_EQ(aggregate[i].time, multi.getEquityCurve(0)[i].time);
+        EXPECT_DOUBLE_EQ(aggregate[i].equity,
+                         multi.getEquityCurve(0)[i].equity + multi.getEquityCurve(1)[i].equity);
+    }
+    EXPECT_GT(multi.getPortfolio(0).getAllTrades().size(), 0);
+}
+
+TEST_F(BacktestEngineTest, MultiStrategySharesIndicators) {
+    std::vector<SMACrossover> strategies = {{5, 20}, {10, 20}, {5, 30}};
+    MultiStrategyEngine multi(data, quietConfig());
+    for (SMACrossover& strategy : strategies) {
+        multi.addStrategy(strategy, {.portfolio = {.initialCash = 100'000.0,
+                                                   .commission = 2.7,
+                                                   .logTrades = false}});
+    }
+    multi.run();
+
+    // The closes plus one SMA per distinct period
+    EXPECT_EQ(multi.getIndicators().numNodes(), 5);
+    for (size_t i = 0; i < strategies.size(); ++i) {
+        SMACrossover strategy = i == 0 ? SMACrossover(5, 20)
+                                : i == 1 ? SMACrossover(10, 20)
+                                         : SMACrossover(5, 30);
+        Portfolio portfolio({.initialCash = 100'000.0, .commission = 2.7, .logTrades = false});
+        BacktestEngine engine(data, strategy, portfolio, quietConfig());
+        engine.run();
+        EXPECT_EQ(engine.getIndicators().numNodes(), 3);
+        EXPECT_EQ(multi.getPortfolio(i).getAllTrades().size(), portfolio.getAllTrades().size());
+        EXPECT_EQ(multi.getEquityCurve(i).back().equity, engine.getEquityCurve().back().equity);
+    }
+    EXPECT_GT(multi.getPortfolio(0).getAllTrades().size(), 0);
+}
+
+TEST_F(BacktestEngineTest, PerformanceWithoutStoredCurve) {
+    Portfolio kept({.initialCash = 100'000.0, .commission = 2.7, .logTrades = false});
+    SMACrossover keptStrategy(10, 30);
+    BacktestEngine withCurve(data, keptStrategy, kept, quietConfig());
+    withCurve.run();
+
+    EngineConfig config = quietConfig();
+    config.keepEquityCurve = false;
+    Portfolio portfolio({.initialCash = 100'000.0, .commission = 2.7, .logTrades = false});
+    SMACrossover strategy(10, 30);
+    BacktestEngine engine(data, strategy, portfolio, config);
+    engine.run();
+
+    const auto& curve = withCurve.getEquityCurve();
+    const PerformanceAccumulator& performance = engine.getPerformance();
+    EXPECT_TRUE(engine.getEquityCurve().empty());
+    EXPECT_EQ(performance.size(), curve.size());
+    EXPECT_EQ(performance.lastEquity(), curve.back().equity);
+    double vol = Performance::annualizedVolatility(curve, Frequency::MINUTE);
+    EXPECT_NEAR(performance.annualizedVolatility(Frequency::MINUTE), vol, 1e-12 * vol);
+    EXPECT_EQ(performance.maxDrawdown(), Performance::maxDrawdown(curve));
+}
+
+TEST_F(BacktestEngineTest, RollingSeriesAlongsideEquityCurve) {
+    EngineConfig config = quietConfig();
+    config.rollingWindows = {{.bars = 20}, {.bars = 60, .frequency = Frequency::HOURLY}};
+    Portfolio portfolio({.initialCash = 100'000.0, .commission = 2.7, .logTrades = false});
+    SMACrossover strategy(10, 30);
+    BacktestEngine engine(data, strategy, portfolio, config);
+    engine.run();
+
+    const auto& curve = engine.getEquityCurve();
+    for (size_t w = 0; w < config.rollingWindows.size(); ++w) {
+        const std::vector<RollingPoint>& series = engine.getRollingSeries(w);
+        size_t bars = config.rollingWindows[w].bars;
+        ASSERT_EQ(series.size(), curve.size());
+        EXPECT_TRUE(std::isnan(series[bars - 1].volatility));
+        for (size_t i = bars; i < curve.size(); ++i) {
+            EXPECT_EQ(series[i].time, curve[i].time);
+            std::vector<EquityPoint> slice(curve.begin() + i - bars, curve.begin() + i + 1);
+            Frequency freq = config.rollingWindows[w].frequency;
+            double vol = Performance::annualizedVolatility(slice, freq);
+            EXPECT_NEAR(series[i].volatility, vol, 1e-9 * vol + 1e-12);
+        }
+    }
+    EXPECT_THROW(engine.getRollingSeries(2), std::out_of_range);
+}
+
+TEST_F(BacktestEngineTest, SketchesEveryReturnAndTrade) {
+    EngineConfig config = quietConfig();
+    config.quantileSketchK = 200;  // Holds this whole run, so quantiles are exact
+    Portfolio portfolio({.initialCash = 100'000.0, .commission = 2.7, .logTrades = false});
+    SMACrossover strategy(10, 30);
+    BacktestEngine engine(data, strategy, portfolio, config);
+    engine.run();
+
+    const auto& curve = engine.getEquityCurve();
+    std::vector<Trade> trades = portfolio.getAllTrades();
+    ASSERT_GT(trades.size(), 0);
+    EXPECT_EQ(engine.getReturnSketch().count(), curve.size() - 1);
+    EXPECT_EQ(engine.getTradeSketch().count(), trades.size());
+
+    double worst = 0.0;
+    for (size_t i = 1; i < curve.size(); ++i) {
+        worst = std::min(worst, std::log(curve[i].equity / curve[i - 1].equity));
+    }
+    EXPECT_EQ(engine.getReturnSketch().min(), worst);
+    double best = trades.front().pnl;
+    for (const Trade& trade : trades) best = std::max(best, trade.pnl);
+    EXPECT_EQ(engine.getTradeSketch().max(), best);
+}
+
+TEST_F(BacktestEngineTest, TradeStatsMatchTradeLog) {
+    Portfolio portfolio({.initialCash = 100'000.0, .commission = 2.7, .logTrades = false});
+    SMACrossover strategy(10, 30);
+    BacktestEngine engine(data, strategy, portfolio, quietConfig());
+    engine.run();
+
+    const TradeStats& stats = portfolio.getTradeStats();
+    ASSERT_GT(stats.trades, 0);
+    EXPECT_EQ(stats.trades, portfolio.getTrades().size());
+
+    size_t wins = 0;
+    double mae = 0.0;
+    for (const Trade& trade : portfolio.getTrades()) {
+        wins += trade.pnl > 0.0;
+        mae += trade.mae;
+        // Marked on every bar the position was held, so the exit lies inside the range
+        double gross = trade.pnl + trade.commission;
+        EXPECT_LE(trade.mae, gross + 1e-9);
+        EXPECT_GE(trade.mfe, gross - 1e-9);
+        EXPECT_LE(trade.mae, 0.0);
+        EXPECT_GE(trade.mfe, 0.0);
+        EXPECT_GT(trade.order.time, trade.entryTime);
+    }
+    EXPECT_EQ(stats.wins, wins);
+    EXPECT_DOUBLE_EQ(stats.averageMae(), mae / stats.trades);
+}
+
+// ============================================================================
+// Checkpoint Tests
+// ============================================================================
+
+class CheckpointTest : public BacktestEngineTest {
+   protected:
+    std::string dir = "test_engine_checkpoints";
+
+    void SetUp() override {
+        BacktestEngineTest::SetUp();
+        std::filesystem::create_directory(dir);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(dir);
+        BacktestEngineTest::TearDown();
+    }
+
+    // Jittered latency so pending orders and the RNG are part of the state
+    PortfolioConfig portfolioConfig() {
+        return {.initialCash = 100'000.0,
+                .commission = 2.7,
+                .latency = {.type = LatencyType::UNIFORM,
+                            .delayNs = 1,
+                            .jitterNs = 90'000'000'000}};
+    }
+};
+
+TEST_F(CheckpointTest, ResumeIsBitIdentical) {
+    EngineConfig config = quietConfig();
+    config.checkpointEvery = 50;
+    config.checkpointDir = dir;
+    config.rollingWindows = {{.bars = 40}};
+    config.quantileSketchK = 16;  // Small enough to compact during the run
+
+    Portfolio portfolio(portfolioConfig());
+    SMACrossover strategy(10, 30);
+    BacktestEngine engine(data, strategy, portfolio, config);
+    engine.run();
+
+    // Replay from the snapshot nearest to bar 200
+    std::optional<std::string> path = BacktestEngine::findCheckpoint(dir, 200);
+    ASSERT_TRUE(path.has_value());
+    EXPECT_EQ(*path, engine.checkpointPath(179));  // 30 warm-up + 3 * 50 bars
+
+    Portfolio resumedPortfolio(portfolioConfig());
+    SMACrossover resumedStrategy(10, 30);
+    EngineConfig resumedConfig = quietConfig();
+    resumedConfig.rollingWindows = config.rollingWindows;
+    resumedConfig.quantileSketchK = config.quantileSketchK;
+    BacktestEngine resumed(data, resumedStrategy, resumedPortfolio, resumedConfig);
+    resumed.loadCheckpoint(*path);
+    const EngineStats& stats = resumed.run();
+
+    EXPECT_EQ(stats.bars, engine.getStats().bars);
+    EXPECT_EQ(stats.events, engine.getStats().events);
+
+    const auto& expected = engine.getEquityCurve();
+    const auto& actual = resumed.getEquityCurve();
+    ASSERT_EQ(actual.size(), expected.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        EXPECT_EQ(actual[i].time, expected[i].time);
+        EXPECT_EQ(actual[i].equity, expected[i].equity);
+    }
+    EXPECT_EQ(resumedPortfolio.getAllTrades().size(), portfolio.getAllTrades().size());
+    EXPECT_EQ(resumedPortfolio.getRealizedPnL(), portfolio.getRealizedPnL());
+    EXPECT_EQ(resumedPortfolio.getTradeStats().mae, portfolio.getTradeStats().mae);
+    EXPECT_EQ(resumedPortfolio.getTradeStats().holdingTime, portfolio.getTradeStats().holdingTime);
+    EXPECT_EQ(resumed.getPerformance().sharpeRatio(Frequency::MINUTE),
+              engine.getPerformance().sharpeRatio(Frequency::MINUTE));
+    EXPECT_EQ(resumed.getReturnSketch().quantile(0.1), engine.getReturnSketch().quantile(0.1));
+    EXPECT_EQ(resumed.getTradeSketch().count(), engine.getTradeSketch().count());
+    ASSERT_EQ(resumed.getRollingSeries(0).size(), expected.size());
+    for (size_t i = 40; i < expected.size(); ++i) {
+        EXPECT_EQ(resumed.getRollingSeries(0)[i].sharpe, engine.getRollingSeries(0)[i].sharpe);
+    }
+}
+
+TEST_F(CheckpointTest, SnapshotsStayBoundedAndArePruned) {
+    EngineConfig config = quietConfig();
+    config.checkpointEvery = 10;
+    config.checkpointDir = dir;
+    config.checkpointKeep = 0;
+    config.rollingWindows = {{.bars = 40}};
+
+    Portfolio portfolio(portfolioConfig());
+    SMACrossover strategy(10, 30);
+    BacktestEngine(data, strategy, portfolio, config).run();
+
+    // The logs live in the journal, a snapshot only holds the current state
+    std::vector<uintmax_t> sizes;
+    for (const auto& entry : std::filesystem::directory_iterator(dir)) {
+        if (entry.path().filename() != "checkpoint_journal.bin") {
+            sizes.push_back(entry.file_size());
+        }
+    }
+    ASSERT_GT(sizes.size(), 20u);
+    auto [smallest, largest] = std::minmax_element(sizes.begin(), sizes.end());
+    EXPECT_LE(*largest, *smallest + 2048);  // Peak queue and pending orders vary
+
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directory(dir);
+    config.checkpointKeep = 2;
+    Portfolio keptPortfolio(portfolioConfig());
+    SMACrossover keptStrategy(10, 30);
+    BacktestEngine kept(data, keptStrategy, keptPortfolio, config);
+    kept.run();
+    EXPECT_EQ(std::distance(std::filesystem::directory_iterator(dir),
+                            std::filesystem::directory_iterator()),
+              3);  // Two snapshots and the journal
+
+    // Resuming from the older kept snapshot and snapshotting on rewinds the journal
+    std::string path = BacktestEngine::findCheckpoint(dir, 290).value();
+    EXPECT_EQ(path, kept.checkpointPath(289));
+    Portfolio resumedPortfolio(portfolioConfig());
+    SMACrossover resumedStrategy(10, 30);
+    BacktestEngine resumed(data, resumedStrategy, resumedPortfolio, config);
+    resumed.loadCheckpoint(path);
+    resumed.run();
+    ASSERT_EQ(resumed.getEquityCurve().size(), kept.getEquityCurve().size());
+    EXPECT_EQ(resumed.getEquityCurve().back().equity, kept.getEquityCurve().back().equity);
+    EXPECT_EQ(resumedPortfolio.getAllTrades().size(), keptPortfolio.getAllTrades().size());
+
+    BacktestEngine reloaded(data, strategy, portfolio, config);
+    reloaded.loadCheckpoint(BacktestEngine::findCheckpoint(dir).value());
+    EXPECT_EQ(reloaded.getEquityCurve().size(), 270u);  // Snapshot before the liquidation
+}
+
+TEST_F(CheckpointTest, RejectsCheckpointOfOtherData) {
+    EngineConfig config = quietConfig();
+    config.checkpointEvery = 100;
+    config.checkpointDir = dir;
+
+    Portfolio portfolio(portfolioConfig());
+    SMACrossover strategy(10, 30);
+    BacktestEngine(data, strategy, portfolio, config).run();
+
+    DataHandler doubled;
+    doubled.loadCSV(testFilePath, "NQ");
+    doubled.loadCSV(testFilePath, "NQ");
+
+    Portfolio otherPortfolio(portfolioConfig());
+    SMACrossover otherStrategy(10, 30);
+    BacktestEngine other(doubled, otherStrategy, otherPortfolio, quietConfig());
+    std::string path = BacktestEngine::findCheckpoint(dir).value();
+    EXPECT_THROW(other.loadCheckpoint(path), std::runtime_error);
+}
+
+TEST_F(CheckpointTest, RejectsTruncatedFile) {
+    std::string path = dir + "/checkpoint_1.bin";
+    std::ofstream(path, std::ios::binary) << "BTCK";
+
+    Portfolio portfolio(portfolioConfig());
+    SMACrossover strategy(10, 30);
+    BacktestEngine engine(data, strategy, portfolio, quietConfig());
+    EXPECT_THROW(engine.loadCheckpoint(path), std::runtime_error);
+}
+
+TEST_F(BacktestEngineTest, MultiStrategyTakesAnyPortfolioType) {
+    StrategyAllocation allocation{.portfolio = {.initialCash = 100'000.0, .logTrades = false}};
+    SMACrossover fast(5, 20);
+    SMACrossover slow(10, 30);
+    RuntimeCommission commission(PerContractCommission{1.5});
+    RuntimeSlippage slippage(SpreadSlippage{0.25});
+    BasicMultiStrategyEngine<RuntimePortfolio> multi(data, quietConfig());
+    multi.addStrategy(fast, allocation, commission, slippage);
+    multi.addStrategy(slow, allocation);  // Flat commission from the config
+    multi.run();
+
+    SMACrossover strategy(5, 20);
+    RuntimePortfolio portfolio(allocation.portfolio, commission, slippage);
+    BasicBacktestEngine<Strategy, RuntimePortfolio> engine(data, strategy, portfolio,
+                                                           quietConfig());
+    engine.run();
+
+    ASSERT_GT(portfolio.getAllTrades().size(), 0);
+    EXPECT_EQ(multi.getPortfolio(0).getAllTrades().size(), portfolio.getAllTrades().size());
+    EXPECT_EQ(multi.getEquityCurve(0).back().equity, engine.getEquityCurve().back().equity);
+    EXPECT_GT(multi.getPortfolio(1).getAllTrades().size(), 0);
+}
@@ -0,0 +1,400 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "backtest-cpp/indicator_graph.h"
+#include "backtest-cpp/indicators.h"
+
+namespace {
+
+std::vector<double> randomWalk(size_t count, uint64_t seed = 11) {
+    std::mt19937_64 rng(seed);
+    std::normal_distribution<double> step(0.0, 1.5);
+    std::vector<double> values;
+    double price = 10'000.0;
+    for (size_t i = 0; i < count; ++i) {
+        price += step(rng);
+        values.push_back(price);
+    }
+    return values;
+}
+
+// Naive mean of values[end - period, end)
+double windowMean(const std::vector<double>& values, size_t end, size_t period) {
+    size_t begin = end > period ? end - period : 0;
+    double sum = 0.0;
+    for (size_t i = begin; i < end; ++i) sum += values[i];
+    return sum / static_cast<double>(end - begin);
+}
+
+std::map<std::string, Bar> barsAt(size_t i, const std::vector<double>& a,
+                                  const std::vector<double>& b, bool withB = true) {
+    std::map<std::string, Bar> bars;
+    int64_t time = static_cast<int64_t>(i);
+    bars["A"] = Bar{"A", time, a[i], a[i] + 1.0, a[i] - 1.0, a[i], 100};
+    if (withB) bars["B"] = Bar{"B", time, b[i], b[i] + 1.0, b[i] - 1.0, b[i], 100};
+    return bars;
+}
+
+}  // namespace
+
+// ============================================================================
+// Moving Averages
+// ============================================================================
+
+TEST(IndicatorTest, SMAMatchesNaiveWindow) {
+    std::vector<double> values = randomWalk(500);
+    SMA sma(20);
+    for (size_t i = 0; i < values.size(); ++i) {
+        sma.update(values[i]);
+        EXPECT_NEAR(sma.value(), windowMean(values, i + 1, 20), 1e-9);
+        EXPECT_EQ(sma.ready(), i + 1 >= 20);
+    }
+}
+
+TEST(IndicatorTest, SMADoesNotDriftOverLongRuns) {
+    std::vector<double> values = randomWalk(2'000'000);
+    SMA sma(30);
+    for (double value : values) sma.update(value);
+
+    EXPECT_NEAR(sma.value(), windowMean(values, values.size(), 30), 1e-9);
+}
+
+TEST(IndicatorTest, EMASeedsWithSMA) {
+    EMA ema(3);
+    ema.update(1.0);
+    ema.update(2.0);
+    EXPECT_FALSE(ema.ready());
+    EXPECT_DOUBLE_EQ(ema.update(3.0), 2.0);
+    EXPECT_TRUE(ema.ready());
+
+    // alpha = 0.5
+    EXPECT_DOUBLE_EQ(ema.update(6.0), 4.0);
+}
+
+TEST(IndicatorTest, WMAMatchesNaiveWeights) {
+    std::vector<double> values = randomWalk(200);
+    WMA wma(10);
+    for (size_t i = 0; i < values.size(); ++i) {
+        wma.update(values[i]);
+
+        size_t n = std::min<size_t>(i + 1, 10);
+        double weighted = 0.0;
+        for (size_t k = 0; k < n; ++k) weighted += (n - k) * values[i - k];
+        EXPECT_NEAR(wma.value(), weighted / (n * (n + 1) / 2.0), 1e-8);
+    }
+}
+
+// ============================================================================
+// Dispersion
+// ============================================================================
+
+TEST(IndicatorTest, RollingStdDevMatchesNaive) {
+    std::vector<double> values = randomWalk(1000);
+    RollingStdDev stddev(25);
+    for (size_t i = 0; i < values.size(); ++i) {
+        stddev.update(values[i]);
+
+        size_t begin = i + 1 > 25 ? i + 1 - 25 : 0;
+        double mean = windowMean(values, i + 1, 25);
+        double m2 = 0.0;
+        for (size_t k = begin; k <= i; ++k) m2 += (values[k] - mean) * (values[k] - mean);
+        EXPECT_NEAR(stddev.value(), std::sqrt(m2 / (i + 1 - begin)), 1e-7);
+    }
+}
+
+TEST(IndicatorTest, ZScoreOfConstantSeriesIsZero) {
+    ZScore z(5);
+    for (int i = 0; i < 10; ++i) EXPECT_EQ(z.update(42.0), 0.0);
+
+    // Mean of {42, 42, 42, 42, 52} is 44, population stddev is 4
+    EXPECT_NEAR(z.update(52.0), 2.0, 1e-12);
+}
+
+// ============================================================================
+// Oscillators and Ranges
+// ============================================================================
+
+TEST(IndicatorTest, RSIBounds) {
+    RSI rising(14);
+    for (int i = 0; i < 30; ++i) rising.update(100.0 + i);
+    EXPECT_TRUE(rising.ready());
+    EXPECT_DOUBLE_EQ(rising.value(), 100.0);
+
+    RSI flat(14);
+    for (int i = 0; i < 30; ++i) flat.update(100.0);
+    EXPECT_DOUBLE_EQ(flat.value(), 50.0);
+}
+
+TEST(IndicatorTest, RSIUsesWilderSmoothing) {
+    // Changes: +2, -1, then +1 with period 2
+    RSI rsi(2);
+    rsi.update(10.0);
+    rsi.update(12.0);
+    rsi.update(11.0);
+    EXPECT_NEAR(rsi.value(), 100.0 - 100.0 / (1.0 + 1.0 / 0.5), 1e-12);
+
+    // avgGain = (1 * 1 + 1) / 2 = 1, avgLoss = (0.5 * 1 + 0) / 2 = 0.25
+    rsi.update(12.0);
+    EXPECT_NEAR(rsi.value(), 80.0, 1e-12);
+}
+
+TEST(IndicatorTest, ATRIncludesGaps) {
+    ATR atr(2);
+    atr.update(11.0, 9.0, 10.0);  // TR 2
+
+    // Gap up: TR is 15 - 10 = 5, seed average (2 + 5) / 2
+    EXPECT_DOUBLE_EQ(atr.update(15.0, 14.0, 14.5), 3.5);
+    EXPECT_TRUE(atr.ready());
+
+    // TR 1, Wilder smoothing (3.5 + 1) / 2
+    EXPECT_DOUBLE_EQ(atr.update(15.0, 14.0, 14.5), 2.25);
+}
+
+TEST(IndicatorTest, RollingMinMaxMatchNaive) {
+    std::vector<double> values = randomWalk(1000, 3);
+    RollingMin rollingMin(16);
+    RollingMax rollingMax(16);
+    for (size_t i = 0; i < values.size(); ++i) {
+        rollingMin.update(values[i]);
+        rollingMax.update(values[i]);
+
+        size_t begin = i + 1 > 16 ? i + 1 - 16 : 0;
+        EXPECT_EQ(rollingMin.value(),
+                  *std::min_element(values.begin() + begin, values.begin() + i + 1));
+        EXPECT_EQ(rollingMax.value(),
+                  *std::max_element(values.begin() + begin, values.begin() + i + 1));
+    }
+}
+
+TEST(IndicatorTest, VWAPRollingAndSession) {
+    VWAP rolling(2);
+    rolling.update(10.0, 100.0);
+    rolling.update(20.0, 300.0);
+    EXPECT_DOUBLE_EQ(rolling.value(), 17.5);
+    EXPECT_DOUBLE_EQ(rolling.update(30.0, 100.0), 22.5);  // First bar left the window
+
+    VWAP session;
+    session.update(10.0, 100.0);
+    session.update(20.0, 100.0);
+    EXPECT_DOUBLE_EQ(session.update(30.0, 200.0), 22.5);
+    session.reset();
+    EXPECT_DOUBLE_EQ(session.update(40.0, 0.0), 40.0);  // No volume yet: last price
+}
+
+// ============================================================================
+// Per-Symbol Banks
+// ============================================================================
+
+TEST(IndicatorTest, SMABankMatchesPerSymbolSMA) {
+    const size_t numSymbols = 37;  // Not a multiple of any vector width
+    std::vector<std::vector<double>> series;
+    for (size_t s = 0; s < numSymbols; ++s) series.push_back(randomWalk(200, s + 1));
+
+    SMABank bank(15, numSymbols);
+    std::vector<SMA> single(numSymbols, SMA(15));
+    std::vector<double> row(numSymbols);
+    for (size_t i = 0; i < 200; ++i) {
+        for (size_t s = 0; s < numSymbols; ++s) row[s] = series[s][i];
+        bank.updateAll(row);
+        for (size_t s = 0; s < numSymbols; ++s) {
+            EXPECT_EQ(bank.value(s), single[s].update(row[s]));
+            EXPECT_EQ(bank.ready(s), single[s].ready());
+        }
+    }
+}
+
+TEST(IndicatorTest, SMABankSymbolAddedLateStartsEmpty) {
+    std::vector<double> values = randomWalk(100);
+    SMABank bank(10, 1);
+    SMA first(10);
+    SMA late(10);
+    for (size_t i = 0; i < 100; ++i) {
+        if (i == 33) bank.resize(2);
+        std::vector<double> row = {values[i], values[i] * 2.0};
+        bank.updateAll(std::span<const double>(row.data(), bank.numSymbols()));
+        EXPECT_EQ(bank.value(0), first.update(values[i]));
+        if (i >= 33) {
+            EXPECT_EQ(bank.value(1), late.update(values[i] * 2.0));
+            EXPECT_EQ(bank.ready(1), late.ready());
+        }
+    }
+}
+
+TEST(IndicatorTest, SMABankSavedStateContinuesIdentically) {
+    std::vector<double> a = randomWalk(120, 3);
+    std::vector<double> b = randomWalk(120, 4);
+    SMABank original(12, 2);
+    for (size_t i = 0; i < 60; ++i) original.updateAll(std::vector<double>{a[i], b[i]});
+
+    BinaryWriter writer;
+    original.saveState(writer);
+    SMABank restored(12);
+    BinaryReader reader(writer.data());
+    restored.loadState(reader);
+
+    ASSERT_EQ(restored.numSymbols(), 2);
+    for (size_t i = 60; i < a.size(); ++i) {
+        std::vector<double> row = {a[i], b[i]};
+        original.updateAll(row);
+        restored.updateAll(row);
+        EXPECT_EQ(restored.value(0), original.value(0));
+        EXPECT_EQ(restored.value(1), original.value(1));
+    }
+}
+
+// ============================================================================
+// Construction and State
+// ============================================================================
+
+TEST(IndicatorTest, ZeroPeriodThrows) {
+    EXPECT_THROW(SMA(0), std::invalid_argument);
+    EXPECT_THROW(RollingMax(0), std::invalid_argument);
+}
+
+TEST(IndicatorTest, SavedStateContinuesIdentically) {
+    std::vector<double> values = randomWalk(300);
+    SMA original(20);
+    RollingMax originalMax(20);
+    for (size_t i = 0; i < 150; ++i) {
+        original.update(values[i]);
+        originalMax.update(values[i]);
+    }
+
+    BinaryWriter writer;
+    original.saveState(writer);
+    originalMax.saveState(writer);
+    SMA restored(20);
+    RollingMax restoredMax(20);
+    BinaryReader reader(writer.data());
+    restored.loadState(reader);
+    restoredMax.loadState(reader);
+
+    for (size_t i = 150; i < values.size(); ++i) {
+        EXPECT_EQ(restored.update(values[i]), original.update(values[i]));
+        EXPECT_EQ(restoredMax.update(values[i]), originalMax.update(values[i]));
+    }
+}
+
+// ============================================================================
+// Indicator Graph
+// ============================================================================
+
+TEST(IndicatorGraphTest, IdenticalRequestsShareANode) {
+    IndicatorGraph graph;
+    IndicatorHandle first = graph.sma(30);
+    IndicatorHandle second = graph.sma(30);
+    IndicatorHandle other = graph.sma(30, PriceField::OPEN);
+    IndicatorHandle smoothed = graph.add(IndicatorKind::EMA, 5, first);
+
+    EXPECT_EQ(first, second);
+    EXPECT_NE(first, other);
+    EXPECT_EQ(graph.add(IndicatorKind::EMA, 5, second), smoothed);
+    EXPECT_EQ(graph.numNodes(), 5);  // Close, open, two SMAs and the EMA
+}
+
+TEST(IndicatorGraphTest, MatchesStandaloneIndicators) {
+    std::vector<double> a = randomWalk(200, 5);
+    std::vector<double> b = randomWalk(200, 6);
+    IndicatorGraph graph;
+    IndicatorHandle sma = graph.sma(10);
+    IndicatorHandle emaOfSma = graph.add(IndicatorKind::EMA, 4, sma);
+    IndicatorHandle rsi = graph.add(IndicatorKind::RSI, 14, graph.price(PriceField::CLOSE));
+    IndicatorHandle high = graph.add(IndicatorKind::MAX, 7, graph.price(PriceField::HIGH));
+
+    // B skips every fifth bar and is carried forward at its last close
+    std::vector<SMA> smas(2, SMA(10));
+    std::vector<EMA> emas(2, EMA(4));
+    std::vector<RSI> rsis(2, RSI(14));
+    std::vector<RollingMax> highs(2, RollingMax(7));
+    double lastB = b[0];
+    for (size_t i = 0; i < a.size(); ++i) {
+        bool withB = i % 5 != 3;
+        graph.update(barsAt(i, a, b, withB));
+        if (withB) lastB = b[i];
+
+        double closes[2] = {a[i], lastB};
+        for (uint32_t s = 0; s < 2; ++s) {
+            uint32_t id = graph.symbols().find(s == 0 ? "A" : "B").value();
+            EXPECT_EQ(graph.previous(emaOfSma, id), emas[s].value());
+            EXPECT_EQ(graph.value(sma, id), smas[s].update(closes[s]));
+            EXPECT_EQ(graph.value(emaOfSma, id), emas[s].update(smas[s].value()));
+            EXPECT_EQ(graph.value(rsi, id), rsis[s].update(closes[s]));
+            EXPECT_EQ(graph.value(high, id), highs[s].update(closes[s] + 1.0));
+            EXPECT_EQ(graph.ready(sma, id), smas[s].ready());
+        }
+    }
+}
+
+TEST(IndicatorGraphTest, PreviousHoldsTheBarBefore) {
+    std::vector<double> a = randomWalk(50, 7);
+    IndicatorGraph graph;
+    IndicatorHandle sma = graph.sma(5);
+    double before = 0.0;
+    for (size_t i = 0; i < a.size(); ++i) {
+        graph.update(barsAt(i, a, a, false));
+        EXPECT_EQ(graph.previous(sma, 0), before);
+        before = graph.value(sma, 0);
+    }
+}
+
+TEST(IndicatorGraphTest, SymbolAddedLateStartsEmpty) {
+    std::vector<double> a = randomWalk(60, 8);
+    std::vector<double> b = randomWalk(60, 9);
+    IndicatorGraph graph;
+    IndicatorHandle sma = graph.sma(10);
+    SMA first(10);
+    SMA late(10);
+    for (size_t i = 0; i < a.size(); ++i) {
+        graph.update(barsAt(i, a, b, i >= 25));
+        EXPECT_EQ(graph.value(sma, 0), first.update(a[i]));
+        if (i >= 25) {
+            ASSERT_EQ(graph.numSymbols(), 2);
+            EXPECT_EQ(graph.value(sma, 1), late.update(b[i]));
+            EXPECT_EQ(graph.ready(sma, 1), late.ready());
+            EXPECT_EQ(graph.barSymbols()[1], 1);
+        }
+    }
+}
+
+TEST(IndicatorGraphTest, SavedStateContinuesIdentically) {
+    std::vector<double> a = randomWalk(120, 10);
+    std::vector<double> b = randomWalk(120, 11);
+    IndicatorGraph original;
+    IndicatorHandle sma = original.sma(12);
+    IndicatorHandle stddev = original.add(IndicatorKind::STDDEV, 8, sma);
+    for (size_t i = 0; i < 60; ++i) original.update(barsAt(i, a, b));
+
+    BinaryWriter writer;
+    original.saveState(writer);
+    IndicatorGraph restored;
+    BinaryReader reader(writer.data());
+    restored.loadState(reader);
+
+    // Declaring the same indicators again finds the restored nodes
+    EXPECT_EQ(restored.sma(12), sma);
+    EXPECT_EQ(restored.add(IndicatorKind::STDDEV, 8, sma), stddev);
+    ASSERT_EQ(restored.numNodes(), original.numNodes());
+    for (size_t i = 60; i < a.size(); ++i) {
+        original.update(barsAt(i, a, b));
+        restored.update(barsAt(i, a, b));
+        for (uint32_t s = 0; s < 2; ++s) {
+            EXPECT_EQ(restored.value(sma, s), original.value(sma, s));
+            EXPECT_EQ(restored.value(stddev, s), original.value(stddev, s));
+        }
+    }
+}
+
+TEST(IndicatorGraphTest, RejectsInvalidRequests) {
+    IndicatorGraph graph;
+    IndicatorHandle close = graph.price(PriceField::CLOSE);
+    EXPECT_THROW(graph.add(IndicatorKind::SMA, 0, close), std::invalid_argument);
+    EXPECT_THROW(graph.add(IndicatorKind::PRICE, 1, close), std::invalid_argument);
+    EXPECT_THROW(graph.add(IndicatorKind::SMA, 5, IndicatorHandle()), std::invalid_argument);
+    EXPECT_EQ(graph.numNodes(), 1);
+}
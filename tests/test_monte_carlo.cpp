@@ -0,0 +1,144 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <set>
+#include <vector>
+
+#include "backtest-cpp/monte_carlo.h"
+#include "backtest-cpp/performance.h"
+#include "backtest-cpp/random.h"
+
+// ============================================================================
+// Philox Tests
+// ============================================================================
+
+TEST(PhiloxTest, MatchesReferenceVectors) {
+    // Known-answer vectors of the Random123 reference implementation
+    EXPECT_EQ(Philox::block({0, 0, 0, 0}, {0, 0}),
+              (Philox::Block{0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8}));
+    EXPECT_EQ(Philox::block({0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff},
+                            {0xffffffff, 0xffffffff}),
+              (Philox::Block{0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd}));
+    EXPECT_EQ(Philox::block({0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344},
+                            {0xa4093822, 0x299f31d0}),
+              (Philox::Block{0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1}));
+}
+
+TEST(PhiloxTest, StreamsAreReproducibleAndDistinct) {
+    Philox a(7, 3);
+    Philox b(7, 3);
+    Philox other(7, 4);
+    std::set<uint64_t> seen;
+    for (int i = 0; i < 1'000; ++i) {
+        uint64_t value = a.next();
+        EXPECT_EQ(value, b.next());
+        seen.insert(value);
+        seen.insert(other.next());
+    }
+    EXPECT_EQ(seen.size(), 2'000);
+
+    for (int i = 0; i < 1'000; ++i) {
+        EXPECT_LT(a.below(10), 10);
+        double u = a.uniform();
+        EXPECT_GE(u, 0.0);
+        EXPECT_LT(u, 1.0);
+    }
+}
+
+// ============================================================================
+// Monte Carlo Tests
+// ============================================================================
+
+class MonteCarloTest : public ::testing::Test {
+   protected:
+    MonteCarloConfig config{.samples = 2'000, .threads = 2};
+    std::vector<Trade> trades;
+    std::vector<EquityPoint> curve;
+
+    void SetUp() override {
+        double pnls[] = {120.0, -80.0, 45.5, -30.0, 210.0, -150.0, 60.0, 15.0, -95.0, 140.0};
+        for (double pnl : pnls) {
+            trades.push_back(Trade{.order = {}, .quantity = 2, .pnl = pnl, .commission = 2.7});
+        }
+        double equity = 100'000.0;
+        for (int i = 0; i < 500; ++i) {
+            equity *= 1.0 + 0.0004 * std::sin(i / 7.0) + 0.0001;
+            curve.push_back({1'600'000'000 + i * 60, equity});
+        }
+    }
+};
+
+TEST_F(MonteCarloTest, ShuffledTradesKeepFinalEquity) {
+    MonteCarloResult result = MonteCarlo(config).shuffleTrades(trades, 100'000.0, 499);
+
+    ASSERT_EQ(result.samples.size(), 2'000);
+    for (const SampleStats& sample : result.samples) {
+        EXPECT_NEAR(sample.finalEquity, 100'235.5, 1e-9);
+    }
+    // Only the path changes, so drawdown varies around the original order's
+    EXPECT_LT(result.maxDrawdown.lower, result.maxDrawdown.upper);
+    EXPECT_LE(result.maxDrawdown.lower, result.maxDrawdown.median);
+    EXPECT_LE(result.maxDrawdown.median, result.maxDrawdown.upper);
+}
+
+TEST_F(MonteCarloTest, ResultsDoNotDependOnThreadCount) {
+    config.threads = 1;
+    MonteCarloResult serial = MonteCarlo(config).bootstrapTrades(trades, 100'000.0, 499);
+    config.threads = 4;
+    MonteCarloResult parallel = MonteCarlo(config).bootstrapTrades(trades, 100'000.0, 499);
+
+    ASSERT_EQ(parallel.samples.size(), serial.samples.size());
+    for (size_t i = 0; i < serial.samples.size(); ++i) {
+        EXPECT_EQ(parallel.samples[i].finalEquity, serial.samples[i].finalEquity);
+        EXPECT_EQ(parallel.samples[i].sharpe, serial.samples[i].sharpe);
+    }
+    EXPECT_EQ(parallel.finalEquity.lower, serial.finalEquity.lower);
+    EXPECT_EQ(parallel.sharpe.upper, serial.sharpe.upper);
+}
+
+TEST_F(MonteCarloTest, JitteredFillsOnlyCost) {
+    MonteCarloResult jittered = MonteCarlo(config).jitterFills(trades, 100'000.0, 499);
+    for (const SampleStats& sample : jittered.samples) {
+        EXPECT_LE(sample.finalEquity, 100'235.5);
+        // Two fills per trade, at most one tick of 0.25 each, on 2 contracts
+        EXPECT_GE(sample.finalEquity, 100'235.5 - 10 * 2 * 2 * 0.25);
+    }
+
+    config.slippageTicks = 0.0;
+    MonteCarloResult exact = MonteCarlo(config).jitterFills(trades, 100'000.0, 499);
+    EXPECT_DOUBLE_EQ(exact.finalEquity.lower, exact.finalEquity.upper);
+}
+
+TEST_F(MonteCarloTest, RerunMatchesPerformance) {
+    config.samples = 16;
+    MonteCarloResult result = MonteCarlo(config).rerun([this](Philox&) { return curve; });
+
+    for (const SampleStats& sample : result.samples) {
+        EXPECT_EQ(sample.sharpe, Performance::sharpeRatio(curve, Frequency::MINUTE));
+        EXPECT_EQ(sample.maxDrawdown, Performance::maxDrawdown(curve));
+        EXPECT_EQ(sample.finalEquity, curve.back().equity);
+    }
+    EXPECT_EQ(result.sharpe.lower, result.sharpe.upper);
+}
+
+TEST_F(MonteCarloTest, BlockBootstrapOfWholeCurveRotatesIt) {
+    // One block spanning every return is a rotation: same returns, same final equity
+    config.blockLength = curve.size();
+    MonteCarloResult result = MonteCarlo(config).blockBootstrap(curve);
+    for (const SampleStats& sample : result.samples) {
+        EXPECT_NEAR(sample.finalEquity, curve.back().equity, 1e-6);
+    }
+
+    config.blockLength = 10;
+    MonteCarloResult blocks = MonteCarlo(config).blockBootstrap(curve);
+    EXPECT_LT(blocks.finalEquity.lower, blocks.finalEquity.upper);
+    EXPECT_LT(blocks.sharpe.lower, blocks.sharpe.upper);
+}
+
+TEST_F(MonteCarloTest, RejectsUnusableInput) {
+    EXPECT_THROW(MonteCarlo({.confidence = 1.0}), std::invalid_argument);
+    EXPECT_THROW(MonteCarlo(config).shuffleTrades({}, 100'000.0, 499), std::invalid_argument);
+    EXPECT_THROW(MonteCarlo(config).bootstrapTrades(trades, 100'000.0, 0), std::invalid_argument);
+    curve[3].equity = -1.0;
+    EXPECT_THROW(MonteCarlo(config).blockBootstrap(curve), std::invalid_argument);
+}
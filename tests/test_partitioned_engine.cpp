@@ -0,0 +1,170 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../strategies/smacrossover.h"
+#include "backtest-cpp/data.h"
+#include "backtest-cpp/engine.h"
+#include "backtest-cpp/partitioned_engine.h"
+#include "backtest-cpp/portfolio.h"
+#include "test_util.h"
+
+class PartitionedEngineTest : public ::testing::Test {
+   protected:
+    DataHandler data;
+    std::vector<std::string> files = {"test_partitioned_nq.csv", "test_partitioned_es.csv",
+                                      "test_partitioned_ym.csv"};
+
+    // Three symbols on the tick grid with different phases; ES starts 20 bars late
+    void SetUp() override {
+        const char* symbols[] = {"NQ", "ES", "YM"};
+        for (size_t s = 0; s < files.size(); ++s) {
+            writeSineCsv(files[s], 400, s, s == 1 ? 20 : 0);
+            data.loadCSV(files[s], symbols[s]);
+        }
+        data.synchronize();
+    }
+
+    void TearDown() override {
+        for (const std::string& file : files) std::remove(file.c_str());
+    }
+
+    PartitionConfig config(size_t partitions, size_t threads) {
+        return {.portfolio = {.initialCash = 300'000.0, .commission = 2.7},
+                .engine = {.warmupBars = 30, .maxInvest = 10'000},
+                .partitions = partitions,
+                .threads = threads};
+    }
+
+    static StrategyFactory smaCrossover() {
+        return [] { return std::make_unique<SMACrossover>(10, 30); };
+    }
+};
+
+TEST_F(PartitionedEngineTest, SplitsSortedSymbolsAndCapital) {
+    PartitionedEngine engine(data, smaCrossover(), config(2, 1));
+    ASSERT_EQ(engine.size(), 2);
+    EXPECT_EQ(engine.getSymbols(0), std::vector<std::string>{"ES"});
+    EXPECT_EQ(engine.getSymbols(1), (std::vector<std::string>{"NQ", "YM"}));
+
+    engine.run();
+    EXPECT_DOUBLE_EQ(engine.getEquityCurve(0).front().equity, 100'000.0);
+    EXPECT_DOUBLE_EQ(engine.getEquityCurve(1).front().equity, 200'000.0);
+}
+
+TEST_F(PartitionedEngineTest, OnePartitionMatchesBacktestEngine) {
+    PartitionConfig partitioned = config(1, 2);
+    PartitionedEngine engine(data, smaCrossover(), partitioned);
+    engine.run();
+
+    SMACrossover strategy(10, 30);
+    Portfolio portfolio({.initialCash = 300'000.0, .commission = 2.7, .logTrades = false});
+    BacktestEngine reference(data, strategy, portfolio,
+                             {.warmupBars = 30, .maxInvest = 10'000, .logOrders = false});
+    reference.run();
+
+    ASSERT_GT(portfolio.getAllTrades().size(), 0);
+    EXPECT_EQ(engine.getTradeCount(), portfolio.getAllTrades().size());
+    EXPECT_EQ(engine.getRealizedPnL(), portfolio.getRealizedPnL());
+    EXPECT_EQ(engine.getStats().engine.eventsByType, reference.getStats().eventsByType);
+
+    const std::vector<EquityPoint>& curve = engine.getAggregateEquityCurve();
+    ASSERT_EQ(curve.size(), reference.getEquityCurve().size());
+    for (size_t i = 0; i < curve.size(); ++i) {
+        EXPECT_EQ(curve[i].time, reference.getEquityCurve()[i].time);
+        EXPECT_EQ(curve[i].equity, reference.getEquityCurve()[i].equity);
+    }
+}
+
+TEST_F(PartitionedEngineTest, RunsOnAnyPortfolioType) {
+    RuntimeCommission commission(PercentageCommission{0.0001});
+    RuntimeSlippage slippage(SpreadSlippage{0.25});
+    BasicPartitionedEngine<RuntimePortfolio> engine(data, smaCrossover(), config(1, 2),
+                                                    commission, slippage);
+    engine.run();
+
+    SMACrossover strategy(10, 30);
+    RuntimePortfolio portfolio({.initialCash = 300'000.0, .logTrades = false}, commission,
+                               slippage);
+    BasicBacktestEngine<Strategy, RuntimePortfolio> reference(
+        data, strategy, portfolio, {.warmupBars = 30, .maxInvest = 10'000, .logOrders = false});
+    reference.run();
+
+    ASSERT_GT(portfolio.getAllTrades().size(), 0);
+    EXPECT_EQ(engine.getTradeCount(), portfolio.getAllTrades().size());
+    EXPECT_EQ(engine.getRealizedPnL(), portfolio.getRealizedPnL());
+    EXPECT_EQ(engine.getAggregateEquityCurve().back().equity,
+              reference.getEquityCurve().back().equity);
+}
+
+TEST_F(PartitionedEngineTest, SymbolPartitionsAreStandaloneSubAccounts) {
+    PartitionedEngine engine(data, smaCrossover(), config(0, 2));
+    engine.run();
+    ASSERT_EQ(engine.size(), 3);
+
+    // ES loaded on its own, with its third of the capital
+    DataHandler esOnly;
+    esOnly.loadCSV(files[1], "ES");
+    SMACrossover strategy(10, 30);
+    Portfolio portfolio({.initialCash = 100'000.0, .commission = 2.7, .logTrades = false});
+    BacktestEngine reference(esOnly, strategy, portfolio,
+                             {.warmupBars = 30, .maxInvest = 10'000, .logOrders = false});
+    reference.run();
+
+    const std::vector<EquityPoint>& es = engine.getEquityCurve(0);
+    ASSERT_EQ(es.size(), reference.getEquityCurve().size());
+    for (size_t i = 0; i < es.size(); ++i) {
+        EXPECT_EQ(es[i].equity, reference.getEquityCurve()[i].equity);
+    }
+    EXPECT_EQ(engine.getPortfolio(0).getRealizedPnL(), portfolio.getRealizedPnL());
+
+    // The late-starting ES partition holds its cash until its own curve begins
+    const std::vector<EquityPoint>& aggregate = engine.getAggregateEquityCurve();
+    ASSERT_EQ(aggregate.size(), es.size() + 20);
+    EXPECT_DOUBLE_EQ(aggregate.front().equity,
+                     100'000.0 + engine.getEquityCurve(1).front().equity +
+                         engine.getEquityCurve(2).front().equity);
+    EXPECT_DOUBLE_EQ(aggregate.back().equity, engine.getEquityCurve(0).back().equity +
+                                                  engine.getEquityCurve(1).back().equity +
+                                                  engine.getEquityCurve(2).back().equity);
+}
+
+TEST_F(PartitionedEngineTest, ResultsDoNotDependOnThreadCount) {
+    PartitionedEngine single(data, smaCrossover(), config(0, 1));
+    PartitionedEngine parallel(data, smaCrossover(), config(0, 3));
+    single.run();
+    const PartitionStats& stats = parallel.run();
+
+    EXPECT_EQ(stats.threads, 3);
+    EXPECT_EQ(stats.partitions, 3);
+    EXPECT_EQ(stats.engine.bars, single.getStats().engine.bars);
+    EXPECT_GT(stats.efficiency(), 0.0);
+    EXPECT_EQ(parallel.getRealizedPnL(), single.getRealizedPnL());
+
+    ASSERT_EQ(parallel.getAggregateEquityCurve().size(), single.getAggregateEquityCurve().size());
+    for (size_t i = 0; i < single.getAggregateEquityCurve().size(); ++i) {
+        EXPECT_EQ(parallel.getAggregateEquityCurve()[i].equity,
+                  single.getAggregateEquityCurve()[i].equity);
+    }
+}
+
+TEST_F(PartitionedEngineTest, MergesTradeSketchesOfEveryPartition) {
+    PartitionConfig sketched = config(0, 2);
+    sketched.engine.quantileSketchK = 8;
+    PartitionedEngine engine(data, smaCrossover(), sketched);
+    engine.run();
+
+    const QuantileSketch& trades = engine.getTradeSketch();
+    ASSERT_GT(engine.getTradeCount(), 0);
+    EXPECT_EQ(trades.count(), engine.getTradeCount());
+    double worst = 0.0;
+    for (size_t p = 0; p < engine.size(); ++p) {
+        for (const Trade& trade : engine.getPortfolio(p).getTrades()) {
+            worst = std::min(worst, trade.pnl);
+        }
+    }
+    EXPECT_EQ(trades.min(), worst);
+}
@@ -1,7 +1,9 @@
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <cmath>
 #include <cstdint>
+#include <random>
 #include <vector>
 
 #include "backtest-cpp/performance.h"
@@ -85,4 +87,321 @@ TEST(PerformanceTest, FrequencyMinuteCurve) {
     EXPECT_GT(annRet, 0);
     EXPECT_GT(vol, 0);
     EXPECT_GT(sr, 0);
-}
\ No newline at end of file
+}
+// -----------------------------
+// Drawdown Tests
+// -----------------------------
+TEST(PerformanceTest, MaxDrawdownFromRunningPeak) {
+    auto curve = makeCurve({100, 120, 90, 110, 130, 117});
+    EXPECT_DOUBLE_EQ(Performance::maxDrawdown(curve), 0.25);  // 120 -> 90
+    EXPECT_EQ(Performance::maxDrawdown(makeCurve({100, 101, 102})), 0.0);
+    EXPECT_THROW(Performance::maxDrawdown({}), std::runtime_error);
+}
+
+// -----------------------------
+// Accumulator Tests
+// -----------------------------
+PerformanceAccumulator accumulate(const std::vector<EquityPoint>& curve) {
+    PerformanceAccumulator acc;
+    for (const EquityPoint& point : curve) acc.add(point);
+    return acc;
+}
+
+TEST(PerformanceAccumulatorTest, MatchesBatchFunctions) {
+    std::vector<std::vector<double>> curves = {
+        {100, 101, 102.01}, {100, 102, 101, 103}, {100, 101, 100, 103}, {100, 100, 100, 100},
+        {100, 101, 102, 103, 104}, {100, 120, 90, 110, 130, 117}};
+    for (const std::vector<double>& equities : curves) {
+        auto curve = makeCurve(equities);
+        PerformanceAccumulator acc = accumulate(curve);
+        for (Frequency freq : {Frequency::DAILY, Frequency::HOURLY}) {
+            double vol = Performance::annualizedVolatility(curve, freq);
+            double sharpe = Performance::sharpeRatio(curve, freq, 0.01);
+            EXPECT_EQ(acc.annualizedReturn(freq), Performance::annualizedReturn(curve, freq));
+            EXPECT_NEAR(acc.annualizedVolatility(freq), vol, 1e-12 * vol + 1e-15);
+            EXPECT_NEAR(acc.sharpeRatio(freq, 0.01), sharpe, 1e-12 * std::abs(sharpe));
+        }
+        EXPECT_EQ(acc.maxDrawdown(), Performance::maxDrawdown(curve));
+        EXPECT_EQ(acc.size(), curve.size());
+        EXPECT_EQ(acc.lastEquity(), equities.back());
+    }
+}
+
+TEST(PerformanceAccumulatorTest, ReadableAtAnyPointOfALongRun) {
+    std::mt19937_64 rng(42);
+    std::normal_distribution<double> step(0.0, 0.001);
+    std::vector<EquityPoint> curve;
+    PerformanceAccumulator acc;
+    double equity = 100'000.0;
+    for (int i = 0; i < 100'000; ++i) {
+        equity *= std::exp(step(rng));
+        curve.push_back({i * 60, equity});
+        acc.add(curve.back());
+        if (curve.size() % 25'000 == 0) {
+            double vol = Performance::annualizedVolatility(curve, Frequency::MINUTE);
+            EXPECT_NEAR(acc.annualizedVolatility(Frequency::MINUTE), vol, 1e-9 * vol);
+        }
+    }
+}
+
+TEST(PerformanceAccumulatorTest, ShortCurvesThrowLikeBatch) {
+    PerformanceAccumulator acc;
+    EXPECT_THROW(acc.maxDrawdown(), std::runtime_error);
+    acc.add(100.0);
+    EXPECT_THROW(acc.annualizedReturn(Frequency::DAILY), std::runtime_error);
+    acc.add(101.0);
+    EXPECT_NO_THROW(acc.annualizedReturn(Frequency::DAILY));
+    EXPECT_THROW(acc.annualizedVolatility(Frequency::DAILY), std::runtime_error);
+}
+
+// -----------------------------
+// Risk Metrics Tests
+// -----------------------------
+TEST(RiskMetricsTest, DrawdownShapeOfAKnownCurve) {
+    auto curve = makeCurve({100, 120, 90, 110, 130, 117});
+    RiskMetrics metrics = Performance::riskMetrics(curve, Frequency::DAILY);
+
+    EXPECT_DOUBLE_EQ(metrics.maxDrawdown, 0.25);
+    EXPECT_EQ(metrics.maxDrawdownDuration, 2);  // 90 and 110 below the peak of 120
+    // Drawdowns 0, 0, 0.25, 1/12, 0, 0.1 over 6 points
+    EXPECT_DOUBLE_EQ(metrics.ulcerIndex,
+                     std::sqrt((0.25 * 0.25 + 1.0 / 144 + 0.01) / 6));
+    EXPECT_DOUBLE_EQ(metrics.hitRate, 0.6);  // 3 of 5 periods up
+    EXPECT_DOUBLE_EQ(metrics.calmar, metrics.annualizedReturn / 0.25);
+}
+
+TEST(RiskMetricsTest, MatchesOnePassPerMetric) {
+    std::mt19937_64 rng(7);
+    std::normal_distribution<double> step(0.0002, 0.004);
+    std::vector<double> equities = {100'000.0};
+    for (int i = 0; i < 5'000; ++i) equities.push_back(equities.back() * std::exp(step(rng)));
+    auto curve = makeCurve(equities);
+    RiskMetrics metrics = Performance::riskMetrics(curve, Frequency::DAILY, 0.02);
+
+    std::vector<double> returns;
+    for (size_t i = 1; i < curve.size(); ++i) {
+        returns.push_back(std::log(curve[i].equity / curve[i - 1].equity));
+    }
+    double n = static_cast<double>(returns.size());
+    double mean = 0.0;
+    for (double r : returns) mean += r / n;
+    double m2 = 0.0, m3 = 0.0, m4 = 0.0, downside = 0.0, gains = 0.0;
+    for (double r : returns) {
+        double d = r - mean;
+        m2 += d * d;
+        m3 += d * d * d;
+        m4 += d * d * d * d;
+        downside += std::min(r, 0.0) * std::min(r, 0.0);
+        gains += r > 0.0;
+    }
+    double annReturn = Performance::annualizedReturn(curve, Frequency::DAILY);
+    double maxDrawdown = Performance::maxDrawdown(curve);
+
+    EXPECT_EQ(metrics.annualizedReturn, annReturn);
+    EXPECT_NEAR(metrics.annualizedVolatility,
+                Performance::annualizedVolatility(curve, Frequency::DAILY), 1e-12);
+    EXPECT_NEAR(metrics.sharpe, Performance::sharpeRatio(curve, Frequency::DAILY, 0.02), 1e-9);
+    EXPECT_NEAR(metrics.sortino, (annReturn - 0.02) / std::sqrt(downside / n * 252), 1e-9);
+    EXPECT_EQ(metrics.maxDrawdown, maxDrawdown);
+    EXPECT_NEAR(metrics.calmar, annReturn / maxDrawdown, 1e-9);
+    EXPECT_NEAR(metrics.skewness, std::sqrt(n) * m3 / std::pow(m2, 1.5), 1e-9);
+    EXPECT_NEAR(metrics.excessKurtosis, n * m4 / (m2 * m2) - 3.0, 1e-9);
+    EXPECT_DOUBLE_EQ(metrics.hitRate, gains / n);
+}
+
+TEST(RiskMetricsTest, FlatCurveHasNoRatios) {
+    RiskMetrics metrics = Performance::riskMetrics(makeCurve({100, 100, 100}), Frequency::DAILY);
+    EXPECT_EQ(metrics.sharpe, 0.0);
+    EXPECT_EQ(metrics.sortino, 0.0);
+    EXPECT_EQ(metrics.calmar, 0.0);
+    EXPECT_EQ(metrics.skewness, 0.0);
+    EXPECT_EQ(metrics.hitRate, 0.0);
+    EXPECT_THROW(Performance::riskMetrics(makeCurve({100, 101}), Frequency::DAILY),
+                 std::runtime_error);
+}
+
+TEST(RiskMetricsTest, StreamingMatchesBatchAtEveryPoint) {
+    auto curve = makeCurve({100, 103, 99, 97, 104, 108, 101, 110});
+    PerformanceAccumulator acc;
+    for (size_t i = 0; i < curve.size(); ++i) {
+        acc.add(curve[i]);
+        if (i < 2) continue;
+        std::vector<EquityPoint> prefix(curve.begin(), curve.begin() + i + 1);
+        RiskMetrics batch = Performance::riskMetrics(prefix, Frequency::HOURLY);
+        RiskMetrics streaming = acc.riskMetrics(Frequency::HOURLY);
+        // Accumulated differently (Welford vs shifted power sums), so equal to rounding
+        EXPECT_NEAR(streaming.sortino, batch.sortino, 1e-12 * std::abs(batch.sortino));
+        EXPECT_NEAR(streaming.skewness, batch.skewness, 1e-9);
+        EXPECT_NEAR(streaming.excessKurtosis, batch.excessKurtosis, 1e-9);
+        EXPECT_EQ(streaming.maxDrawdown, batch.maxDrawdown);
+        EXPECT_EQ(streaming.maxDrawdownDuration, batch.maxDrawdownDuration);
+        EXPECT_EQ(streaming.ulcerIndex, batch.ulcerIndex);
+    }
+}
+
+// -----------------------------
+// Rolling Window Tests
+// -----------------------------
+TEST(RollingPerformanceTest, MatchesPerformanceOnEverySlice) {
+    std::mt19937_64 rng(11);
+    std::normal_distribution<double> step(0.0001, 0.003);
+    std::vector<double> equities = {100'000.0};
+    for (int i = 0; i < 400; ++i) equities.push_back(equities.back() * std::exp(step(rng)));
+    auto curve = makeCurve(equities);
+
+    const size_t window = 50;
+    RollingPerformance rolling({.bars = window, .frequency = Frequency::HOURLY});
+    for (size_t i = 0; i < curve.size(); ++i) {
+        rolling.add(curve[i].equity);
+        if (i < window) {
+            EXPECT_FALSE(rolling.ready());
+            EXPECT_TRUE(std::isnan(rolling.sharpeRatio()));
+            continue;
+        }
+        std::vector<EquityPoint> slice(curve.begin() + i - window, curve.begin() + i + 1);
+        double vol = Performance::annualizedVolatility(slice, Frequency::HOURLY);
+        double sharpe = Performance::sharpeRatio(slice, Frequency::HOURLY);
+        EXPECT_EQ(rolling.annualizedReturn(),
+                  Performance::annualizedReturn(slice, Frequency::HOURLY));
+        EXPECT_NEAR(rolling.annualizedVolatility(), vol, 1e-10 * vol);
+        EXPECT_NEAR(rolling.sharpeRatio(), sharpe, 1e-9 * std::abs(sharpe) + 1e-12);
+
+        double peak = 0.0;
+        for (const EquityPoint& point : slice) peak = std::max(peak, point.equity);
+        EXPECT_EQ(rolling.drawdown(), (peak - slice.back().equity) / peak);
+    }
+}
+
+TEST(RollingPerformanceTest, NoDriftOverALongRun) {
+    std::mt19937_64 rng(3);
+    std::normal_distribution<double> step(0.0, 0.002);
+    RollingPerformance rolling({.bars = 100});
+    std::vector<double> last;
+    double equity = 100'000.0;
+    for (int i = 0; i < 200'000; ++i) {
+        // A regime break halfway: ten times the volatility, then back
+        equity *= std::exp(step(rng) * (i > 100'000 && i < 101'000 ? 10.0 : 1.0));
+        rolling.add(equity);
+        last.push_back(equity);
+    }
+    std::vector<EquityPoint> slice = makeCurve({last.end() - 101, last.end()});
+    double vol = Performance::annualizedVolatility(slice, Frequency::MINUTE);
+    EXPECT_NEAR(rolling.annualizedVolatility(), vol, 1e-10 * vol);
+}
+
+TEST(RollingPerformanceTest, FlatWindowAndInvalidWindow) {
+    RollingPerformance rolling({.bars = 3, .frequency = Frequency::DAILY});
+    for (int i = 0; i < 5; ++i) rolling.add(100.0);
+    EXPECT_EQ(rolling.annualizedVolatility(), 0.0);
+    EXPECT_EQ(rolling.sharpeRatio(), 0.0);
+    EXPECT_EQ(rolling.drawdown(), 0.0);
+    EXPECT_THROW(RollingPerformance({.bars = 1}), std::invalid_argument);
+}
+
+// Every bar is a new peak candidate while the oldest one expires
+TEST(RollingPerformanceTest, SteadyDeclineKeepsWindowPeak) {
+    for (size_t bars : {3, 7}) {
+        RollingPerformance rolling({.bars = bars, .frequency = Frequency::DAILY});
+        double equity = 100.0;
+        for (int i = 0; i < 50; ++i) {
+            ASSERT_NO_THROW(rolling.add(equity));
+            if (rolling.ready()) {
+                EXPECT_NEAR(rolling.drawdown(), 1.0 - std::pow(0.99, static_cast<double>(bars)),
+                            1e-12);
+            }
+            equity *= 0.99;
+        }
+    }
+}
+
+// -----------------------------
+// Quantile Sketch Tests
+// -----------------------------
+class QuantileSketchTest : public ::testing::Test {
+   protected:
+    std::vector<double> values;
+
+    void SetUp() override {
+        std::mt19937_64 rng(17);
+        std::student_t_distribution<double> fatTails(3.0);
+        for (int i = 0; i < 200'000; ++i) values.push_back(0.001 * fatTails(rng));
+    }
+
+    double exactQuantile(double q) const {
+        std::vector<double> sorted = values;
+        std::sort(sorted.begin(), sorted.end());
+        return sorted[static_cast<size_t>(std::ceil(q * sorted.size())) - 1];
+    }
+
+    // |rank(sketch.quantile(q)) - q| in the exact distribution
+    double rankError(const QuantileSketch& sketch, double q) const {
+        double estimate = sketch.quantile(q);
+        size_t below = std::count_if(values.begin(), values.end(),
+                                     [&](double v) { return v <= estimate; });
+        return std::abs(static_cast<double>(below) / values.size() - q);
+    }
+};
+
+TEST_F(QuantileSketchTest, QuantilesWithinRankErrorInBoundedMemory) {
+    QuantileSketch sketch(200);
+    size_t maxRetained = 0;
+    for (double v : values) {
+        sketch.add(v);
+        maxRetained = std::max(maxRetained, sketch.retained());
+    }
+    EXPECT_EQ(sketch.count(), values.size());
+    EXPECT_LT(maxRetained, 3 * 200 + 64);  // k / (1 - 2/3) plus the floor of 2 per level
+
+    for (double q : {0.01, 0.05, 0.25, 0.5, 0.75, 0.95, 0.99}) {
+        EXPECT_LT(rankError(sketch, q), 0.015) << "q = " << q;
+    }
+    EXPECT_EQ(sketch.min(), *std::min_element(values.begin(), values.end()));
+    EXPECT_EQ(sketch.quantile(1.0), *std::max_element(values.begin(), values.end()));
+    EXPECT_NEAR(sketch.rank(exactQuantile(0.5)), 0.5, 0.015);
+}
+
+TEST_F(QuantileSketchTest, MergedPartsMatchOneStream) {
+    std::vector<QuantileSketch> parts;
+    for (size_t p = 0; p < 8; ++p) parts.emplace_back(200, p);
+    for (size_t i = 0; i < values.size(); ++i) parts[i % 8].add(values[i]);
+
+    QuantileSketch merged(200);
+    for (const QuantileSketch& part : parts) merged.merge(part);
+    EXPECT_EQ(merged.count(), values.size());
+    EXPECT_LT(merged.retained(), 3 * 200 + 64);
+    for (double q : {0.01, 0.5, 0.99}) EXPECT_LT(rankError(merged, q), 0.015);
+
+    EXPECT_THROW(merged.merge(QuantileSketch(100)), std::invalid_argument);
+}
+
+TEST_F(QuantileSketchTest, ValueAtRiskAndTail) {
+    QuantileSketch sketch(400);
+    for (double v : values) sketch.add(v);
+
+    double var = -exactQuantile(0.05);
+    double tail = 0.0;
+    size_t n = 0;
+    for (double v : values) {
+        if (v <= -var) {
+            tail += v;
+            ++n;
+        }
+    }
+    EXPECT_NEAR(sketch.valueAtRisk(0.95), var, 0.05 * var);
+    EXPECT_NEAR(sketch.conditionalValueAtRisk(0.95), -tail / n, 0.05 * (-tail / n));
+    EXPECT_GT(sketch.conditionalValueAtRisk(0.95), sketch.valueAtRisk(0.95));
+}
+
+TEST_F(QuantileSketchTest, DeterministicAndEmptyThrows) {
+    QuantileSketch a(64, 9), b(64, 9);
+    for (double v : values) {
+        a.add(v);
+        b.add(v);
+    }
+    EXPECT_EQ(a.quantile(0.3), b.quantile(0.3));
+    EXPECT_EQ(a.tailMean(0.1), b.tailMean(0.1));
+
+    QuantileSketch empty;
+    EXPECT_THROW(empty.quantile(0.5), std::runtime_error);
+    EXPECT_THROW(QuantileSketch(4), std::invalid_argument);
+}
@@ -0,0 +1,273 @@
+#include <gtest/gtest.h>
+
+#include <map>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../strategies/smacrossover.h"
+#include "backtest-cpp/data.h"
+#include "backtest-cpp/engine.h"
+#include "backtest-cpp/pipeline.h"
+#include "backtest-cpp/portfolio.h"
+#include "backtest-cpp/spsc_queue.h"
+#include "test_util.h"
+
+// ============================================================================
+// SpscQueue Tests
+// ============================================================================
+
+TEST(SpscQueueTest, FullAndEmptyAtCapacity) {
+    SpscQueue<int> queue(3);
+    EXPECT_EQ(queue.capacity(), 4);
+    EXPECT_EQ(queue.tryPeek(), nullptr);
+
+    for (int i = 0; i < 4; ++i) {
+        int* slot = queue.tryClaim();
+        ASSERT_NE(slot, nullptr);
+        *slot = i;
+        EXPECT_EQ(queue.publish(), static_cast<size_t>(i + 1));
+    }
+    EXPECT_EQ(queue.tryClaim(), nullptr);
+
+    for (int i = 0; i < 4; ++i) {
+        int* slot = queue.tryPeek();
+        ASSERT_NE(slot, nullptr);
+        EXPECT_EQ(*slot, i);
+        queue.release();
+    }
+    EXPECT_EQ(queue.tryPeek(), nullptr);
+    EXPECT_NE(queue.tryClaim(), nullptr);
+}
+
+TEST(SpscQueueTest, PublishReportsCurrentDepth) {
+    SpscQueue<int> queue(8);
+    auto push = [&] {
+        EXPECT_NE(queue.tryClaim(), nullptr);
+        return queue.publish();
+    };
+    auto pop = [&] {
+        EXPECT_NE(queue.tryPeek(), nullptr);
+        queue.release();
+    };
+
+    // The consumer keeps up, so the depth stays at one however many go through
+    for (int i = 0; i < 20; ++i) {
+        EXPECT_EQ(push(), 1);
+        pop();
+    }
+    EXPECT_EQ(push(), 1);
+    EXPECT_EQ(push(), 2);
+    EXPECT_EQ(push(), 3);
+    pop();
+    pop();
+    EXPECT_EQ(push(), 2);
+}
+
+TEST(SpscQueueTest, KeepsOrderAcrossThreads) {
+    constexpr uint64_t kCount = 200'000;
+    SpscQueue<uint64_t> queue(64);
+
+    std::thread producer([&] {
+        for (uint64_t i = 0; i < kCount; ++i) {
+            uint64_t* slot;
+            while ((slot = queue.tryClaim()) == nullptr) std::this_thread::yield();
+            *slot = i;
+            queue.publish();
+        }
+    });
+
+    uint64_t expected = 0;
+    bool ordered = true;
+    while (expected < kCount) {
+        uint64_t* slot = queue.tryPeek();
+        if (slot == nullptr) {
+            std::this_thread::yield();
+            continue;
+        }
+        ordered = ordered && *slot == expected;
+        ++expected;
+        queue.release();
+    }
+    producer.join();
+    EXPECT_TRUE(ordered);
+}
+
+// ============================================================================
+// PipelinedEngine Tests
+// ============================================================================
+
+class PipelineTest : public ::testing::Test {
+   protected:
+    DataHandler data;
+    std::string testFilePath = "test_pipeline_temp.csv";
+
+    void SetUp() override {
+        writeSineCsv(testFilePath, 600);
+        data.loadCSV(testFilePath, "NQ");
+    }
+
+    void TearDown() override { std::remove(testFilePath.c_str()); }
+
+    EngineConfig quietConfig() {
+        return {.warmupBars = 30, .maxInvest = 10'000, .logOrders = false};
+    }
+
+    // Runs both engines on fresh strategies and portfolios and compares everything
+    void expectSameAsEngine(const PortfolioConfig& portfolioConfig,
+                            const PipelineConfig& pipeline) {
+        SMACrossover sequentialStrategy(10, 30);
+        Portfolio sequentialPortfolio(portfolioConfig);
+        BacktestEngine sequential(data, sequentialStrategy, sequentialPortfolio, quietConfig());
+        sequential.run();
+
+        SMACrossover pipelinedStrategy(10, 30);
+        Portfolio pipelinedPortfolio(portfolioConfig);
+        PipelinedEngine pipelined(data, pipelinedStrategy, pipelinedPortfolio, quietConfig(),
+                                  pipeline);
+        const PipelineStats& stats = pipelined.run();
+
+        ASSERT_GT(sequentialPortfolio.getAllTrades().size(), 0);
+        EXPECT_EQ(pipelinedPortfolio.getAllTrades().size(),
+                  sequentialPortfolio.getAllTrades().size());
+        EXPECT_EQ(pipelinedPortfolio.getRealizedPnL(), sequentialPortfolio.getRealizedPnL());
+        EXPECT_EQ(stats.engine.bars, sequential.getStats().bars);
+        EXPECT_EQ(stats.engine.eventsByType, sequential.getStats().eventsByType);
+
+        const std::vector<EquityPoint>& curve = pipelined.getEquityCurve();
+        ASSERT_EQ(curve.size(), sequential.getEquityCurve().size());
+        for (size_t i = 0; i < curve.size(); ++i) {
+            EXPECT_EQ(curve[i].time, sequential.getEquityCurve()[i].time);
+            EXPECT_EQ(curve[i].equity, sequential.getEquityCurve()[i].equity);
+        }
+        EXPECT_EQ(pipelined.getPerformance().size(), sequential.getPerformance().size());
+        EXPECT_EQ(pipelined.getPerformance().maxDrawdown(),
+                  sequential.getPerformance().maxDrawdown());
+    }
+};
+
+// Buys whenever it is flat, so its signals depend on the positions it is handed
+class BuyWhenFlat : public Strategy {
+   public:
+    void onInit(const std::vector<std::map<std::string, Bar>>&) override {}
+
+    std::map<std::string, std::optional<Signal>> onBars(
+        const std::map<std::string, Bar>& bars,
+        std::map<std::string, Position>& positions) override {
+        std::map<std::string, std::optional<Signal>> signals;
+        for (const auto& [symbol, bar] : bars) {
+            if (!positions.contains(symbol)) {
+                signals[symbol] = Signal{bar.time, symbol, SignalType::BUY};
+            }
+        }
+        return signals;
+    }
+
+    Order generateOrder(const Signal&, const Bar&, const double&,
+                        std::map<std::string, Position>&) override {
+        return {};
+    }
+
+    std::map<std::string, Order> generateOrders(const std::map<std::string, Signal>&,
+                                                const std::map<std::string, Bar>&, const double&,
+                                                std::map<std::string, Position>&) override {
+        return {};
+    }
+};
+
+TEST_F(PipelineTest, MatchesSequentialEngine) {
+    expectSameAsEngine({.initialCash = 100'000.0, .commission = 2.7, .logTrades = false},
+                       {.queueCapacity = 4});  // Small queues make the stages block often
+}
+
+TEST_F(PipelineTest, MatchesSequentialEngineWithLatency) {
+    expectSameAsEngine({.initialCash = 100'000.0,
+                        .commission = 2.7,
+                        .latency = {.delayNs = 1},
+                        .logTrades = false},
+                       {});
+}
+
+TEST_F(PipelineTest, RunsOnAnyPortfolioType) {
+    PortfolioConfig config{.initialCash = 100'000.0, .logTrades = false};
+    RuntimeCommission commission(PerContractCommission{1.5});
+    RuntimeSlippage slippage(FixedTickSlippage{});
+    SMACrossover sequentialStrategy(10, 30);
+    RuntimePortfolio sequentialPortfolio(config, commission, slippage);
+    BasicBacktestEngine<Strategy, RuntimePortfolio> sequential(data, sequentialStrategy,
+                                                               sequentialPortfolio, quietConfig());
+    sequential.run();
+
+    SMACrossover pipelinedStrategy(10, 30);
+    RuntimePortfolio pipelinedPortfolio(config, commission, slippage);
+    BasicPipelinedEngine<RuntimePortfolio> pipelined(data, pipelinedStrategy, pipelinedPortfolio,
+                                                     quietConfig());
+    pipelined.run();
+
+    ASSERT_GT(sequentialPortfolio.getAllTrades().size(), 0);
+    EXPECT_EQ(pipelinedPortfolio.getAllTrades().size(),
+              sequentialPortfolio.getAllTrades().size());
+    EXPECT_EQ(pipelinedPortfolio.getRealizedPnL(), sequentialPortfolio.getRealizedPnL());
+    EXPECT_EQ(pipelined.getEquityCurve().back().equity,
+              sequential.getEquityCurve().back().equity);
+}
+
+TEST_F(PipelineTest, KeepsOnlyPerformanceWithoutEquityCurve) {
+    SMACrossover strategy(10, 30);
+    Portfolio portfolio({.initialCash = 100'000.0, .commission = 2.7, .logTrades = false});
+    EngineConfig config = quietConfig();
+    config.keepEquityCurve = false;
+    PipelinedEngine engine(data, strategy, portfolio, config);
+    engine.run();
+
+    EXPECT_TRUE(engine.getEquityCurve().empty());
+    EXPECT_EQ(engine.getPerformance().size(), 571);  // 570 bars and the final liquidation
+    EXPECT_EQ(engine.getPerformance().lastEquity(), portfolio.getAvailableCash());
+}
+
+TEST_F(PipelineTest, RejectsWhatItCannotRun) {
+    Portfolio portfolio({.initialCash = 100'000.0, .logTrades = false});
+    BuyWhenFlat readsPositions;
+    EXPECT_THROW(PipelinedEngine(data, readsPositions, portfolio, quietConfig()),
+                 std::invalid_argument);
+
+    SMACrossover strategy(10, 30);
+    EngineConfig checkpoints = quietConfig();
+    checkpoints.checkpointEvery = 100;
+    EngineConfig rolling = quietConfig();
+    rolling.rollingWindows = {{.bars = 20}};
+    EngineConfig sketch = quietConfig();
+    sketch.quantileSketchK = 64;
+    for (const EngineConfig& config : {checkpoints, rolling, sketch}) {
+        EXPECT_THROW(PipelinedEngine(data, strategy, portfolio, config), std::invalid_argument);
+    }
+}
+
+TEST_F(PipelineTest, ReportsStagesAndQueues) {
+    SMACrossover strategy(10, 30);
+    Portfolio portfolio({.initialCash = 100'000.0, .commission = 2.7, .logTrades = false});
+    PipelinedEngine engine(data, strategy, portfolio, quietConfig(),
+                           {.queueCapacity = 16, .cpus = {0, 0, 0}});
+    const PipelineStats& stats = engine.run();
+
+    for (const StageStats& stage : stats.stages) {
+        EXPECT_EQ(stage.items, 570);
+        EXPECT_GE(stage.utilization, 0.0);
+        EXPECT_LE(stage.utilization, 1.0);
+    }
+    for (const QueueStats& queue : stats.queues) {
+        EXPECT_EQ(queue.capacity, 16);
+        EXPECT_GE(queue.maxDepth, 1);
+        EXPECT_LE(queue.maxDepth, 16);
+        EXPECT_LE(queue.meanDepth, 16.0);
+    }
+}
+
+TEST_F(PipelineTest, StageErrorsReachTheCaller) {
+    SMACrossover strategy(10, 30);
+    Portfolio portfolio({.initialCash = 100'000.0, .commission = 2.7, .logTrades = false});
+    PipelinedEngine engine(data, strategy, portfolio, quietConfig(), {.cpus = {-1, 1 << 20, -1}});
+    EXPECT_THROW(engine.run(), std::runtime_error);  // No such CPU to pin the strategy to
+}
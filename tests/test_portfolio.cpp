@@ -2,6 +2,8 @@
 
 #include <cstdint>
 #include <ctime>
+#include <map>
+#include <span>
 
 #include "backtest-cpp/data.h"
 #include "backtest-cpp/portfolio.h"
@@ -174,10 +176,11 @@ TEST_F(PortfolioTest, NegativeQuantityHandling) {
     order.quantity = -10;  // Negative!
     order.type = OrderType::MARKET;
 
-    // Behavior depends on your implementation
-    // For now, just ensure it doesn't crash
+    // A short takes the same margin as a long: 10 * 100 + 2.7 fits in the cash
     bool result = portfolio->checkOverdraft(order);
-    // Add expectation based on your intended behavior
+    EXPECT_FALSE(result);
+    order.quantity = -1'000;
+    EXPECT_TRUE(portfolio->checkOverdraft(order));
 }
 
 // ============================================================================
@@ -399,13 +402,13 @@ TEST_F(PortfolioTest, CloseLongPositionWithProfit) {
     portfolio->executeOrder(openOrder, false);
 
     double cashAfterOpen = portfolio->getAvailableCash();
-    // std::cout << "Cash after open: " << cashAfterOpen << std::endl;
+    EXPECT_DOUBLE_EQ(cashAfterOpen, 100'000.0 - 1'000.0 - 2.7);
 
     Order closeOrder = createTestOrder("NQ", SignalType::SELL, 110.0, -10);
     portfolio->executeOrder(closeOrder, true);
 
     double actualCash = portfolio->getAvailableCash();
-    // std::cout << "Cash after close: " << actualCash << std::endl;
+    EXPECT_DOUBLE_EQ(actualCash - cashAfterOpen, 1'100.0);  // Margin back plus the profit
 
     EXPECT_DOUBLE_EQ(portfolio->getAvailableCash(), 100097.3);  // FIX
     // If fails, gtest prints: Expected: 100097.3, Actual: 99999.99
@@ -640,6 +643,490 @@ TEST_F(PortfolioTest, InsufficientFundsBlocksOrder) {
     EXPECT_DOUBLE_EQ(portfolio->getAvailableCash(), 100000.0);
 }
 
+// ============================================================================
+// LATENCY / PENDING ORDER TESTS
+// ============================================================================
+
+class PortfolioLatencyTest : public ::testing::Test {
+   protected:
+    static constexpr int64_t kMinute = 60'000'000'000;
+
+    Portfolio makePortfolio(int64_t delayNs, double participation = 1.0) {
+        return Portfolio({.initialCash = 100'000.0,
+                          .commission = 2.7,
+                          .latency = {.delayNs = delayNs},
+                          .maxVolumeParticipation = participation});
+    }
+
+    std::map<std::string, Bar> makeBars(int64_t time, double open, double close, long volume) {
+        Bar bar{.symbol = "NQ",
+                .time = time,
+                .open = open,
+                .high = std::max(open, close),
+                .low = std::min(open, close),
+                .close = close,
+                .volume = volume};
+        return {{"NQ", bar}};
+    }
+
+    Order makeOrder(int64_t time, double price, int quantity) {
+        return Order{.time = time,
+                     .symbol = "NQ",
+                     .direction = quantity > 0 ? SignalType::BUY : SignalType::SELL,
+                     .price = price,
+                     .type = OrderType::MARKET,
+                     .quantity = quantity};
+    }
+};
+
+TEST_F(PortfolioLatencyTest, FixedLatencySample) {
+    LatencyModel model({.delayNs = 500});
+    EXPECT_EQ(model.sample("NQ"), 500);
+    EXPECT_FALSE(model.isZero());
+    EXPECT_TRUE(LatencyModel().isZero());
+}
+
+TEST_F(PortfolioLatencyTest, PerSymbolLatencyOverridesBase) {
+    LatencyModel model({.delayNs = 500, .perSymbolNs = {{"ES", 100}}});
+    EXPECT_EQ(model.sample("ES"), 100);
+    EXPECT_EQ(model.sample("NQ"), 500);
+}
+
+TEST_F(PortfolioLatencyTest, DistributionIsReproducibleAndNonNegative) {
+    LatencyConfig config{.type = LatencyType::NORMAL, .delayNs = 100, .jitterNs = 1000};
+    LatencyModel a(config);
+    LatencyModel b(config);
+    for (int i = 0; i < 1000; ++i) {
+        int64_t delay = a.sample("NQ");
+        EXPECT_EQ(delay, b.sample("NQ"));
+        EXPECT_GE(delay, 0);
+    }
+}
+
+TEST_F(PortfolioLatencyTest, ZeroLatencyExecutesImmediately) {
+    Portfolio p = makePortfolio(0);
+    p.submitOrder(makeOrder(0, 100.0, 10));
+
+    EXPECT_EQ(p.getPendingOrderCount(), 0);
+    EXPECT_EQ(p.getCurrentPositions().at("NQ").quantity, 10);
+    EXPECT_DOUBLE_EQ(p.getCurrentPositions().at("NQ").averagePrice, 100.0);
+}
+
+TEST_F(PortfolioLatencyTest, DelayedOrderFillsAtFirstBarAfterArrival) {
+    Portfolio p = makePortfolio(kMinute / 2);
+    p.submitOrder(makeOrder(0, 100.0, 10));
+
+    // Same bar: not arrived yet
+    EXPECT_EQ(p.processPendingOrders(makeBars(0, 99.0, 100.0, 1000)), 0);
+    EXPECT_TRUE(p.getCurrentPositions().empty());
+
+    // Next bar starts after arrival, fill at its open
+    EXPECT_EQ(p.processPendingOrders(makeBars(kMinute, 101.0, 102.0, 1000)), 1);
+    EXPECT_EQ(p.getPendingOrderCount(), 0);
+    EXPECT_EQ(p.getCurrentPositions().at("NQ").quantity, 10);
+    EXPECT_DOUBLE_EQ(p.getCurrentPositions().at("NQ").averagePrice, 101.0);
+}
+
+TEST_F(PortfolioLatencyTest, PartialFillsLimitedByVolume) {
+    Portfolio p = makePortfolio(1, 0.5);
+    p.submitOrder(makeOrder(0, 100.0, 10));
+
+    // 50% of 8 contracts per bar
+    p.processPendingOrders(makeBars(kMinute, 100.0, 100.0, 8));
+    EXPECT_EQ(p.getCurrentPositions().at("NQ").quantity, 4);
+    EXPECT_EQ(p.getPendingOrderCount(), 1);
+
+    p.processPendingOrders(makeBars(2 * kMinute, 100.0, 100.0, 8));
+    EXPECT_EQ(p.getCurrentPositions().at("NQ").quantity, 8);
+
+    p.processPendingOrders(makeBars(3 * kMinute, 100.0, 100.0, 8));
+    EXPECT_EQ(p.getCurrentPositions().at("NQ").quantity, 10);
+    EXPECT_EQ(p.getPendingOrderCount(), 0);
+}
+
+TEST_F(PortfolioLatencyTest, PendingOrdersFillInArrivalOrder) {
+    Portfolio p = makePortfolio(10);
+    p.submitOrder(makeOrder(0, 100.0, 10));
+    p.submitOrder(makeOrder(5, 100.0, -4));
+
+    // Only enough volume for the first order
+    p.processPendingOrders(makeBars(kMinute, 100.0, 100.0, 10));
+    EXPECT_EQ(p.getCurrentPositions().at("NQ").quantity, 10);
+    EXPECT_EQ(p.getPendingOrderCount(), 1);
+
+    p.processPendingOrders(makeBars(2 * kMinute, 100.0, 100.0, 10));
+    EXPECT_EQ(p.getCurrentPositions().at("NQ").quantity, 6);
+}
+
+TEST_F(PortfolioLatencyTest, RejectedFillLeavesBarVolumeToLaterOrders) {
+    Portfolio p = makePortfolio(10);
+    p.submitOrder(makeOrder(0, 50'000.0, 10));  // 500k, more than the cash
+    p.submitOrder(makeOrder(5, 50'000.0, 1));
+
+    EXPECT_EQ(p.processPendingOrders(makeBars(kMinute, 50'000.0, 50'000.0, 10)), 1);
+    EXPECT_EQ(p.getCurrentPositions().at("NQ").quantity, 1);
+    EXPECT_EQ(p.getPendingOrderCount(), 0);
+}
+
+// ============================================================================
+// COMMISSION / SLIPPAGE MODEL TESTS
+// ============================================================================
+
+TEST(CostModelTest, CommissionModels) {
+    EXPECT_DOUBLE_EQ(FlatCommission{2.7}.cost(100, 50.0), 2.7);
+    EXPECT_DOUBLE_EQ(PerContractCommission{0.85}.cost(-10, 50.0), 8.5);
+    EXPECT_DOUBLE_EQ(PercentageCommission{0.001}.cost(10, 100.0), 1.0);
+    EXPECT_DOUBLE_EQ((ExchangeFeeCommission{.brokerPerContract = 0.25,
+                                            .exchangePerContract = 0.30,
+                                            .clearingPerContract = 0.05,
+                                            .regulatoryRate = 0.0001})
+                         .cost(10, 100.0),
+                     6.1);
+}
+
+TEST(CostModelTest, TieredCommissionIsMarginal) {
+    TieredCommission tiered{.tiers = {{10, 1.0}, {100, 0.5}, {0, 0.25}}, .minimum = 2.0};
+
+    EXPECT_DOUBLE_EQ(tiered.cost(1, 0.0), 2.0);     // Minimum applies
+    EXPECT_DOUBLE_EQ(tiered.cost(10, 0.0), 10.0);   // Entirely first tier
+    EXPECT_DOUBLE_EQ(tiered.cost(50, 0.0), 30.0);   // 10 * 1.0 + 40 * 0.5
+    EXPECT_DOUBLE_EQ(tiered.cost(200, 0.0), 80.0);  // 10 + 45 + 100 * 0.25
+}
+
+TEST(CostModelTest, SlippageMovesPriceAgainstTrader) {
+    EXPECT_DOUBLE_EQ(NoSlippage{}.fillPrice(100.0, 10, 0), 100.0);
+    EXPECT_DOUBLE_EQ(SpreadSlippage{0.125}.fillPrice(100.0, 10, 0), 100.125);
+    EXPECT_DOUBLE_EQ(SpreadSlippage{0.125}.fillPrice(100.0, -10, 0), 99.875);
+    EXPECT_DOUBLE_EQ((FixedTickSlippage{.ticks = 2, .tickSize = 0.25}).fillPrice(100.0, 1, 0),
+                     100.5);
+
+    VolumeImpactSlippage impact{0.01};
+    EXPECT_DOUBLE_EQ(impact.fillPrice(100.0, 25, 100), 100.5);  // 100 * 0.01 * sqrt(0.25)
+    EXPECT_DOUBLE_EQ(impact.fillPrice(100.0, -25, 100), 99.5);
+    EXPECT_DOUBLE_EQ(impact.fillPrice(100.0, 25, 0), 100.0);  // Unknown volume
+}
+
+TEST(CostModelTest, PortfolioAppliesPolicies) {
+    BasicPortfolio<PerContractCommission, SpreadSlippage> portfolio(
+        {.initialCash = 100'000.0, .commission = 0.0}, PerContractCommission{1.5},
+        SpreadSlippage{0.5});
+
+    portfolio.executeOrder(Order{.time = 0,
+                                 .symbol = "NQ",
+                                 .direction = SignalType::BUY,
+                                 .price = 100.0,
+                                 .type = OrderType::MARKET,
+                                 .quantity = 10},
+                           false);
+
+    // Pays 100.5 per contract plus 10 * 1.5 commission
+    EXPECT_DOUBLE_EQ(portfolio.getCurrentPositions().at("NQ").averagePrice, 100.5);
+    EXPECT_DOUBLE_EQ(portfolio.getAvailableCash(), 100'000.0 - 1005.0 - 15.0);
+}
+
+TEST(CostModelTest, RuntimePortfolioMatchesStaticPolicies) {
+    PortfolioConfig config{.initialCash = 100'000.0, .commission = 0.0};
+    BasicPortfolio<PercentageCommission, FixedTickSlippage> fixed(
+        config, PercentageCommission{0.0002}, FixedTickSlippage{.ticks = 1, .tickSize = 0.25});
+    RuntimePortfolio runtime(config, RuntimeCommission(PercentageCommission{0.0002}),
+                             RuntimeSlippage(FixedTickSlippage{.ticks = 1, .tickSize = 0.25}));
+
+    for (auto [price, quantity] : {std::pair{100.0, 10}, {110.0, -20}, {105.0, 10}}) {
+        Order order{.time = 0,
+                    .symbol = "NQ",
+                    .direction = quantity > 0 ? SignalType::BUY : SignalType::SELL,
+                    .price = price,
+                    .type = OrderType::MARKET,
+                    .quantity = quantity};
+        fixed.executeOrder(order, false);
+        runtime.executeOrder(order, false);
+    }
+
+    EXPECT_DOUBLE_EQ(fixed.getAvailableCash(), runtime.getAvailableCash());
+    EXPECT_DOUBLE_EQ(fixed.getRealizedPnL(), runtime.getRealizedPnL());
+}
+
+TEST_F(PortfolioLatencyTest, SavedStateRestoresPendingOrders) {
+    Portfolio original = makePortfolio(kMinute);
+    original.executeOrder(makeOrder(0, 100.0, 5), false);
+    original.submitOrder(makeOrder(0, 100.0, -3));
+    original.submitOrder(makeOrder(0, 100.0, 2));
+
+    BinaryWriter writer;
+    original.saveState(writer);
+    Portfolio restored = makePortfolio(kMinute);
+    BinaryReader reader(writer.data());
+    restored.loadState(reader);
+    EXPECT_TRUE(reader.atEnd());
+
+    EXPECT_EQ(restored.getPendingOrderCount(), 2);
+    EXPECT_DOUBLE_EQ(restored.getAvailableCash(), original.getAvailableCash());
+
+    auto bars = makeBars(kMinute, 101.0, 102.0, 1000);
+    EXPECT_EQ(original.processPendingOrders(bars), restored.processPendingOrders(bars));
+    EXPECT_EQ(restored.getCurrentPositions().at("NQ").quantity,
+              original.getCurrentPositions().at("NQ").quantity);
+    EXPECT_EQ(restored.getRealizedPnL(), original.getRealizedPnL());
+    EXPECT_EQ(restored.getAvailableCash(), original.getAvailableCash());
+}
+
+// ============================================================================
+// BATCH EXECUTION TESTS
+// ============================================================================
+
+TEST_F(PortfolioTest, ExecuteOrdersMatchesSequentialForDistinctSymbols) {
+    Portfolio sequential({.initialCash = 100'000.0, .commission = 2.7});
+    std::vector<Order> orders = {createTestOrder("ES", SignalType::BUY, 100.0, 10),
+                                 createTestOrder("NQ", SignalType::SELL, 200.0, -5),
+                                 createTestOrder("CL", SignalType::BUY, 50.0, 20)};
+    std::vector<ExecutionResult> results(orders.size());
+
+    portfolio->executeOrders(orders, results);
+    for (const Order& order : orders) sequential.executeOrder(order, false);
+
+    for (const ExecutionResult& result : results) {
+        EXPECT_EQ(result.status, ExecutionStatus::FILLED);
+    }
+    EXPECT_DOUBLE_EQ(portfolio->getAvailableCash(), sequential.getAvailableCash());
+    EXPECT_EQ(portfolio->getCurrentPositions().at("NQ").quantity, -5);
+    EXPECT_EQ(portfolio->getCurrentPositions().size(), 3);
+}
+
+TEST_F(PortfolioTest, ExecuteOrdersNetsPerSymbol) {
+    std::vector<Order> orders = {createTestOrder("NQ", SignalType::BUY, 100.0, 10),
+                                 createTestOrder("NQ", SignalType::SELL, 100.0, -4)};
+    std::vector<ExecutionResult> results(orders.size());
+    std::vector<Order> fills;
+
+    portfolio->executeOrders(orders, results, &fills);
+
+    // One fill of 6, one commission
+    ASSERT_EQ(fills.size(), 1);
+    EXPECT_EQ(fills[0].quantity, 6);
+    EXPECT_EQ(results[0].filledQuantity, 10);
+    EXPECT_EQ(results[1].filledQuantity, -4);
+    EXPECT_EQ(portfolio->getCurrentPositions().at("NQ").quantity, 6);
+    EXPECT_DOUBLE_EQ(portfolio->getAvailableCash(), 100'000.0 - 600.0 - 2.7);
+}
+
+TEST_F(PortfolioTest, ExecuteOrdersRejectsWhenBudgetIsUsedUp) {
+    // 600 * 100 fits, the second 600 * 100 does not
+    std::vector<Order> orders = {createTestOrder("ES", SignalType::BUY, 100.0, 600),
+                                 createTestOrder("NQ", SignalType::BUY, 100.0, 600),
+                                 createTestOrder("CL", SignalType::BUY, 100.0, 0)};
+    std::vector<ExecutionResult> results(orders.size());
+
+    portfolio->executeOrders(orders, results);
+
+    EXPECT_EQ(results[0].status, ExecutionStatus::FILLED);
+    EXPECT_EQ(results[1].status, ExecutionStatus::OVERDRAFT);
+    EXPECT_EQ(results[2].status, ExecutionStatus::ZERO_QUANTITY);
+    EXPECT_EQ(portfolio->getCurrentPositions().count("NQ"), 0);
+}
+
+TEST_F(PortfolioTest, ExecuteOrdersEnforcesPositionLimit) {
+    Portfolio limited({.initialCash = 100'000.0, .commission = 2.7, .maxPositionSize = 10});
+    limited.executeOrder(createTestOrder("NQ", SignalType::BUY, 100.0, 8), false);
+
+    std::vector<Order> orders = {createTestOrder("NQ", SignalType::BUY, 100.0, 5),
+                                 createTestOrder("NQ", SignalType::BUY, 100.0, 2)};
+    std::vector<ExecutionResult> results(orders.size());
+    limited.executeOrders(orders, results);
+
+    EXPECT_EQ(results[0].status, ExecutionStatus::POSITION_LIMIT);
+    EXPECT_EQ(results[1].status, ExecutionStatus::FILLED);
+    EXPECT_EQ(limited.getCurrentPositions().at("NQ").quantity, 10);
+}
+
+TEST_F(PortfolioTest, ExecuteOrdersRequiresResultPerOrder) {
+    std::vector<Order> orders = {createTestOrder("NQ", SignalType::BUY, 100.0, 1)};
+    std::vector<ExecutionResult> results;
+    EXPECT_THROW(portfolio->executeOrders(orders, results), std::invalid_argument);
+}
+
+TEST_F(PortfolioTest, ExecuteOrdersPricesNetAtNetNotional) {
+    Portfolio batched({.initialCash = 100'000.0, .commission = 0.0});
+    std::vector<Order> orders = {createTestOrder("NQ", SignalType::BUY, 100.0, 10),
+                                 createTestOrder("NQ", SignalType::SELL, 110.0, -5)};
+    std::vector<ExecutionResult> results(orders.size());
+    batched.executeOrders(orders, results);
+
+    // Bought 10 for 1000, sold 5 for 550: long 5 for a net 450
+    std::map<std::string, Bar> bars = {{"NQ", createTestBar("NQ", 100.0)}};
+    EXPECT_EQ(batched.getCurrentPositions().at("NQ").quantity, 5);
+    EXPECT_DOUBLE_EQ(batched.getAvailableCash(), 99'550.0);
+    EXPECT_DOUBLE_EQ(batched.getTotalEquity(bars), 100'050.0);
+}
+
+TEST_F(PortfolioTest, ExecuteOrdersChargesOneCommissionPerSymbol) {
+    // 900 notional and one 60 fee fit in 1000; two fees would not
+    Portfolio batched({.initialCash = 1'000.0, .commission = 60.0});
+    std::vector<Order> orders = {createTestOrder("NQ", SignalType::BUY, 100.0, 4),
+                                 createTestOrder("NQ", SignalType::BUY, 100.0, 5)};
+    std::vector<ExecutionResult> results(orders.size());
+    batched.executeOrders(orders, results);
+
+    EXPECT_EQ(results[0].status, ExecutionStatus::FILLED);
+    EXPECT_EQ(results[1].status, ExecutionStatus::FILLED);
+    EXPECT_DOUBLE_EQ(batched.getAvailableCash(), 40.0);
+}
+
+TEST_F(PortfolioTest, ExecuteOrdersSlipsWithBarVolume) {
+    using ImpactPortfolio = BasicPortfolio<FlatCommission, VolumeImpactSlippage>;
+    Bar bar = createTestBar("NQ", 100.0);
+    bar.volume = 100;
+    std::map<std::string, Bar> bars = {{"NQ", bar}};
+    std::vector<Order> orders = {createTestOrder("NQ", SignalType::BUY, 100.0, 25)};
+    std::vector<ExecutionResult> results(orders.size());
+
+    // 25 of 100 contracts move the price 100 * 0.1 * sqrt(0.25) = 5
+    ImpactPortfolio filled({.initialCash = 10'000.0, .commission = 0.0}, FlatCommission{},
+                           VolumeImpactSlippage{.coefficient = 0.1});
+    filled.executeOrders(orders, results, nullptr, &bars);
+    EXPECT_DOUBLE_EQ(filled.getCurrentPositions().at("NQ").averagePrice, 105.0);
+
+    // 2500 at the quoted price would fit, 2625 at the fill price does not
+    ImpactPortfolio tight({.initialCash = 2'600.0, .commission = 0.0}, FlatCommission{},
+                          VolumeImpactSlippage{.coefficient = 0.1});
+    tight.executeOrders(orders, results, nullptr, &bars);
+    EXPECT_EQ(results[0].status, ExecutionStatus::OVERDRAFT);
+    EXPECT_TRUE(tight.getCurrentPositions().empty());
+}
+
+TEST_F(PortfolioTest, ExecuteOrdersRefusesSyntheticBars) {
+    Bar stale = createTestBar("NQ", 100.0);
+    stale.synthetic = true;
+    std::map<std::string, Bar> bars = {{"ES", createTestBar("ES", 100.0)}, {"NQ", stale}};
+    std::vector<Order> orders = {createTestOrder("NQ", SignalType::BUY, 100.0, 5),
+                                 createTestOrder("ES", SignalType::BUY, 100.0, 5)};
+    std::vector<ExecutionResult> results(orders.size());
+    std::vector<Order> fills;
+
+    portfolio->executeOrders(orders, results, &fills, &bars);
+
+    EXPECT_EQ(results[0].status, ExecutionStatus::NO_TRADE);
+    EXPECT_EQ(results[1].status, ExecutionStatus::FILLED);
+    ASSERT_EQ(fills.size(), 1);
+    EXPECT_EQ(fills[0].symbol, "ES");
+    EXPECT_EQ(portfolio->getCurrentPositions().count("NQ"), 0);
+}
+
+// ============================================================================
+// Trade Stats Tests
+// ============================================================================
+
+TEST_F(PortfolioTest, TradeStatsAggregateClosedTrades) {
+    auto trade = [&](double entry, double exit, int quantity, int64_t opened, int64_t closed) {
+        SignalType side = quantity > 0 ? SignalType::BUY : SignalType::SELL;
+        SignalType exitSide = quantity > 0 ? SignalType::SELL : SignalType::BUY;
+        Order open = createTestOrder("NQ", side, entry, quantity);
+        Order close = createTestOrder("NQ", exitSide, exit, -quantity);
+        open.time = opened;
+        close.time = closed;
+        portfolio->executeOrder(open, false);
+        portfolio->executeOrder(close, true);
+    };
+    trade(100.0, 110.0, 10, 0, 60);     // +97.30
+    trade(110.0, 100.0, -10, 60, 240);  // +97.30
+    trade(100.0, 95.0, 10, 300, 330);   // -52.70
+
+    const TradeStats& stats = portfolio->getTradeStats();
+    EXPECT_EQ(stats.trades, 3);
+    EXPECT_EQ(stats.wins, 2);
+    EXPECT_EQ(stats.losses, 1);
+    EXPECT_DOUBLE_EQ(stats.winRate(), 2.0 / 3.0);
+    EXPECT_DOUBLE_EQ(stats.averageWin(), 97.30);
+    EXPECT_DOUBLE_EQ(stats.averageLoss(), -52.70);
+    EXPECT_DOUBLE_EQ(stats.largestLoss, -52.70);
+    EXPECT_DOUBLE_EQ(stats.profitFactor(), 2 * 97.30 / 52.70);
+    EXPECT_DOUBLE_EQ(stats.expectancy(), portfolio->getRealizedPnL() / 3);
+    EXPECT_DOUBLE_EQ(stats.averageHoldingTime(), (60.0 + 180.0 + 30.0) / 3);
+
+    double pnl = 0.0;
+    for (const Trade& closed : portfolio->getTrades()) pnl += closed.pnl;
+    EXPECT_EQ(portfolio->getRealizedPnL(), pnl);
+}
+
+TEST_F(PortfolioTest, PartialCloseIsBookedWithPositionSign) {
+    portfolio->executeOrder(createTestOrder("NQ", SignalType::BUY, 100.0, 10), false);
+    portfolio->executeOrder(createTestOrder("NQ", SignalType::SELL, 110.0, -5), false);
+
+    // 5 * (110 - 100) - 2.70, and the remaining 5 keep their entry and side
+    const Trade& trade = portfolio->getTrades().back();
+    EXPECT_EQ(trade.quantity, 5);
+    EXPECT_DOUBLE_EQ(trade.pnl, 47.30);
+    EXPECT_DOUBLE_EQ(trade.mfe, 50.0);
+    const Position& position = portfolio->getCurrentPositions().at("NQ");
+    EXPECT_EQ(position.quantity, 5);
+    EXPECT_DOUBLE_EQ(position.averagePrice, 100.0);
+    EXPECT_EQ(position.direction, SignalType::BUY);
+    EXPECT_DOUBLE_EQ(portfolio->getAvailableCash(), 100'000.0 - 1'002.70 + 550.0);
+
+    // Short side: short 10 @ 100, cover 4 @ 90
+    portfolio->executeOrder(createTestOrder("NQ", SignalType::SELL, 110.0, -5), true);
+    portfolio->executeOrder(createTestOrder("ES", SignalType::SELL, 100.0, -10), false);
+    portfolio->executeOrder(createTestOrder("ES", SignalType::BUY, 90.0, 4), false);
+    EXPECT_EQ(portfolio->getTrades().back().quantity, -4);
+    EXPECT_DOUBLE_EQ(portfolio->getTrades().back().pnl, 37.30);
+    EXPECT_EQ(portfolio->getCurrentPositions().at("ES").quantity, -6);
+    EXPECT_DOUBLE_EQ(portfolio->getCurrentPositions().at("ES").averagePrice, 100.0);
+
+    const TradeStats& stats = portfolio->getTradeStats();
+    EXPECT_EQ(stats.trades, 3);
+    EXPECT_EQ(stats.wins, 3);
+    EXPECT_DOUBLE_EQ(stats.winRate(), 1.0);
+    EXPECT_DOUBLE_EQ(portfolio->getRealizedPnL(), 2 * 47.30 + 37.30);
+}
+
+TEST_F(PortfolioTest, MarkToMarketTracksExcursions) {
+    std::map<std::string, Bar> bars = {{"NQ", createTestBar("NQ", 102.0)}};  // 97 to 107
+
+    // Long 10 @ 100, exit @ 104 inside the range
+    portfolio->executeOrder(createTestOrder("NQ", SignalType::BUY, 100.0, 10), false);
+    portfolio->markToMarket(bars);
+    EXPECT_DOUBLE_EQ(portfolio->getCurrentPositions().at("NQ").lowPrice, 97.0);
+    EXPECT_DOUBLE_EQ(portfolio->getCurrentPositions().at("NQ").highPrice, 107.0);
+    portfolio->executeOrder(createTestOrder("NQ", SignalType::SELL, 104.0, -10), true);
+
+    // Short 10 @ 100 over the same bar, bought back @ 98
+    portfolio->executeOrder(createTestOrder("NQ", SignalType::SELL, 100.0, -10), false);
+    portfolio->markToMarket(bars);
+    portfolio->executeOrder(createTestOrder("NQ", SignalType::BUY, 98.0, 10), true);
+
+    std::span<const Trade> trades = portfolio->getTrades();
+    ASSERT_EQ(trades.size(), 2);
+    EXPECT_DOUBLE_EQ(trades[0].mae, -30.0);
+    EXPECT_DOUBLE_EQ(trades[0].mfe, 70.0);
+    EXPECT_DOUBLE_EQ(trades[1].mae, -70.0);
+    EXPECT_DOUBLE_EQ(trades[1].mfe, 30.0);
+    EXPECT_DOUBLE_EQ(portfolio->getTradeStats().averageMae(), -50.0);
+    EXPECT_DOUBLE_EQ(portfolio->getTradeStats().worstMae, -70.0);
+    EXPECT_DOUBLE_EQ(portfolio->getTradeStats().bestMfe, 70.0);
+}
+
+TEST_F(PortfolioTest, ReversalStartsNewExcursion) {
+    std::map<std::string, Bar> bars = {{"NQ", createTestBar("NQ", 100.0)}};  // 95 to 105
+    Order open = createTestOrder("NQ", SignalType::BUY, 100.0, 10);
+    Order reverse = createTestOrder("NQ", SignalType::SELL, 110.0, -20);
+    open.time = 0;
+    reverse.time = 120;
+
+    portfolio->executeOrder(open, false);
+    portfolio->markToMarket(bars);
+    portfolio->executeOrder(reverse, false);
+
+    // The exit price is part of the closed trade's range
+    const Trade& trade = portfolio->getTrades().back();
+    EXPECT_EQ(trade.entryTime, 0);
+    EXPECT_DOUBLE_EQ(trade.mae, -50.0);
+    EXPECT_DOUBLE_EQ(trade.mfe, 100.0);
+
+    const Position& position = portfolio->getCurrentPositions().at("NQ");
+    EXPECT_EQ(position.openTime, 120);
+    EXPECT_DOUBLE_EQ(position.lowPrice, 110.0);
+    EXPECT_DOUBLE_EQ(position.highPrice, 110.0);
+}
+
 // ============================================================================
 // Main function (provided by gtest_main)
 // ============================================================================
\ No newline at end of file
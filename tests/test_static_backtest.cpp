@@ -0,0 +1,117 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include "../strategies/smacrossover.h"
+#include "backtest-cpp/data.h"
+#include "backtest-cpp/engine.h"
+#include "backtest-cpp/portfolio.h"
+#include "backtest-cpp/static_backtest.h"
+#include "test_util.h"
+
+static_assert(std::is_same_v<SymbolArray<Order, 4>, std::array<Order, 4>>);
+static_assert(std::is_same_v<SymbolArray<Order, kDynamicSymbols>, std::vector<Order>>);
+// Below LogLevel::TRADES the trade log is not compiled into the portfolio
+static_assert(std::is_same_v<Backtest<SMACrossover>::PortfolioType,
+                             BasicPortfolio<FlatCommission, NoSlippage, false>>);
+static_assert(std::is_same_v<Backtest<SMACrossover, FlatCommission, NoSlippage, kDynamicSymbols,
+                                      LogLevel::TRADES>::PortfolioType,
+                             Portfolio>);
+
+class StaticBacktestTest : public ::testing::Test {
+   protected:
+    DataHandler data;
+    std::vector<std::string> files = {"test_static_nq.csv", "test_static_es.csv"};
+
+    // Two symbols on the tick grid so the SMAs cross several times
+    void SetUp() override {
+        const char* symbols[] = {"NQ", "ES"};
+        for (size_t s = 0; s < files.size(); ++s) {
+            writeSineCsv(files[s], 500, s);
+            data.loadCSV(files[s], symbols[s]);
+        }
+        data.synchronize();
+    }
+
+    void TearDown() override {
+        for (const std::string& file : files) std::remove(file.c_str());
+    }
+
+    // The dynamic build on the same portfolio policies
+    template <typename Run>
+    void expectSameAsEngine(const PortfolioConfig& portfolioConfig, Run&& run) {
+        SMACrossover strategy(10, 30);
+        Portfolio portfolio(portfolioConfig);
+        BacktestEngine engine(data, strategy, portfolio,
+                              {.warmupBars = 30, .maxInvest = 10'000, .logOrders = false});
+        engine.run();
+
+        const auto& [curve, stats, trades] = run();
+        ASSERT_GT(portfolio.getAllTrades().size(), 0);
+        EXPECT_EQ(trades, portfolio.getAllTrades().size());
+        EXPECT_EQ(stats.bars, engine.getStats().bars);
+        EXPECT_EQ(stats.eventsByType, engine.getStats().eventsByType);
+        ASSERT_EQ(curve.size(), engine.getEquityCurve().size());
+        for (size_t i = 0; i < curve.size(); ++i) {
+            EXPECT_EQ(curve[i].time, engine.getEquityCurve()[i].time);
+            EXPECT_EQ(curve[i].equity, engine.getEquityCurve()[i].equity);
+        }
+    }
+};
+
+TEST_F(StaticBacktestTest, FixedUniverseMatchesEngine) {
+    PortfolioConfig config{.initialCash = 100'000.0, .commission = 2.7, .logTrades = false};
+    SMACrossover strategy(10, 30);
+    Backtest<SMACrossover, FlatCommission, NoSlippage, 2> backtest(
+        data, strategy, config, {.warmupBars = 30, .maxInvest = 10'000});
+    backtest.run();
+
+    expectSameAsEngine(config, [&] {
+        return std::tuple(backtest.getEquityCurve(), backtest.getStats(),
+                          backtest.getPortfolio().getAllTrades().size());
+    });
+}
+
+TEST_F(StaticBacktestTest, DynamicUniverseWithLatencyMatchesEngine) {
+    PortfolioConfig config{.initialCash = 100'000.0,
+                           .commission = 2.7,
+                           .latency = {.delayNs = 1},
+                           .logTrades = false};
+    SMACrossover strategy(10, 30);
+    Backtest<SMACrossover> backtest(data, strategy, config,
+                                    {.warmupBars = 30, .maxInvest = 10'000});
+    backtest.run();
+
+    expectSameAsEngine(config, [&] {
+        return std::tuple(backtest.getEquityCurve(), backtest.getStats(),
+                          backtest.getPortfolio().getAllTrades().size());
+    });
+}
+
+TEST_F(StaticBacktestTest, PoliciesAreApplied) {
+    PortfolioConfig config{.initialCash = 100'000.0, .commission = 0.0, .logTrades = false};
+    SMACrossover plain(10, 30);
+    SMACrossover charged(10, 30);
+    Backtest<SMACrossover, FlatCommission, NoSlippage, 2> noCost(data, plain, config);
+    Backtest<SMACrossover, PerContractCommission, FixedTickSlippage, 2> withCost(
+        data, charged, config, PerContractCommission{.perContract = 1.5},
+        FixedTickSlippage{.ticks = 1, .tickSize = 0.25});
+    noCost.run();
+    withCost.run();
+
+    ASSERT_EQ(withCost.getPortfolio().getAllTrades().size(),
+              noCost.getPortfolio().getAllTrades().size());
+    EXPECT_LT(withCost.getEquityCurve().back().equity, noCost.getEquityCurve().back().equity);
+}
+
+TEST_F(StaticBacktestTest, RejectsUniverseLargerThanCompiledFor) {
+    SMACrossover strategy(10, 30);
+    Backtest<SMACrossover, FlatCommission, NoSlippage, 1> oneSymbol(
+        data, strategy, {.initialCash = 100'000.0, .commission = 2.7, .logTrades = false});
+    EXPECT_THROW(oneSymbol.run(), std::length_error);
+}
@@ -0,0 +1,221 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <map>
+#include <vector>
+
+#include "../strategies/smacrossover.h"
+#include "backtest-cpp/strategy.h"
+#include "backtest-cpp/types.h"
+
+// ============================================================================
+// SignalBuffer Tests
+// ============================================================================
+
+TEST(SignalBufferTest, SlotsAreStablePerSymbol) {
+    SignalBuffer signals;
+    size_t nq = signals.slotOf("NQ");
+    size_t es = signals.slotOf("ES");
+
+    EXPECT_NE(nq, es);
+    EXPECT_EQ(signals.slotOf("NQ"), nq);
+    EXPECT_EQ(signals.numSymbols(), 2);
+    EXPECT_TRUE(signals.empty());
+    EXPECT_EQ(signals.get(nq), nullptr);
+}
+
+TEST(SignalBufferTest, LaterSignalOverwritesEarlierOne) {
+    SignalBuffer signals;
+    signals.set(Signal{1, "NQ", SignalType::BUY});
+    signals.set(Signal{2, "NQ", SignalType::SELL});
+
+    ASSERT_EQ(signals.count(), 1);
+    const Signal* signal = signals.get(signals.slotOf("NQ"));
+    ASSERT_NE(signal, nullptr);
+    EXPECT_EQ(signal->type, SignalType::SELL);
+    EXPECT_EQ(signal->time, 2);
+}
+
+TEST(SignalBufferTest, ClearKeepsSlots) {
+    SignalBuffer signals;
+    signals.set(Signal{1, "NQ", SignalType::BUY});
+    signals.set(Signal{1, "ES", SignalType::SELL});
+    signals.clear();
+
+    EXPECT_TRUE(signals.empty());
+    EXPECT_EQ(signals.numSymbols(), 2);
+    EXPECT_EQ(signals.get(signals.slotOf("ES")), nullptr);
+
+    int visited = 0;
+    signals.forEach([&](const Signal&) { ++visited; });
+    EXPECT_EQ(visited, 0);
+}
+
+// ============================================================================
+// Strategy Interface Tests
+// ============================================================================
+
+namespace {
+
+std::vector<std::map<std::string, Bar>> makeSineBars(size_t count) {
+    std::vector<std::map<std::string, Bar>> bars;
+    for (size_t i = 0; i < count; ++i) {
+        double price = 3700.0 + 50.0 * std::sin(i / 15.0);
+        Bar bar{.symbol = "NQ",
+                .time = static_cast<int64_t>(i),
+                .open = price,
+                .high = price + 1,
+                .low = price - 1,
+                .close = price,
+                .volume = 1000};
+        bars.push_back({{"NQ", bar}});
+    }
+    return bars;
+}
+
+}  // namespace
+
+TEST(StrategyInterfaceTest, BufferAndMapInterfacesAgree) {
+    std::vector<std::map<std::string, Bar>> bars = makeSineBars(300);
+    std::vector<std::map<std::string, Bar>> history(bars.begin(), bars.begin() + 30);
+    std::map<std::string, Position> positions;
+
+    SMACrossover viaMap(10, 30);
+    SMACrossover viaBuffer(10, 30);
+    viaMap.onInit(history);
+    viaBuffer.onInit(history);
+
+    SignalBuffer signals;
+    int signalCount = 0;
+    for (size_t i = 30; i < bars.size(); ++i) {
+        std::map<std::string, std::optional<Signal>> expected = viaMap.onBars(bars[i], positions);
+
+        signals.clear();
+        viaBuffer.onBars(bars[i], positions, signals);
+
+        ASSERT_EQ(signals.count(), expected.size());
+        signals.forEach([&](const Signal& signal) {
+            ASSERT_TRUE(expected.at(signal.symbol).has_value());
+            EXPECT_EQ(expected.at(signal.symbol)->type, signal.type);
+            ++signalCount;
+        });
+    }
+    EXPECT_GT(signalCount, 0);
+}
+
+TEST(StrategyInterfaceTest, SymbolsAreTrackedIndependently) {
+    std::vector<std::map<std::string, Bar>> nq = makeSineBars(300);
+    std::vector<std::map<std::string, Bar>> es;
+    std::vector<std::map<std::string, Bar>> both;
+    for (size_t i = 0; i < nq.size(); ++i) {
+        Bar bar = nq[i].at("NQ");
+        bar.symbol = "ES";
+        bar.close = 5000.0 - 30.0 * std::cos(i / 9.0);
+        es.push_back({{"ES", bar}});
+        both.push_back({{"ES", bar}, {"NQ", nq[i].at("NQ")}});
+    }
+
+    SMACrossover nqOnly(10, 30);
+    SMACrossover esOnly(10, 30);
+    SMACrossover combined(10, 30);
+    nqOnly.onInit({nq.begin(), nq.begin() + 30});
+    esOnly.onInit({es.begin(), es.begin() + 30});
+    combined.onInit({both.begin(), both.begin() + 30});
+
+    std::map<std::string, Position> positions;
+    int signalCount = 0;
+    for (size_t i = 30; i < both.size(); ++i) {
+        std::map<std::string, std::optional<Signal>> expected = nqOnly.onBars(nq[i], positions);
+        expected.merge(esOnly.onBars(es[i], positions));
+        std::map<std::string, std::optional<Signal>> actual = combined.onBars(both[i], positions);
+
+        ASSERT_EQ(actual.size(), expected.size());
+        for (const auto& [symbol, signal] : expected) {
+            ASSERT_EQ(actual.at(symbol).has_value(), signal.has_value()) << symbol << " " << i;
+            if (signal) {
+                EXPECT_EQ(actual.at(symbol)->type, signal->type);
+                ++signalCount;
+            }
+        }
+    }
+    EXPECT_GT(signalCount, 0);
+}
+
+TEST(StrategyInterfaceTest, SymbolsStartingLateGetNoSpuriousSignals) {
+    // ES first prints during the warm-up, YM after it; both trade flat, so their SMAs agree
+    // from the start and never cross unless bars before their first print were counted
+    std::vector<std::map<std::string, Bar>> bars = makeSineBars(200);
+    for (size_t i = 20; i < bars.size(); ++i) {
+        Bar bar = bars[i].at("NQ");
+        bar.open = bar.high = bar.low = bar.close = 5000.0;
+        bar.symbol = "ES";
+        bars[i]["ES"] = bar;
+        if (i >= 100) {
+            bar.symbol = "YM";
+            bars[i]["YM"] = bar;
+        }
+    }
+
+    SMACrossover strategy(10, 30);
+    strategy.onInit({bars.begin(), bars.begin() + 30});
+    std::map<std::string, Position> positions;
+    SignalBuffer signals;
+    int nqSignals = 0;
+    for (size_t i = 30; i < bars.size(); ++i) {
+        signals.clear();
+        strategy.onBars(bars[i], positions, signals);
+        signals.forEach([&](const Signal& signal) {
+            EXPECT_EQ(signal.symbol, "NQ") << i;
+            nqSignals += signal.symbol == "NQ";
+        });
+    }
+    EXPECT_GT(nqSignals, 0);
+}
+
+// Strategy written only against the old map-returning interface
+class MapOnlyStrategy : public Strategy {
+   public:
+    void onInit(const std::vector<std::map<std::string, Bar>>&) override {}
+
+    std::map<std::string, std::optional<Signal>> onBars(
+        const std::map<std::string, Bar>& bars, std::map<std::string, Position>&) override {
+        std::map<std::string, std::optional<Signal>> signals;
+        for (const auto& [symbol, bar] : bars) {
+            signals[symbol] = std::nullopt;
+            if (bar.close > bar.open) signals[symbol] = Signal{bar.time, symbol, SignalType::BUY};
+        }
+        return signals;
+    }
+
+    Order generateOrder(const Signal&, const Bar&, const double&,
+                        std::map<std::string, Position>&) override {
+        return {};
+    }
+
+    std::map<std::string, Order> generateOrders(const std::map<std::string, Signal>&,
+                                                const std::map<std::string, Bar>&, const double&,
+                                                std::map<std::string, Position>&) override {
+        return {};
+    }
+};
+
+TEST(StrategyInterfaceTest, BaseClassAdaptsMapInterface) {
+    MapOnlyStrategy concrete;
+    Strategy& strategy = concrete;
+    std::map<std::string, Position> positions;
+    std::map<std::string, Bar> bars = {
+        {"ES", Bar{.symbol = "ES", .time = 1, .open = 10, .high = 12, .low = 9, .close = 11,
+                   .volume = 0}},
+        {"NQ", Bar{.symbol = "NQ", .time = 1, .open = 10, .high = 11, .low = 8, .close = 9,
+                   .volume = 0}}};
+
+    SignalBuffer signals;
+    strategy.onBars(bars, positions, signals);
+
+    // std::nullopt entries are skipped
+    ASSERT_EQ(signals.count(), 1);
+    EXPECT_NE(signals.get(signals.slotOf("ES")), nullptr);
+    EXPECT_EQ(signals.get(signals.slotOf("NQ")), nullptr);
+}
+
+static_assert(StaticStrategy<SMACrossover>);
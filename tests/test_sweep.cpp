@@ -0,0 +1,237 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cmath>
+#include <set>
+#include <string>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "../strategies/smacrossover.h"
+#include "backtest-cpp/data.h"
+#include "backtest-cpp/engine.h"
+#include "backtest-cpp/sweep.h"
+#include "backtest-cpp/thread_pool.h"
+
+// ============================================================================
+// ThreadPool Tests
+// ============================================================================
+
+TEST(ThreadPoolTest, RunsEveryTask) {
+    ThreadPool pool(4);
+    std::atomic<int> sum = 0;
+    for (int i = 1; i <= 1000; ++i) {
+        pool.submit([&sum, i] { sum += i; });
+    }
+    pool.wait();
+    EXPECT_EQ(sum, 500'500);
+}
+
+TEST(ThreadPoolTest, TasksCanSubmitTasks) {
+    ThreadPool pool(3);
+    std::atomic<int> leaves = 0;
+    for (int i = 0; i < 8; ++i) {
+        pool.submit([&] {
+            for (int j = 0; j < 8; ++j) pool.submit([&] { ++leaves; });
+        });
+    }
+    pool.wait();  // Also waits for tasks submitted while waiting
+    EXPECT_EQ(leaves, 64);
+}
+
+TEST(ThreadPoolTest, WaitRethrowsTaskException) {
+    ThreadPool pool(2);
+    std::atomic<int> ran = 0;
+    pool.submit([] { throw std::runtime_error("task failed"); });
+    for (int i = 0; i < 10; ++i) pool.submit([&] { ++ran; });
+
+    EXPECT_THROW(pool.wait(), std::runtime_error);
+    EXPECT_EQ(ran, 10);
+
+    // The error is reported once; the pool keeps working
+    pool.submit([&] { ++ran; });
+    EXPECT_NO_THROW(pool.wait());
+    EXPECT_EQ(ran, 11);
+}
+
+// ============================================================================
+// Parameter Grids
+// ============================================================================
+
+TEST(ParameterSweepTest, GridSkipsInvalidCombinations) {
+    std::vector<SMAParams> grid = gridSearch({5, 20, 5}, {10, 20, 10});
+    std::vector<std::pair<int, int>> pairs;
+    for (const SMAParams& p : grid) pairs.emplace_back(p.shortPeriod, p.longPeriod);
+
+    std::vector<std::pair<int, int>> expected = {{5, 10}, {5, 20}, {10, 20}, {15, 20}};
+    EXPECT_EQ(pairs, expected);
+    EXPECT_THROW(gridSearch({5, 20, 0}, {10, 20, 10}), std::invalid_argument);
+}
+
+TEST(ParameterSweepTest, RandomSearchIsReproducibleAndDistinct) {
+    std::vector<SMAParams> a = randomSearch({2, 40}, {10, 200, 5}, 50, 7);
+    std::vector<SMAParams> b = randomSearch({2, 40}, {10, 200, 5}, 50, 7);
+    ASSERT_EQ(a.size(), 50);
+
+    std::set<std::pair<int, int>> seen;
+    for (size_t i = 0; i < a.size(); ++i) {
+        EXPECT_EQ(a[i].shortPeriod, b[i].shortPeriod);
+        EXPECT_EQ(a[i].longPeriod, b[i].longPeriod);
+        EXPECT_LT(a[i].shortPeriod, a[i].longPeriod);
+        EXPECT_EQ(a[i].longPeriod % 5, 0);
+        seen.emplace(a[i].shortPeriod, a[i].longPeriod);
+    }
+    EXPECT_EQ(seen.size(), a.size());
+
+    // Asking for more than the grid holds returns the whole grid
+    EXPECT_EQ(randomSearch({1, 3}, {2, 4}, 100).size(), gridSearch({1, 3}, {2, 4}).size());
+}
+
+// ============================================================================
+// Sweeps
+// ============================================================================
+
+class SweepRunTest : public ::testing::Test {
+   protected:
+    DataHandler data;
+    SweepConfig config{.portfolio = {.initialCash = 100'000.0, .commission = 2.7},
+                       .engine = {.warmupBars = 30, .maxInvest = 10'000}};
+
+    void SetUp() override {
+        std::vector<std::map<std::string, Bar>> bars;
+        for (int i = 0; i < 600; ++i) {
+            // On the 0.25 tick grid, so prefix-sum means compare exactly like SMA's
+            double price = 3700.0 + 40.0 * std::sin(i / 13.0) + 15.0 * std::sin(i / 3.1);
+            price = std::round(price * 4.0) / 4.0;
+            Bar bar{.symbol = "NQ",
+                    .time = 1'600'000'000 + i * 60,
+                    .open = price,
+                    .high = price + 1,
+                    .low = price - 1,
+                    .close = price,
+                    .volume = 1000};
+            bars.push_back({{"NQ", bar}});
+        }
+        data.synchronize(bars);
+    }
+};
+
+TEST_F(SweepRunTest, MatchesSingleEngineRun) {
+    std::vector<SMAParams> params = {{5, 20}, {10, 40}};
+    config.threads = 2;
+    std::vector<SweepResult> results = ParameterSweep(data, config).run(params);
+    ASSERT_EQ(results.size(), 2);
+
+    // Same as running the engine by hand with the sweep's common warm-up
+    Portfolio portfolio({.initialCash = 100'000.0, .commission = 2.7, .logTrades = false});
+    SMACrossover strategy(5, 20);
+    BacktestEngine engine(data, strategy, portfolio,
+                          {.warmupBars = 40, .maxInvest = 10'000, .logOrders = false});
+    engine.run();
+
+    EXPECT_EQ(results[0].params.shortPeriod, 5);
+    EXPECT_EQ(results[0].trades, portfolio.getAllTrades().size());
+    EXPECT_DOUBLE_EQ(results[0].realizedPnL, portfolio.getRealizedPnL());
+    EXPECT_DOUBLE_EQ(results[0].finalEquity, engine.getEquityCurve().back().equity);
+    EXPECT_DOUBLE_EQ(results[0].sharpe,
+                     Performance::sharpeRatio(engine.getEquityCurve(), Frequency::MINUTE));
+}
+
+TEST_F(SweepRunTest, RunsOnAnyPortfolioType) {
+    RuntimeCommission commission(PerContractCommission{1.5});
+    RuntimeSlippage slippage(FixedTickSlippage{});
+    BasicParameterSweep<RuntimePortfolio> sweep(data, config, commission, slippage);
+    SweepResult result = sweep.runOne({5, 20});
+
+    RuntimePortfolio portfolio({.initialCash = 100'000.0, .logTrades = false}, commission,
+                               slippage);
+    SMACrossover strategy(5, 20);
+    BasicBacktestEngine<Strategy, RuntimePortfolio> engine(
+        data, strategy, portfolio, {.warmupBars = 30, .maxInvest = 10'000, .logOrders = false});
+    engine.run();
+
+    ASSERT_GT(result.trades, 0);
+    EXPECT_EQ(result.trades, portfolio.getAllTrades().size());
+    EXPECT_EQ(result.realizedPnL, portfolio.getRealizedPnL());
+    EXPECT_EQ(result.finalEquity, engine.getEquityCurve().back().equity);
+    EXPECT_LT(result.finalEquity, ParameterSweep(data, config).runOne({5, 20}).finalEquity);
+}
+
+TEST_F(SweepRunTest, ResultsDoNotDependOnThreadCount) {
+    std::vector<SMAParams> params = gridSearch({3, 15, 3}, {20, 60, 10});
+
+    config.threads = 1;
+    std::vector<SweepResult> serial = ParameterSweep(data, config).run(params);
+    config.threads = 4;
+    std::vector<SweepResult> parallel = ParameterSweep(data, config).run(params);
+
+    ASSERT_EQ(serial.size(), params.size());
+    ASSERT_EQ(parallel.size(), params.size());
+    for (size_t i = 0; i < params.size(); ++i) {
+        EXPECT_EQ(parallel[i].params.shortPeriod, params[i].shortPeriod);
+        EXPECT_EQ(parallel[i].params.longPeriod, params[i].longPeriod);
+        EXPECT_EQ(parallel[i].trades, serial[i].trades);
+        EXPECT_EQ(parallel[i].finalEquity, serial[i].finalEquity);
+        EXPECT_EQ(parallel[i].sharpe, serial[i].sharpe);
+    }
+}
+
+TEST_F(SweepRunTest, SharedSweepMatchesParameterSweep) {
+    std::vector<SMAParams> params = gridSearch({2, 20, 3}, {10, 60, 10});
+    config.threads = 2;
+    std::vector<SweepResult> expected = ParameterSweep(data, config).run(params);
+
+    BarColumns columns = BarColumns::fromData(data, "NQ");
+    std::vector<SweepResult> shared = SharedSMASweep(columns, config).run(params);
+
+    ASSERT_EQ(shared.size(), expected.size());
+    for (size_t i = 0; i < params.size(); ++i) {
+        SCOPED_TRACE(std::to_string(params[i].shortPeriod) + "/" +
+                     std::to_string(params[i].longPeriod));
+        EXPECT_EQ(shared[i].params.shortPeriod, params[i].shortPeriod);
+        EXPECT_EQ(shared[i].params.longPeriod, params[i].longPeriod);
+        EXPECT_EQ(shared[i].trades, expected[i].trades);
+        EXPECT_DOUBLE_EQ(shared[i].realizedPnL, expected[i].realizedPnL);
+        EXPECT_DOUBLE_EQ(shared[i].finalEquity, expected[i].finalEquity);
+
+        // Running sums instead of the stored curve only change the rounding
+        EXPECT_NEAR(shared[i].annualizedReturn, expected[i].annualizedReturn,
+                    1e-9 * std::fabs(expected[i].annualizedReturn) + 1e-12);
+        EXPECT_NEAR(shared[i].annualizedVolatility, expected[i].annualizedVolatility,
+                    1e-9 * expected[i].annualizedVolatility + 1e-12);
+        EXPECT_NEAR(shared[i].sharpe, expected[i].sharpe, 1e-9 * std::fabs(expected[i].sharpe));
+    }
+}
+
+TEST_F(SweepRunTest, SharedSweepRangeRecordsTheEngineCurve) {
+    BarColumns columns = BarColumns::fromData(data, "NQ");
+    SMAParams params[] = {{10, 30}};
+    std::vector<EquityPoint> curve;
+    SweepResult shared = SharedSMASweep(columns, config)
+                             .runRange(params, 30, columns.size(), std::span(&curve, 1))
+                             .front();
+
+    VectorizedBacktest vectorized(config.portfolio, {.warmupBars = 30});
+    const VectorizedResult& expected = vectorized.run(columns);
+    ASSERT_EQ(curve.size(), expected.equityCurve.size());
+    for (size_t i = 0; i < curve.size(); ++i) {
+        EXPECT_EQ(curve[i].time, expected.equityCurve[i].time);
+        EXPECT_EQ(curve[i].equity, expected.equityCurve[i].equity);
+    }
+    EXPECT_EQ(shared.trades, expected.trades.size());
+    EXPECT_DOUBLE_EQ(shared.realizedPnL, expected.realizedPnL());
+
+    // A range must leave room for the longest window before it
+    EXPECT_THROW(SharedSMASweep(columns, config).runRange(params, 29, columns.size()),
+                 std::invalid_argument);
+}
+
+TEST_F(SweepRunTest, SharedSweepRejectsUnsupportedInput) {
+    BarColumns columns = BarColumns::fromData(data, "NQ");
+    std::vector<SMAParams> inverted = {{30, 10}};
+    EXPECT_THROW(SharedSMASweep(columns, config).run(inverted), std::invalid_argument);
+
+    config.portfolio.latency.delayNs = 1'000;
+    EXPECT_THROW(SharedSMASweep(columns, config), std::invalid_argument);
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+// Fixtures shared by the tests
+
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <string>
+
+// Minute bars from 2021-01-01 00:00 of a sine wave on the 0.25 tick grid, so SMAs cross several
+// times; bars before `first` are left out
+inline void writeSineCsv(const std::string& path, int bars, double phase = 0.0, int first = 0) {
+    std::ofstream file(path);
+    file << "timestamp,open,high,low,close,volume\n";
+    for (int i = first; i < bars; i++) {
+        double price = std::round((3700.0 + 50.0 * std::sin(i / 15.0 + phase)) * 4) / 4;
+        file << "2021-01-01 " << std::setfill('0') << std::setw(2) << i / 60 << ":"
+             << std::setw(2) << i % 60 << ":00," << price << "," << price + 1 << ","
+             << price - 1 << "," << price << ",1000\n";
+    }
+}
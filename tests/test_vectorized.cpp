@@ -0,0 +1,231 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <optional>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "../strategies/smacrossover.h"
+#include "backtest-cpp/data.h"
+#include "backtest-cpp/engine.h"
+#include "backtest-cpp/indicators.h"
+#include "backtest-cpp/performance.h"
+#include "backtest-cpp/portfolio.h"
+#include "backtest-cpp/vectorized.h"
+
+namespace {
+
+// Random walk on a quarter-point tick grid, like the bundled futures data
+std::vector<std::map<std::string, Bar>> makeTickBars(size_t count, uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::uniform_int_distribution<int> ticks(-6, 6);
+    double price = 3000.0;
+
+    std::vector<std::map<std::string, Bar>> bars;
+    for (size_t i = 0; i < count; ++i) {
+        double open = price;
+        price += 0.25 * ticks(rng);
+        Bar bar{.symbol = "NQ",
+                .time = 1'600'000'000 + static_cast<int64_t>(i) * 60,
+                .open = open,
+                .high = std::max(open, price) + 0.25,
+                .low = std::min(open, price) - 0.25,
+                .close = price,
+                .volume = 100};
+        bars.push_back({{"NQ", bar}});
+    }
+    return bars;
+}
+
+struct EngineRun {
+    std::vector<EquityPoint> equityCurve;
+    std::vector<Trade> trades;
+    size_t fills;
+};
+
+EngineRun runEngine(const DataHandler& data, const PortfolioConfig& config,
+                    const VectorizedConfig& strategyConfig) {
+    Portfolio portfolio(config);
+    SMACrossover strategy(strategyConfig.shortPeriod, strategyConfig.longPeriod);
+    BacktestEngine engine(data, strategy, portfolio,
+                          {.warmupBars = strategyConfig.warmupBars,
+                           .maxInvest = strategyConfig.maxInvest,
+                           .logOrders = false});
+    engine.run();
+    return {engine.getEquityCurve(), portfolio.getAllTrades(), portfolio.getAllOrders(0).size()};
+}
+
+void expectSameRun(const EngineRun& expected, const VectorizedResult& actual) {
+    ASSERT_EQ(actual.trades.size(), expected.trades.size());
+    for (size_t i = 0; i < expected.trades.size(); ++i) {
+        EXPECT_EQ(actual.trades[i].order.time, expected.trades[i].order.time) << "trade " << i;
+        EXPECT_EQ(actual.trades[i].quantity, expected.trades[i].quantity) << "trade " << i;
+        EXPECT_DOUBLE_EQ(actual.trades[i].pnl, expected.trades[i].pnl) << "trade " << i;
+        EXPECT_EQ(actual.trades[i].entryTime, expected.trades[i].entryTime) << "trade " << i;
+        EXPECT_DOUBLE_EQ(actual.trades[i].mae, expected.trades[i].mae) << "trade " << i;
+        EXPECT_DOUBLE_EQ(actual.trades[i].mfe, expected.trades[i].mfe) << "trade " << i;
+    }
+    EXPECT_EQ(actual.fills, expected.fills);
+
+    ASSERT_EQ(actual.equityCurve.size(), expected.equityCurve.size());
+    for (size_t i = 0; i < expected.equityCurve.size(); ++i) {
+        EXPECT_EQ(actual.equityCurve[i].time, expected.equityCurve[i].time) << "point " << i;
+        EXPECT_DOUBLE_EQ(actual.equityCurve[i].equity, expected.equityCurve[i].equity)
+            << "point " << i;
+    }
+}
+
+}  // namespace
+
+// ============================================================================
+// Column Kernels
+// ============================================================================
+
+TEST(VectorizedKernelTest, RollingMeanMatchesSMA) {
+    std::vector<std::map<std::string, Bar>> bars = makeTickBars(500, 5);
+    std::vector<double> closes;
+    for (const auto& bar : bars) closes.push_back(bar.at("NQ").close);
+
+    std::vector<double> prefix(closes.size() + 1);
+    std::vector<double> means(closes.size());
+    prefixSum(closes, prefix);
+    rollingMean(prefix, 20, means);
+
+    SMA sma(20);
+    for (size_t i = 0; i < closes.size(); ++i) {
+        EXPECT_EQ(means[i], sma.update(closes[i])) << i;  // Exact sums on a tick grid
+    }
+}
+
+TEST(VectorizedKernelTest, PrefixSumHandlesRaggedTail) {
+    std::vector<double> values = {1, 2, 3, 4, 5, 6, 7};
+    std::vector<double> prefix(values.size() + 1);
+    prefixSum(values, prefix);
+    EXPECT_EQ(prefix, (std::vector<double>{0, 1, 3, 6, 10, 15, 21, 28}));
+
+    std::vector<double> tooShort(values.size());
+    EXPECT_THROW(prefixSum(values, tooShort), std::invalid_argument);
+}
+
+TEST(VectorizedKernelTest, CrossoverSignalsMarkBothDirections) {
+    std::vector<double> fast = {1, 3, 3, 1, 2, 2};
+    std::vector<double> slow = {2, 2, 2, 2, 2, 1};
+    std::vector<int8_t> signals(fast.size());
+    crossoverSignals(fast, slow, signals);
+    // Equal is not above, as in SMACrossover
+    EXPECT_EQ(signals, (std::vector<int8_t>{0, 1, 0, -1, 0, 1}));
+}
+
+// ============================================================================
+// Differential Tests Against the Event-Driven Engine
+// ============================================================================
+
+// Adds, partial closes, full closes and reversals both ways, fill by fill
+TEST(SimulatedPositionTest, BooksFillsLikePortfolio) {
+    PortfolioConfig config{.initialCash = 100'000.0, .commission = 2.7, .logTrades = false};
+    Portfolio portfolio(config);
+    SimulatedPosition position(config);
+    const std::vector<std::pair<int, double>> fills = {
+        {10, 100.0}, {-4, 105.0}, {6, 98.0},  {-20, 110.0}, {5, 107.0},
+        {-3, 104.0}, {12, 101.0}, {-2, 99.0}, {-4, 103.0},  {-1, 100.0}};
+
+    for (int64_t time = 0; const auto& [quantity, price] : fills) {
+        // A bar around the fill price before each fill widens the open position's range
+        portfolio.markToMarket(
+            {{"NQ", Bar{.symbol = "NQ", .time = ++time, .high = price + 2, .low = price - 3}}});
+        position.mark(price - 3, price + 2);
+
+        size_t trades = portfolio.getTrades().size();
+        portfolio.executeOrder(Order{.time = time,
+                                     .symbol = "NQ",
+                                     .direction = quantity > 0 ? SignalType::BUY : SignalType::SELL,
+                                     .price = price,
+                                     .type = OrderType::MARKET,
+                                     .quantity = quantity},
+                               true);
+        std::optional<SimulatedPosition::Closed> closed = position.fill(quantity, price, time);
+
+        ASSERT_EQ(closed.has_value(), portfolio.getTrades().size() > trades);
+        if (closed) {
+            const Trade& trade = portfolio.getTrades().back();
+            EXPECT_EQ(closed->quantity, trade.quantity);
+            EXPECT_EQ(closed->pnl, trade.pnl);
+            EXPECT_EQ(closed->entryTime, trade.entryTime);
+            EXPECT_EQ(closed->mae, trade.mae);
+            EXPECT_EQ(closed->mfe, trade.mfe);
+        }
+        auto held = portfolio.getCurrentPositions().find("NQ");
+        EXPECT_EQ(position.quantity(),
+                  held == portfolio.getCurrentPositions().end() ? 0 : held->second.quantity);
+        EXPECT_EQ(position.cash(), portfolio.getAvailableCash());
+    }
+}
+
+TEST(VectorizedBacktestTest, MatchesEngineOnBundledData) {
+    DataHandler data;
+    data.loadCSV("../data/Mini.csv", "NQ");
+    ASSERT_GT(data.size(), 0);
+
+    // Same setup as main.cpp
+    PortfolioConfig config{.initialCash = 100'000.0, .commission = 2.7, .leverage = 1.0};
+    VectorizedConfig strategyConfig{
+        .shortPeriod = 10, .longPeriod = 30, .warmupBars = 30, .maxInvest = 10'000};
+    EngineRun expected = runEngine(data, config, strategyConfig);
+
+    VectorizedBacktest backtest(config, strategyConfig);
+    const VectorizedResult& actual = backtest.run(BarColumns::fromData(data, "NQ"));
+
+    expectSameRun(expected, actual);
+    EXPECT_EQ(actual.trades.size(), 27);
+    EXPECT_NEAR(actual.realizedPnL(), 81.6, 1e-9);
+    EXPECT_DOUBLE_EQ(Performance::sharpeRatio(actual.equityCurve, Frequency::MINUTE),
+                     Performance::sharpeRatio(expected.equityCurve, Frequency::MINUTE));
+}
+
+TEST(VectorizedBacktestTest, MatchesEngineWithRejectedOrders) {
+    DataHandler data;
+    std::vector<std::map<std::string, Bar>> bars = makeTickBars(5'000, 9);
+    data.synchronize(bars);
+
+    // Little cash and a position limit, so some reversals are rejected and later signals
+    // add to or reduce the position that is left
+    PortfolioConfig config{.initialCash = 12'000.0,
+                           .commission = 1.5,
+                           .leverage = 1.0,
+                           .maxPositionSize = 4};
+    VectorizedConfig strategyConfig{
+        .shortPeriod = 5, .longPeriod = 20, .warmupBars = 40, .maxInvest = 14'000};
+    EngineRun expected = runEngine(data, config, strategyConfig);
+
+    VectorizedBacktest backtest(config, strategyConfig);
+    const VectorizedResult& actual = backtest.run(BarColumns::fromData(data, "NQ"));
+
+    expectSameRun(expected, actual);
+    EXPECT_GT(actual.trades.size(), 0);
+}
+
+TEST(VectorizedBacktestTest, RepeatedRunsGiveSameResult) {
+    std::vector<std::map<std::string, Bar>> bars = makeTickBars(2'000, 3);
+    DataHandler data;
+    data.synchronize(bars);
+    BarColumns columns = BarColumns::fromData(data, "NQ");
+
+    VectorizedBacktest backtest({.initialCash = 100'000.0, .commission = 2.7});
+    std::vector<EquityPoint> first = backtest.run(columns).equityCurve;
+    const VectorizedResult& second = backtest.run(columns);
+
+    ASSERT_EQ(second.equityCurve.size(), first.size());
+    EXPECT_EQ(second.equityCurve.back().equity, first.back().equity);
+}
+
+TEST(VectorizedBacktestTest, RejectsUnsupportedConfigs) {
+    PortfolioConfig config{.initialCash = 100'000.0, .commission = 2.7};
+    EXPECT_THROW(VectorizedBacktest(config, {.shortPeriod = 30, .longPeriod = 10}),
+                 std::invalid_argument);
+    EXPECT_THROW(VectorizedBacktest(config, {.longPeriod = 30, .warmupBars = 10}),
+                 std::invalid_argument);
+
+    config.latency.delayNs = 1'000;
+    EXPECT_THROW(VectorizedBacktest{config}, std::invalid_argument);
+}
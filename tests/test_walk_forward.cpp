@@ -0,0 +1,139 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+#include "backtest-cpp/sweep.h"
+#include "backtest-cpp/vectorized.h"
+#include "backtest-cpp/walk_forward.h"
+
+// ============================================================================
+// Windows
+// ============================================================================
+
+TEST(WalkForwardWindowsTest, RollingWindowsTileTheOutOfSampleData) {
+    std::vector<WalkForwardWindow> windows =
+        walkForwardWindows(1'000, 50, {.inSampleBars = 300, .outOfSampleBars = 100});
+
+    ASSERT_EQ(windows.size(), 7);
+    for (size_t i = 0; i < windows.size(); ++i) {
+        EXPECT_EQ(windows[i].inSampleBegin, 50 + 100 * i);
+        EXPECT_EQ(windows[i].inSampleEnd, windows[i].inSampleBegin + 300);
+        if (i > 0) {
+            EXPECT_EQ(windows[i].inSampleEnd, windows[i - 1].outOfSampleEnd);
+        }
+    }
+    EXPECT_EQ(windows.back().outOfSampleEnd, 1'000);  // Cut at the end of the data
+}
+
+TEST(WalkForwardWindowsTest, AnchoredWindowsGrowFromTheFirstBar) {
+    std::vector<WalkForwardWindow> windows = walkForwardWindows(
+        1'000, 50, {.inSampleBars = 300, .outOfSampleBars = 100, .mode = WindowMode::ANCHORED});
+
+    ASSERT_EQ(windows.size(), 7);
+    for (size_t i = 0; i < windows.size(); ++i) {
+        EXPECT_EQ(windows[i].inSampleBegin, 50);
+        EXPECT_EQ(windows[i].inSampleEnd, 350 + 100 * i);
+    }
+    EXPECT_THROW(walkForwardWindows(1'000, 50, {.inSampleBars = 300, .outOfSampleBars = 0}),
+                 std::invalid_argument);
+}
+
+// ============================================================================
+// Walk-forward runs
+// ============================================================================
+
+class WalkForwardTest : public ::testing::Test {
+   protected:
+    BarColumns bars{.symbol = "NQ"};
+    SweepConfig config{.portfolio = {.initialCash = 100'000.0, .commission = 2.7},
+                       .engine = {.warmupBars = 30, .maxInvest = 10'000},
+                       .threads = 2};
+    WalkForwardConfig windows{.inSampleBars = 600, .outOfSampleBars = 200};
+    std::vector<SMAParams> params = gridSearch({2, 20, 3}, {10, 60, 10});
+
+    void SetUp() override {
+        // On the 0.25 tick grid, with regimes that favour different periods
+        for (int i = 0; i < 2'500; ++i) {
+            double price = 3700.0 + 40.0 * std::sin(i / 13.0) + 15.0 * std::sin(i / 3.1) +
+                           25.0 * std::sin(i / 170.0);
+            price = std::round(price * 4.0) / 4.0;
+            bars.time.push_back(1'600'000'000 + i * 60);
+            bars.open.push_back(price);
+            bars.high.push_back(price + 1);
+            bars.low.push_back(price - 1);
+            bars.close.push_back(price);
+            bars.volume.push_back(1'000);
+        }
+    }
+};
+
+TEST_F(WalkForwardTest, EachFoldTradesItsInSampleWinner) {
+    WalkForwardResult result = WalkForward(bars, config, windows).run(params);
+    SharedSMASweep sweep(bars, config);
+
+    ASSERT_EQ(result.folds.size(), walkForwardWindows(bars.size(), 60, windows).size());
+    for (const WalkForwardFold& fold : result.folds) {
+        std::vector<SweepResult> inSample =
+            sweep.runRange(params, fold.window.inSampleBegin, fold.window.inSampleEnd);
+        for (const SweepResult& candidate : inSample) {
+            EXPECT_LE(candidate.sharpe, fold.inSample.sharpe);
+        }
+
+        SMAParams best[] = {fold.inSample.params};
+        SweepResult outOfSample =
+            sweep.runRange(best, fold.window.inSampleEnd, fold.window.outOfSampleEnd).front();
+        EXPECT_EQ(fold.outOfSample.trades, outOfSample.trades);
+        EXPECT_DOUBLE_EQ(fold.outOfSample.realizedPnL, outOfSample.realizedPnL);
+        EXPECT_DOUBLE_EQ(fold.outOfSample.sharpe, outOfSample.sharpe);
+    }
+}
+
+TEST_F(WalkForwardTest, StitchedCurveCompoundsTheFolds) {
+    WalkForwardResult result = WalkForward(bars, config, windows).run(params);
+    SharedSMASweep sweep(bars, config);
+
+    size_t offset = 0;
+    double reached = config.portfolio.initialCash;
+    for (const WalkForwardFold& fold : result.folds) {
+        SMAParams best[] = {fold.inSample.params};
+        std::vector<EquityPoint> curve;
+        sweep.runRange(best, fold.window.inSampleEnd, fold.window.outOfSampleEnd,
+                       std::span(&curve, 1));
+
+        // One point per out-of-sample bar plus the closing point, scaled to the equity so far
+        ASSERT_EQ(curve.size(), fold.window.outOfSampleEnd - fold.window.inSampleEnd + 1);
+        ASSERT_LE(offset + curve.size(), result.equityCurve.size());
+        double scale = reached / config.portfolio.initialCash;
+        for (size_t i = 0; i < curve.size(); ++i) {
+            EXPECT_EQ(result.equityCurve[offset + i].time, curve[i].time);
+            EXPECT_DOUBLE_EQ(result.equityCurve[offset + i].equity, curve[i].equity * scale);
+        }
+        offset += curve.size();
+        reached = result.equityCurve[offset - 1].equity;
+    }
+    EXPECT_EQ(offset, result.equityCurve.size());
+    EXPECT_GT(Performance::annualizedVolatility(result.equityCurve, Frequency::MINUTE), 0.0);
+}
+
+TEST_F(WalkForwardTest, ResultsDoNotDependOnThreadCount) {
+    config.threads = 1;
+    WalkForwardResult serial = WalkForward(bars, config, windows).run(params);
+    config.threads = 4;
+    windows.mode = WindowMode::ANCHORED;
+    WalkForwardResult anchored = WalkForward(bars, config, windows).run(params);
+    windows.mode = WindowMode::ROLLING;
+    WalkForwardResult parallel = WalkForward(bars, config, windows).run(params);
+
+    ASSERT_EQ(parallel.folds.size(), serial.folds.size());
+    ASSERT_EQ(anchored.folds.size(), serial.folds.size());
+    for (size_t i = 0; i < serial.folds.size(); ++i) {
+        EXPECT_EQ(parallel.folds[i].inSample.params.shortPeriod,
+                  serial.folds[i].inSample.params.shortPeriod);
+        EXPECT_EQ(parallel.folds[i].inSample.params.longPeriod,
+                  serial.folds[i].inSample.params.longPeriod);
+        EXPECT_EQ(parallel.folds[i].outOfSample.sharpe, serial.folds[i].outOfSample.sharpe);
+    }
+    ASSERT_EQ(parallel.equityCurve.size(), serial.equityCurve.size());
+    EXPECT_EQ(parallel.equityCurve.back().equity, serial.equityCurve.back().equity);
+}